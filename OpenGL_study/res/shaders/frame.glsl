@@ -0,0 +1,9 @@
+/**
+ * 逐帧数据，std140 布局与 UniformBlocks.h 中的 FrameUniforms 一致，绑定点由 UniformBlocks 在链接后指定
+ */
+layout(std140) uniform FrameBlock {
+    mat4    u_Proj;
+    mat4    u_View;
+    vec3    u_ViewPos;
+    float   u_Time;
+};
@@ -0,0 +1,14 @@
+/**
+ * 逐实例属性，位置与 InstanceBuffer.h 中的 INSTANCE_ATTRIBUTE_LOCATION 一致
+ * 定义 INSTANCED 时模型矩阵与颜色取自实例流，否则模型矩阵取 u_Model、颜色为白色
+ */
+#ifdef INSTANCED
+layout(location = 8)  in mat4 a_InstanceModel;
+layout(location = 12) in vec4 a_InstanceColor;
+#define MODEL_MATRIX    a_InstanceModel
+#define INSTANCE_COLOR  a_InstanceColor
+#else
+uniform mat4 u_Model;
+#define MODEL_MATRIX    u_Model
+#define INSTANCE_COLOR  vec4(1.0)
+#endif
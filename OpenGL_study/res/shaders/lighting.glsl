@@ -0,0 +1,59 @@
+/**
+ * 光源结构体与光照块，std140 布局与 UniformBlocks.h 中的 LightingUniforms 一致
+ */
+
+/**
+ * 方向光结构体
+ */
+struct DirLight {
+    vec3    direction;
+
+    // --- 基本参数 --- //
+    vec3    ambient;    // 环境光
+    vec3    diffuse;    // 漫反射光
+    vec3    specular;   // 镜面光
+};
+
+/**
+ * 点光源结构体
+ */
+struct PointLight {
+    vec3    position;
+
+    // --- 基本参数 --- //
+    vec3    ambient;    // 环境光
+    vec3    diffuse;    // 漫反射光
+    vec3    specular;   // 镜面光
+
+    // --- 点光源参数 --- 参考 https://learnopengl-cn.github.io/02%20Lighting/05%20Light%20casters/ //
+    float   constant;   // 常量
+    float   linear;     // 一次项
+    float   quadratic;  // 二次项
+};
+
+/**
+ * 聚光结构体
+ */
+struct SpotLight {
+    vec3    position;
+    vec3    direction;
+
+    // --- 基本参数 --- //
+    vec3    ambient;    // 环境光
+    vec3    diffuse;    // 漫反射光
+    vec3    specular;   // 镜面光
+
+    // --- 聚光灯参数 --- //
+    float   cut_off;
+    float   outer_cut_off;
+};
+
+// 块内点光源数组的容量，与 MAX_POINT_LIGHTS 一致，实际使用数量由 NR_POINT_LIGHTS 决定
+#define MAX_POINT_LIGHTS 8
+
+layout(std140) uniform LightingBlock {
+    DirLight    u_DirLight;
+    SpotLight   u_SpotLight;
+    PointLight  u_PointLights[MAX_POINT_LIGHTS];
+    float       u_DistanceRate;
+};
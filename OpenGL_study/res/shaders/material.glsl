@@ -0,0 +1,8 @@
+/**
+ * 材质结构体，供各光照着色器 #include
+ */
+struct Material {
+    sampler2D   diffuse;    // 漫反射贴图，同时用作环境光颜色
+    sampler2D   specular;   // 镜面光贴图
+    float       shininess;  // 反光度
+};
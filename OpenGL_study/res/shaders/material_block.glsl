@@ -0,0 +1,6 @@
+/**
+ * 材质标量参数，std140 布局与 UniformBlocks.h 中的 MaterialUniforms 一致
+ */
+layout(std140) uniform MaterialBlock {
+    float   u_Shininess;    // 反光度
+};
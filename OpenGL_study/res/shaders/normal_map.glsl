@@ -0,0 +1,8 @@
+/**
+ * 采样切线空间法线贴图，只使用 x、y 并重建 z，BC5 与未压缩的法线贴图结果一致
+ */
+vec3 sample_normal_map(sampler2D normal_map, vec2 tex_coords)
+{
+    vec2 xy = texture(normal_map, tex_coords).rg * 2.0 - 1.0;
+    return vec3(xy, sqrt(max(0.0, 1.0 - dot(xy, xy))));
+}
@@ -46,8 +46,8 @@ int main()
     shader.set_mat4f("u_MVP", mvp);
     //shader.set_uniform4f("u_Color", 1.0f, 0.0f, 0.0f, 1.0f);
     
-    Texture texture("res/textures/hello.png");
-    texture.bind();
+    auto texture = TextureCache::get("res/textures/hello.png");
+    texture->bind();
 
     // set texture
     shader.set_int("m_Texture", 0);
@@ -0,0 +1,387 @@
+#include "AssetPack.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace
+{
+    uint64_t align_up(const uint64_t value, const uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void write_padding(std::ofstream& stream, const uint64_t from, const uint64_t to)
+    {
+        static const char zeros[ASSET_PACK_ALIGNMENT] = {};
+        if (to > from)
+            stream.write(zeros, static_cast<std::streamsize>(to - from));
+    }
+
+    // 文件修改时间（秒），文件不存在时返回 0
+    uint64_t get_modified_time(const std::string& path)
+    {
+#ifdef _WIN32
+        struct _stat64 file_stat {};
+        if (_stat64(path.c_str(), &file_stat) != 0)
+            return 0;
+#else
+        struct stat file_stat {};
+        if (stat(path.c_str(), &file_stat) != 0)
+            return 0;
+#endif
+        return static_cast<uint64_t>(file_stat.st_mtime);
+    }
+
+    // [offset, offset + length) 是否落在 [0, size) 内，不会溢出
+    bool is_range_valid(const uint64_t offset, const uint64_t length, const uint64_t size)
+    {
+        return offset <= size && length <= size - offset;
+    }
+
+    int compare_path(const char *a, const size_t a_length, const std::string& b)
+    {
+        const auto result = std::memcmp(a, b.data(), std::min(a_length, b.size()));
+        if (result != 0)
+            return result;
+        return a_length < b.size() ? -1 : a_length > b.size() ? 1 : 0;
+    }
+
+    // 显式挂载过之后不再尝试默认包
+    bool mount_requested = false;
+}
+
+AssetPack::AssetPack()
+    : mapped_file_(nullptr), header_(nullptr), entries_(nullptr), strings_(nullptr)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    close();
+}
+
+bool AssetPack::open(const std::string& pack_path)
+{
+    close();
+
+    mapped_file_ = new MappedFile(pack_path);
+    if (!mapped_file_->is_valid() || mapped_file_->get_size() < sizeof(AssetPackHeader))
+    {
+        close();
+        return false;
+    }
+
+    const auto data = mapped_file_->get_data();
+    const auto size = static_cast<uint64_t>(mapped_file_->get_size());
+    const auto header = reinterpret_cast<const AssetPackHeader*>(data);
+    if (std::memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(ASSET_PACK_MAGIC)) != 0
+        || header->version != ASSET_PACK_VERSION
+        || !is_range_valid(header->index_offset, static_cast<uint64_t>(header->entry_count) * sizeof(AssetPackEntry), size)
+        || !is_range_valid(header->strings_offset, header->strings_size, size))
+    {
+        std::cout << "[ERROR] AssetPack: invalid pack " << pack_path << std::endl;
+        close();
+        return false;
+    }
+
+    const auto entries = reinterpret_cast<const AssetPackEntry*>(data + header->index_offset);
+    for (uint32_t i = 0; i < header->entry_count; i++)
+    {
+        const auto& entry = entries[i];
+        // 未压缩条目按 size 返回视图，两个大小必须一致
+        if (!is_range_valid(entry.path_offset, entry.path_length, header->strings_size)
+            || !is_range_valid(entry.data_offset, entry.stored_size, size)
+            || (!(entry.flags & ASSET_PACK_ENTRY_LZ4) && entry.size != entry.stored_size))
+        {
+            std::cout << "[ERROR] AssetPack: corrupted entry in " << pack_path << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    header_  = header;
+    entries_ = entries;
+    strings_ = reinterpret_cast<const char*>(data + header->strings_offset);
+    return true;
+}
+
+void AssetPack::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decompressed_.clear();
+    }
+
+    delete mapped_file_;
+    mapped_file_ = nullptr;
+    header_  = nullptr;
+    entries_ = nullptr;
+    strings_ = nullptr;
+}
+
+std::string AssetPack::get_entry_path(const size_t index) const
+{
+    if (index >= get_entry_count())
+        return std::string();
+    return std::string(strings_ + entries_[index].path_offset, entries_[index].path_length);
+}
+
+AssetView AssetPack::find(const std::string& path)
+{
+    AssetView view;
+    const auto index = find_index(normalize_path(path));
+    if (index < 0)
+        return view;
+
+    const auto& entry = entries_[index];
+    const auto data = mapped_file_->get_data() + entry.data_offset;
+    if (!(entry.flags & ASSET_PACK_ENTRY_LZ4))
+    {
+        view.data = data;
+        view.size = static_cast<size_t>(entry.size);
+        return view;
+    }
+
+    // 解压结果常驻，返回的视图在关闭前一直有效
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = decompressed_.find(static_cast<size_t>(index));
+    if (it != decompressed_.end())
+    {
+        view.data = it->second.data();
+        view.size = it->second.size();
+        return view;
+    }
+
+    std::vector<unsigned char> buffer(static_cast<size_t>(entry.size));
+    if (!lz4_decompress(data, static_cast<size_t>(entry.stored_size), buffer.data(), buffer.size()))
+    {
+        std::cout << "[ERROR] AssetPack: failed to decompress " << path << std::endl;
+        return view;
+    }
+
+    auto& stored = decompressed_[static_cast<size_t>(index)];
+    stored = std::move(buffer);
+    view.data = stored.data();
+    view.size = stored.size();
+    return view;
+}
+
+bool AssetPack::contains(const std::string& path) const
+{
+    return find_index(normalize_path(path)) >= 0;
+}
+
+bool AssetPack::mount(const std::string& pack_path)
+{
+    mount_requested = true;
+    auto& pack = get_mounted();
+    if (!pack.open(pack_path))
+        return false;
+
+    pack.report_mounted(pack_path);
+    return true;
+}
+
+void AssetPack::unmount()
+{
+    mount_requested = true;
+    get_mounted().close();
+}
+
+AssetView AssetPack::read(const std::string& path)
+{
+    auto& pack = get_mounted();
+    if (!pack.is_open())
+        return AssetView();
+    return pack.find(path);
+}
+
+bool AssetPack::exists(const std::string& path)
+{
+    const auto& pack = get_mounted();
+    return pack.is_open() && pack.contains(path);
+}
+
+std::string AssetPack::normalize_path(const std::string& path)
+{
+    const auto is_absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+
+    std::vector<std::string> segments;
+    std::string segment;
+    for (size_t i = 0; i <= path.size(); i++)
+    {
+        const auto c = i < path.size() ? path[i] : '/';
+        if (c != '/' && c != '\\')
+        {
+            segment += c;
+            continue;
+        }
+
+        if (segment == "..")
+        {
+            if (!segments.empty() && segments.back() != "..")
+                segments.pop_back();
+            else if (!is_absolute)
+                segments.push_back(segment);
+        }
+        else if (!segment.empty() && segment != ".")
+        {
+            segments.push_back(segment);
+        }
+
+        segment.clear();
+    }
+
+    std::string result = is_absolute ? "/" : "";
+    for (size_t i = 0, count = segments.size(); i < count; i++)
+    {
+        if (i > 0)
+            result += '/';
+        result += segments[i];
+    }
+    return result;
+}
+
+bool AssetPack::build(const std::string& pack_path, const std::vector<std::string>& paths, const bool compress)
+{
+    std::vector<std::string> sorted_paths;
+    for (const auto& path : paths)
+        sorted_paths.push_back(normalize_path(path));
+    std::sort(sorted_paths.begin(), sorted_paths.end());
+    sorted_paths.erase(std::unique(sorted_paths.begin(), sorted_paths.end()), sorted_paths.end());
+
+    std::ofstream stream(pack_path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        std::cout << "[ERROR] AssetPack: failed to create " << pack_path << std::endl;
+        return false;
+    }
+
+    // 文件头占第一页，最后回填
+    AssetPackHeader header {};
+    std::memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(ASSET_PACK_MAGIC));
+    header.version = ASSET_PACK_VERSION;
+    header.entry_count = static_cast<uint32_t>(sorted_paths.size());
+    write_padding(stream, 0, ASSET_PACK_ALIGNMENT);
+    uint64_t offset = ASSET_PACK_ALIGNMENT;
+
+    std::vector<AssetPackEntry> entries;
+    std::string strings;
+    std::vector<unsigned char> compressed;
+    for (const auto& path : sorted_paths)
+    {
+        std::ifstream input(path, std::ios::binary);
+        if (!input)
+        {
+            std::cout << "[ERROR] AssetPack: failed to read " << path << std::endl;
+            return false;
+        }
+        const std::vector<unsigned char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+        AssetPackEntry entry {};
+        entry.path_offset = strings.size();
+        entry.path_length = static_cast<uint32_t>(path.size());
+        entry.data_offset = offset;
+        entry.size = data.size();
+        entry.modified_time = get_modified_time(path);
+        strings += path;
+
+        const unsigned char *stored = data.data();
+        size_t stored_size = data.size();
+        if (compress && !data.empty())
+        {
+            compressed.resize(lz4_compress_bound(data.size()));
+            const auto compressed_size = lz4_compress(data.data(), data.size(), compressed.data(), compressed.size());
+            if (compressed_size > 0 && compressed_size <= data.size() - data.size() / 8)
+            {
+                stored = compressed.data();
+                stored_size = compressed_size;
+                entry.flags |= ASSET_PACK_ENTRY_LZ4;
+            }
+        }
+        entry.stored_size = stored_size;
+        entries.push_back(entry);
+
+        stream.write(reinterpret_cast<const char*>(stored), static_cast<std::streamsize>(stored_size));
+        const auto next = align_up(offset + stored_size, ASSET_PACK_ALIGNMENT);
+        write_padding(stream, offset + stored_size, next);
+        offset = next;
+    }
+
+    header.index_offset = offset;
+    stream.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(AssetPackEntry)));
+    offset += entries.size() * sizeof(AssetPackEntry);
+
+    header.strings_offset = offset;
+    header.strings_size = strings.size();
+    stream.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(stream);
+}
+
+AssetPack& AssetPack::get_mounted()
+{
+    // 泄漏单例，保证静态析构阶段仍可安全访问
+    // 默认包只在第一次访问时尝试打开，工作线程可能同时访问
+    static auto *instance = new AssetPack();
+    static std::once_flag default_flag;
+    std::call_once(default_flag, []()
+    {
+        if (!mount_requested && instance->open(ASSET_PACK_DEFAULT_PATH))
+            instance->report_mounted(ASSET_PACK_DEFAULT_PATH);
+    });
+    return *instance;
+}
+
+long long AssetPack::find_index(const std::string& path) const
+{
+    if (!is_open())
+        return -1;
+
+    long long low = 0, high = static_cast<long long>(header_->entry_count) - 1;
+    while (low <= high)
+    {
+        const auto middle = low + (high - low) / 2;
+        const auto& entry = entries_[middle];
+        const auto result = compare_path(strings_ + entry.path_offset, entry.path_length, path);
+        if (result == 0)
+            return middle;
+        if (result < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    return -1;
+}
+
+void AssetPack::report_mounted(const std::string& pack_path) const
+{
+    std::cout << "[INFO] AssetPack: mounted " << pack_path << " (" << get_entry_count() << " entries)" << std::endl;
+
+    // 磁盘上较新的文件不会被读取，修改资源后需重新打包
+    size_t stale_count = 0;
+    std::string first_stale;
+    for (size_t i = 0, count = get_entry_count(); i < count; i++)
+    {
+        const auto modified_time = get_modified_time(get_entry_path(i));
+        if (entries_[i].modified_time == 0 || modified_time <= entries_[i].modified_time)
+            continue;
+
+        if (stale_count++ == 0)
+            first_stale = get_entry_path(i);
+    }
+
+    if (stale_count > 0)
+    {
+        std::cout << "[WARNING] AssetPack: " << stale_count << " files on disk are newer than in " << pack_path
+                  << " (e.g. " << first_stale << "), the packed versions are used; rerun asset_packer" << std::endl;
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+
+const char         ASSET_PACK_MAGIC[8]   = { 'M', 'O', 'S', 'P', 'A', 'C', 'K', '\0' };
+const unsigned int ASSET_PACK_VERSION    = 2;
+const uint64_t     ASSET_PACK_ALIGNMENT  = 4096;        // 条目数据按页对齐，映射后可直接交给解码器
+const char         ASSET_PACK_DEFAULT_PATH[] = "res.pack";
+
+enum AssetPackEntryFlags
+{
+    ASSET_PACK_ENTRY_LZ4 = 1 << 0,      // 数据以 LZ4 块压缩存放
+};
+
+/**
+ * 资源包文件头
+ */
+struct AssetPackHeader
+{
+    char          magic[8];         // 文件标识 "MOSPACK"
+    uint32_t      version;
+    uint32_t      entry_count;
+    uint64_t      index_offset;     // 条目表偏移，条目按路径升序排列
+    uint64_t      strings_offset;   // 路径字符串区偏移
+    uint64_t      strings_size;
+};
+
+/**
+ * 资源包条目，偏移均相对于文件起始位置
+ */
+struct AssetPackEntry
+{
+    uint64_t      path_offset;      // 相对字符串区
+    uint32_t      path_length;
+    uint32_t      flags;            // AssetPackEntryFlags
+    uint64_t      data_offset;
+    uint64_t      stored_size;      // 包内大小
+    uint64_t      size;             // 解压后大小
+    uint64_t      modified_time;    // 打包时源文件的修改时间（秒），0 表示未知
+};
+
+/**
+ * 资源数据的只读视图，未压缩条目直接指向映射内存，在资源包关闭前有效
+ */
+struct AssetView
+{
+    const unsigned char *data = nullptr;
+    size_t               size = 0;
+
+    inline bool is_valid() const { return data != nullptr; }
+};
+
+/**
+ * 内存映射的只读资源包
+ *
+ * 整个包只映射一次，按规范化路径二分查找条目；压缩条目在第一次读取时解压并保留到关闭。
+ * 进程内默认挂载工作目录下的 res.pack（不存在时所有读取回退到文件系统），
+ * 挂载与卸载须在加载资源之前、单线程中进行
+ */
+class AssetPack
+{
+private:
+    MappedFile            *mapped_file_;
+    const AssetPackHeader *header_;
+    const AssetPackEntry  *entries_;
+    const char            *strings_;
+
+    std::unordered_map<size_t, std::vector<unsigned char>> decompressed_;
+    std::mutex mutex_;
+
+public:
+    AssetPack();
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& pack_path);
+    void close();
+
+    inline bool is_open() const { return mapped_file_ != nullptr; }
+    inline size_t get_entry_count() const { return header_ ? header_->entry_count : 0; }
+    std::string get_entry_path(size_t index) const;
+
+    // 查找条目，不存在时返回无效视图
+    AssetView find(const std::string& path);
+    bool contains(const std::string& path) const;
+
+    // 已挂载的资源包
+    static bool mount(const std::string& pack_path);
+    static void unmount();
+    static AssetView read(const std::string& path);
+    static bool exists(const std::string& path);
+
+    // 统一分隔符并折叠 "." 与 ".." 路径段
+    static std::string normalize_path(const std::string& path);
+
+    // 打包文件，paths 既是读取路径也是包内路径；compress 为真时仅保留能省下 1/8 以上的压缩结果
+    static bool build(const std::string& pack_path, const std::vector<std::string>& paths, bool compress);
+
+private:
+    static AssetPack& get_mounted();
+    // 二分查找，返回条目下标，未找到时返回 -1
+    long long find_index(const std::string& path) const;
+    // 挂载后输出条目数，并提示比磁盘文件旧的条目（包内条目优先于磁盘文件）
+    void report_mounted(const std::string& pack_path) const;
+};
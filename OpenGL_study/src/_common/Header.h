@@ -9,6 +9,7 @@
 #include "Shader.h"
 #include "Texture.h"
 #include "CubeTexture.h"
+#include "TextureCache.h"
 #include "VertexArray.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
@@ -17,8 +18,19 @@
 #include "Geometry.h"
 #include "Mesh.h"
 #include "Model.h"
+#include "VertexPacking.h"
 #include "FrameBuffer.h"
 #include "UniformBuffer.h"
+#include "BufferHeap.h"
+#include "ProgramCache.h"
+#include "ShaderLibrary.h"
+#include "RenderQueue.h"
+#include "InstanceBuffer.h"
+#include "DrawBatch.h"
+#include "StreamBuffer.h"
+#include "UniformBlocks.h"
+#include "GLState.h"
+#include "PipelineState.h"
 
 #include "MOS_glm.h"
 #include "MOS_stb_image.h"
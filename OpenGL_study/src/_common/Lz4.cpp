@@ -0,0 +1,185 @@
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const size_t LZ4_MIN_MATCH     = 4;
+    const size_t LZ4_LAST_LITERALS = 5;     // 最后 5 个字节必须是字面量
+    const size_t LZ4_MATCH_LIMIT   = 12;    // 最后一个匹配须在结尾 12 字节之前开始
+    const size_t LZ4_MAX_OFFSET    = 65535;
+    const unsigned int LZ4_HASH_BITS = 12;
+
+    uint32_t read_u32(const unsigned char *data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint32_t hash(const uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+    }
+
+    // 写入长度的扩展字节，返回 false 表示空间不足
+    bool write_length(unsigned char *&output, const unsigned char *end, size_t length)
+    {
+        while (length >= 255)
+        {
+            if (output >= end)
+                return false;
+            *output++ = 255;
+            length -= 255;
+        }
+        if (output >= end)
+            return false;
+        *output++ = static_cast<unsigned char>(length);
+        return true;
+    }
+
+    bool write_sequence(unsigned char *&output, const unsigned char *end,
+                        const unsigned char *literals, const size_t literal_length,
+                        const size_t offset, const size_t match_length)
+    {
+        if (output >= end)
+            return false;
+
+        auto& token = *output++;
+        token = static_cast<unsigned char>((literal_length >= 15 ? 15 : literal_length) << 4);
+        if (literal_length >= 15 && !write_length(output, end, literal_length - 15))
+            return false;
+
+        if (static_cast<size_t>(end - output) < literal_length)
+            return false;
+        std::memcpy(output, literals, literal_length);
+        output += literal_length;
+
+        // 最后一个序列只有字面量
+        if (match_length == 0)
+            return true;
+
+        if (end - output < 2)
+            return false;
+        *output++ = static_cast<unsigned char>(offset & 0xFF);
+        *output++ = static_cast<unsigned char>(offset >> 8);
+
+        const auto length = match_length - LZ4_MIN_MATCH;
+        token |= static_cast<unsigned char>(length >= 15 ? 15 : length);
+        return length < 15 || write_length(output, end, length - 15);
+    }
+}
+
+size_t lz4_compress_bound(const size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t lz4_compress(const unsigned char *source, const size_t size, unsigned char *target, const size_t capacity)
+{
+    auto output = target;
+    const auto end = target + capacity;
+
+    // 表中存放位置 + 1，0 表示空
+    std::vector<uint32_t> table(1u << LZ4_HASH_BITS, 0);
+
+    size_t anchor = 0;
+    if (size > LZ4_MATCH_LIMIT)
+    {
+        const auto match_limit = size - LZ4_MATCH_LIMIT;
+        size_t position = 0;
+        while (position < match_limit)
+        {
+            const auto sequence = read_u32(source + position);
+            auto& slot = table[hash(sequence)];
+            const auto candidate = static_cast<size_t>(slot);
+            slot = static_cast<uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > LZ4_MAX_OFFSET || read_u32(source + candidate - 1) != sequence)
+            {
+                position++;
+                continue;
+            }
+
+            const auto reference = candidate - 1;
+            auto length = LZ4_MIN_MATCH;
+            while (position + length < size - LZ4_LAST_LITERALS && source[reference + length] == source[position + length])
+                length++;
+
+            if (!write_sequence(output, end, source + anchor, position - anchor, position - reference, length))
+                return 0;
+
+            position += length;
+            anchor = position;
+        }
+    }
+
+    if (!write_sequence(output, end, source + anchor, size - anchor, 0, 0))
+        return 0;
+    return static_cast<size_t>(output - target);
+}
+
+bool lz4_decompress(const unsigned char *source, const size_t size, unsigned char *target, const size_t target_size)
+{
+    size_t input = 0, output = 0;
+    while (input < size)
+    {
+        const auto token = source[input++];
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15)
+        {
+            unsigned char extra;
+            do
+            {
+                if (input >= size)
+                    return false;
+                extra = source[input++];
+                literal_length += extra;
+            } while (extra == 255);
+        }
+
+        if (literal_length > size - input || literal_length > target_size - output)
+            return false;
+        std::memcpy(target + output, source + input, literal_length);
+        input += literal_length;
+        output += literal_length;
+
+        if (input == size)
+            break;
+
+        if (size - input < 2)
+            return false;
+        const auto offset = static_cast<size_t>(source[input]) | static_cast<size_t>(source[input + 1]) << 8;
+        input += 2;
+        if (offset == 0 || offset > output)
+            return false;
+
+        size_t match_length = token & 15;
+        if (match_length == 15)
+        {
+            unsigned char extra;
+            do
+            {
+                if (input >= size)
+                    return false;
+                extra = source[input++];
+                match_length += extra;
+            } while (extra == 255);
+        }
+        match_length += LZ4_MIN_MATCH;
+
+        if (match_length > target_size - output)
+            return false;
+
+        // 匹配可能与输出重叠，逐字节复制
+        const auto match = target + output - offset;
+        for (size_t i = 0; i < match_length; i++)
+            target[output + i] = match[i];
+        output += match_length;
+    }
+
+    return output == target_size;
+}
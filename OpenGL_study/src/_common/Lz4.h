@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * LZ4 块格式（不含帧头）的压缩与解压，与官方 LZ4_compress_default / LZ4_decompress_safe 兼容
+ */
+
+// 最坏情况下的压缩结果大小
+size_t lz4_compress_bound(size_t size);
+
+// 返回压缩后的字节数，capacity 不足时返回 0
+size_t lz4_compress(const unsigned char *source, size_t size, unsigned char *target, size_t capacity);
+
+// 解压结果必须恰好为 target_size 字节，数据损坏时返回 false
+bool lz4_decompress(const unsigned char *source, size_t size, unsigned char *target, size_t target_size);
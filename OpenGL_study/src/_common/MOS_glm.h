@@ -3,9 +3,11 @@
 #ifdef __APPLE__
     #include "../libs/glm/glm.hpp"
     #include "../libs/glm/gtc/matrix_transform.hpp"
+    #include "../libs/glm/gtc/packing.hpp"
     #include "../libs/glm/gtc/type_ptr.inl"
 #else
     #include "glm/glm.hpp"
     #include "glm/gtc/matrix_transform.hpp"
+    #include "glm/gtc/packing.hpp"
     #include "glm/gtc/type_ptr.inl"
 #endif
@@ -0,0 +1,109 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filepath)
+    : data_(nullptr), size_(0),
+      file_handle_(INVALID_HANDLE_VALUE), mapping_handle_(nullptr)
+{
+    file_handle_ = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle_ == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle_, &file_size) || file_size.QuadPart == 0)
+    {
+        close();
+        return;
+    }
+
+    mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle_ == nullptr)
+    {
+        close();
+        return;
+    }
+
+    data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr)
+    {
+        close();
+        return;
+    }
+
+    size_ = static_cast<size_t>(file_size.QuadPart);
+}
+
+void MappedFile::close()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+
+    if (mapping_handle_)
+        CloseHandle(mapping_handle_);
+
+    if (file_handle_ != INVALID_HANDLE_VALUE)
+        CloseHandle(file_handle_);
+
+    data_ = nullptr;
+    size_ = 0;
+    mapping_handle_ = nullptr;
+    file_handle_ = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filepath)
+    : data_(nullptr), size_(0), file_descriptor_(-1)
+{
+    file_descriptor_ = open(filepath.c_str(), O_RDONLY);
+    if (file_descriptor_ < 0)
+        return;
+
+    struct stat file_stat {};
+    if (fstat(file_descriptor_, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+        close();
+        return;
+    }
+
+    auto *data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor_, 0);
+    if (data == MAP_FAILED)
+    {
+        close();
+        return;
+    }
+
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = static_cast<size_t>(file_stat.st_size);
+}
+
+void MappedFile::close()
+{
+    if (data_)
+        munmap(const_cast<unsigned char*>(data_), size_);
+
+    if (file_descriptor_ >= 0)
+        ::close(file_descriptor_);
+
+    data_ = nullptr;
+    size_ = 0;
+    file_descriptor_ = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+/**
+ * 只读内存映射文件
+ */
+class MappedFile
+{
+private:
+    const unsigned char *data_;
+    size_t size_;
+
+#ifdef _WIN32
+    void *file_handle_;
+    void *mapping_handle_;
+#else
+    int file_descriptor_;
+#endif
+
+public:
+    MappedFile(const std::string& filepath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    inline bool is_valid() const { return data_ != nullptr; }
+    inline const unsigned char* get_data() const { return data_; }
+    inline size_t get_size() const { return size_; }
+
+private:
+    void close();
+};
@@ -1,34 +1,256 @@
 #include "Mesh.h"
+#include "BufferHeap.h"
+#include "DrawBatch.h"
+#include "RenderQueue.h"
+#include "VertexPacking.h"
+#include <map>
+#include <tuple>
 #include <utility>
 
+namespace
+{
+    // 同一对顶点页与索引页、同一顶点格式的网格共用一个 VertexArray，绘制时以 base vertex 与索引偏移区分
+    VertexArray* get_shared_vertex_array(VertexBuffer& vertex_buffer, VertexBufferLayout& layout,
+                                         IndexBuffer& index_buffer, const VertexFormat vertex_format)
+    {
+        static std::map<std::tuple<unsigned int, unsigned int, int>, VertexArray*> vertex_arrays;
+
+        const auto key = std::make_tuple(vertex_buffer.get_renderer_id(), index_buffer.get_renderer_id(),
+                                         static_cast<int>(vertex_format));
+        auto& vertex_array = vertex_arrays[key];
+        if (vertex_array == nullptr)
+        {
+            vertex_array = new VertexArray();
+            vertex_array->add_buffer(vertex_buffer, layout, index_buffer);
+        }
+        return vertex_array;
+    }
+}
+
 Mesh::Mesh(std::vector<VertexData>  vertices,
            std::vector<unsigned>    indices,
-           std::vector<TextureData> textures)
+           std::vector<TextureData> textures,
+           const VertexFormat vertex_format)
     : vertices_ (std::move(vertices)), 
       indices_  (std::move(indices)), 
       texture_datas_ (std::move(textures)),
-      vertex_array_(nullptr)
+      vertex_array_(nullptr), vertex_buffer_(nullptr), index_buffer_(nullptr), vertex_stride_(0),
+      vertex_format_(vertex_format), vertex_buffer_size_(0), index_buffer_size_(0),
+      position_offset_(0.0f), position_scale_(1.0f),
+      bounds_center_(0.0f), bounds_radius_(0.0f),
+      culled_vertex_array_(nullptr), culled_index_buffer_(nullptr), culled_meshlet_count_(0),
+      uniform_shader_(nullptr), uniform_program_(0)
 {
-    setup_mesh();
+    setup_sampler_names();
+    setup_mesh(vertices_.data(), vertices_.size(), indices_.data(), indices_.size());
+}
+
+Mesh::Mesh(const VertexData   *vertices, const unsigned int vertex_count,
+           const unsigned int *indices,  const unsigned int index_count,
+           std::vector<TextureData> textures,
+           const VertexFormat vertex_format)
+    : texture_datas_ (std::move(textures)),
+      vertex_array_(nullptr), vertex_buffer_(nullptr), index_buffer_(nullptr), vertex_stride_(0),
+      vertex_format_(vertex_format), vertex_buffer_size_(0), index_buffer_size_(0),
+      position_offset_(0.0f), position_scale_(1.0f),
+      bounds_center_(0.0f), bounds_radius_(0.0f),
+      culled_vertex_array_(nullptr), culled_index_buffer_(nullptr), culled_meshlet_count_(0),
+      uniform_shader_(nullptr), uniform_program_(0)
+{
+    setup_sampler_names();
+    setup_mesh(vertices, vertex_count, indices, index_count);
 }
 
 Mesh::~Mesh()
 {
     vertex_array_ = nullptr;
+    vertex_buffer_ = nullptr;
+    index_buffer_ = nullptr;
+    culled_vertex_array_ = nullptr;
+    culled_index_buffer_ = nullptr;
+}
+
+void Mesh::release()
+{
+    vertex_buffer_->release();
+    index_buffer_->release();
+
+    // 簇剔除的索引缓冲与顶点数组由本网格独占，先删除引用索引缓冲的顶点数组
+    delete culled_vertex_array_;
+    delete culled_index_buffer_;
+    culled_vertex_array_ = nullptr;
+    culled_index_buffer_ = nullptr;
+}
+
+void Mesh::draw(const Renderer& renderer, Shader& shader, unsigned int lod)
+{
+    if (vertex_array_ == nullptr)
+        return;
+
+    apply_uniforms(shader);
+
+    lod = lod < lods_.size() ? lod : static_cast<unsigned int>(lods_.size()) - 1;
+    const auto base_vertex = get_base_vertex();
+    renderer.draw(*vertex_array_, *index_buffer_, shader, lods_[lod].index_count, lods_[lod].index_offset, base_vertex);
+}
+
+void Mesh::submit(DrawBatch& batch, const unsigned int instance, unsigned int lod)
+{
+    if (vertex_array_ == nullptr)
+        return;
+
+    lod = lod < lods_.size() ? lod : static_cast<unsigned int>(lods_.size()) - 1;
+    batch.add(*this, instance, lods_[lod].index_count, lods_[lod].index_offset);
+}
+
+int Mesh::get_base_vertex() const
+{
+    return static_cast<int>(vertex_buffer_->get_offset() / vertex_stride_);
 }
 
-void Mesh::draw(const Renderer& renderer, Shader& shader)
+void Mesh::draw_instanced(const Renderer& renderer, Shader& shader,
+                          const InstanceBuffer& instance_buffer, const unsigned int instance_count, unsigned int lod)
+{
+    if (vertex_array_ == nullptr)
+        return;
+
+    apply_uniforms(shader);
+
+    lod = lod < lods_.size() ? lod : static_cast<unsigned int>(lods_.size()) - 1;
+    const auto base_vertex = get_base_vertex();
+    renderer.draw_instanced(*vertex_array_, *index_buffer_, shader, instance_buffer, instance_count,
+                            lods_[lod].index_count, lods_[lod].index_offset, base_vertex);
+}
+
+void Mesh::submit(RenderQueue& queue, Shader& shader, const glm::mat4& model_mat, unsigned int lod)
+{
+    if (vertex_array_ == nullptr)
+        return;
+
+    lod = lod < lods_.size() ? lod : static_cast<unsigned int>(lods_.size()) - 1;
+    const auto base_vertex = get_base_vertex();
+    queue.submit(*vertex_array_, *index_buffer_, shader, lods_[lod].index_count, lods_[lod].index_offset, base_vertex,
+                 *this, model_mat);
+}
+
+unsigned int Mesh::draw_culled(const Renderer& renderer, Shader& shader,
+                               const Frustum& frustum, const glm::vec3& camera_position)
+{
+    if (meshlets_.empty())
+    {
+        draw(renderer, shader);
+        culled_meshlet_count_ = 0;
+        return lods_[0].index_count;
+    }
+
+    culled_indices_.clear();
+    culled_meshlet_count_ = 0;
+    for (const auto& meshlet : meshlets_)
+    {
+        if (!is_meshlet_visible(meshlet, frustum, camera_position))
+        {
+            culled_meshlet_count_++;
+            continue;
+        }
+
+        const auto first = meshlet_indices_.begin() + meshlet.index_offset;
+        culled_indices_.insert(culled_indices_.end(), first, first + meshlet.triangle_count * 3);
+    }
+
+    const auto index_count = static_cast<unsigned int>(culled_indices_.size());
+    if (index_count == 0)
+        return 0;
+
+    // 先绑定 VertexArray，索引缓冲的绑定才会记录在它上面
+    culled_vertex_array_->bind();
+    culled_index_buffer_->set_data(culled_indices_.data(), index_count);
+
+    apply_uniforms(shader);
+    const auto base_vertex = get_base_vertex();
+    renderer.draw(*culled_vertex_array_, *culled_index_buffer_, shader, index_count, 0, base_vertex);
+    return index_count;
+}
+
+void Mesh::set_meshlets(std::vector<Meshlet> meshlets, const unsigned int *indices)
+{
+    meshlets_ = std::move(meshlets);
+    meshlet_indices_.clear();
+    if (meshlets_.empty())
+        return;
+
+    const auto& last = meshlets_.back();
+    meshlet_indices_.assign(indices, indices + last.index_offset + last.triangle_count * 3);
+    culled_indices_.reserve(meshlet_indices_.size());
+
+    if (culled_vertex_array_ == nullptr)
+    {
+        culled_index_buffer_ = new IndexBuffer(meshlet_indices_.data(), static_cast<unsigned int>(meshlet_indices_.size()), GL_STREAM_DRAW);
+        auto vertex_buffer_layout = create_vertex_layout();
+        culled_vertex_array_ = new VertexArray();
+        culled_vertex_array_->add_buffer(*vertex_buffer_, vertex_buffer_layout, *culled_index_buffer_);
+    }
+}
+
+void Mesh::set_lods(std::vector<MeshLod> lods)
+{
+    if (lods.empty())
+        lods.push_back({ 0, static_cast<unsigned int>(index_buffer_->get_count()), 0.0f });
+    lods_ = std::move(lods);
+}
+
+void Mesh::set_texture(const std::string& path, const std::shared_ptr<Texture>& texture)
+{
+    for (auto& texture_data : texture_datas_)
+    {
+        if (texture_data.path == path)
+            texture_data.texture = texture;
+    }
+}
+
+void Mesh::apply_uniforms(Shader& shader)
+{
+    for (size_t i = 0, count = texture_datas_.size(); i < count; i++)
+        texture_datas_[i].texture->bind(i);
+
+    // 编译中的着色器没有反射信息，按名字记录，链接后重放
+    if (!shader.is_ready())
+    {
+        for (size_t i = 0, count = sampler_names_.size(); i < count; i++)
+            shader.set_int(sampler_names_[i], i);
+
+        if (vertex_format_ == VERTEX_FORMAT_PACKED)
+        {
+            shader.set_vec3f("u_PositionOffset", position_offset_);
+            shader.set_vec3f("u_PositionScale", position_scale_);
+        }
+        return;
+    }
+
+    if (uniform_shader_ != &shader || uniform_program_ != shader.get_renderer_id())
+        resolve_uniforms(shader);
+
+    for (size_t i = 0, count = sampler_handles_.size(); i < count; i++)
+        shader.set(sampler_handles_[i], static_cast<int>(i));
+
+    if (vertex_format_ == VERTEX_FORMAT_PACKED)
+    {
+        shader.set(position_offset_handle_, position_offset_);
+        shader.set(position_scale_handle_, position_scale_);
+    }
+}
+
+void Mesh::setup_sampler_names()
 {
     unsigned int diffuse_n = 1;
     unsigned int specular_n = 1;
     unsigned int normal_n = 1;
     unsigned int height_n = 1;
 
-    for (size_t i = 0, count = texture_datas_.size(); i < count; i++)
+    sampler_names_.clear();
+    for (const auto& texture_data : texture_datas_)
     {
-        texture_datas_[i].texture->bind(i);
         std::string number;
-        const auto type = texture_datas_[i].type;
+        const auto& type = texture_data.type;
         if (type == "texture_diffuse")
             number = std::to_string(diffuse_n++);
         else if (type == "texture_specular")
@@ -37,22 +259,85 @@ void Mesh::draw(const Renderer& renderer, Shader& shader)
             number = std::to_string(normal_n++);
         else if (type == "texture_height")
             number = std::to_string(height_n++);
-        shader.set_int("u_Material." + type + number, i);
+        sampler_names_.push_back("u_Material." + type + number);
+    }
+}
+
+void Mesh::resolve_uniforms(Shader& shader)
+{
+    uniform_shader_ = &shader;
+    uniform_program_ = shader.get_renderer_id();
+
+    // 着色器不一定用到全部纹理，采样器按可选解析
+    sampler_handles_.clear();
+    for (const auto& name : sampler_names_)
+        sampler_handles_.push_back(shader.get_uniform<int>(name, false));
+
+    if (vertex_format_ == VERTEX_FORMAT_PACKED)
+    {
+        position_offset_handle_ = shader.get_uniform<glm::vec3>("u_PositionOffset");
+        position_scale_handle_ = shader.get_uniform<glm::vec3>("u_PositionScale");
+    }
+}
+
+void Mesh::setup_mesh(const VertexData   *vertices, const unsigned int vertex_count,
+                      const unsigned int *indices,  const unsigned int index_count)
+{
+    index_buffer_ = new IndexBuffer(indices, index_count, BufferHeap::get_index_heap());
+    index_buffer_size_ = index_buffer_->get_size();
+    lods_.assign(1, { 0, index_count, 0.0f });
+
+    // 包围球：取包围盒中心
+    if (vertex_count > 0)
+    {
+        auto min_position = vertices[0].position;
+        auto max_position = vertices[0].position;
+        for (unsigned int i = 1; i < vertex_count; i++)
+        {
+            min_position = glm::min(min_position, vertices[i].position);
+            max_position = glm::max(max_position, vertices[i].position);
+        }
+
+        bounds_center_ = (min_position + max_position) * 0.5f;
+        for (unsigned int i = 0; i < vertex_count; i++)
+            bounds_radius_ = glm::max(bounds_radius_, glm::length(vertices[i].position - bounds_center_));
+    }
+
+    if (vertex_format_ == VERTEX_FORMAT_PACKED)
+    {
+        const auto packed = pack_vertices(vertices, vertex_count);
+        position_offset_ = packed.position_offset;
+        position_scale_ = packed.position_scale;
+
+        vertex_stride_ = sizeof(PackedVertexData);
+        vertex_buffer_size_ = vertex_count * vertex_stride_;
+        vertex_buffer_ = new VertexBuffer(packed.vertices.data(), vertex_buffer_size_, BufferHeap::get_vertex_heap(), vertex_stride_);
+    }
+    else
+    {
+        vertex_stride_ = sizeof(VertexData);
+        vertex_buffer_size_ = vertex_count * vertex_stride_;
+        vertex_buffer_ = new VertexBuffer(vertices, vertex_buffer_size_, BufferHeap::get_vertex_heap(), vertex_stride_);
     }
 
-    renderer.draw(*vertex_array_, shader);
+    // 空网格没有分配到区间，不创建 VertexArray，绘制时跳过
+    if (vertex_buffer_->get_renderer_id() == 0 || index_buffer_->get_renderer_id() == 0)
+        return;
+
+    auto vertex_buffer_layout = create_vertex_layout();
+    vertex_array_ = get_shared_vertex_array(*vertex_buffer_, vertex_buffer_layout, *index_buffer_, vertex_format_);
 }
 
-void Mesh::setup_mesh()
+VertexBufferLayout Mesh::create_vertex_layout() const
 {
-    vertex_array_ = new VertexArray();
-    VertexBuffer vertex_buffer(&vertices_[0], vertices_.size() * sizeof(VertexData));
+    if (vertex_format_ == VERTEX_FORMAT_PACKED)
+        return packed_vertex_layout();
+
     VertexBufferLayout vertex_buffer_layout;
     vertex_buffer_layout.push<float>(3);        // 顶点位置
     vertex_buffer_layout.push<float>(3);        // 顶点法线
     vertex_buffer_layout.push<float>(2);        // 顶点纹理
     vertex_buffer_layout.push<float>(3);        // 切线向量
     vertex_buffer_layout.push<float>(3);        // 双切线向量
-    IndexBuffer index_buffer(&indices_[0], indices_.size());
-    vertex_array_->add_buffer(vertex_buffer, vertex_buffer_layout, index_buffer);
+    return vertex_buffer_layout;
 }
@@ -1,15 +1,24 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "MOS_glm.h"
+#include "Meshlet.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "UniformHandle.h"
 
 class VertexArray;
+class VertexBuffer;
+class VertexBufferLayout;
+class IndexBuffer;
 class Shader;
 class Renderer;
+class RenderQueue;
+class InstanceBuffer;
+class DrawBatch;
 
 /**
  * 顶点数据
@@ -28,11 +37,42 @@ struct VertexData
  */
 struct TextureData
 {
-    Texture *texture;       // 纹理数据
+    std::shared_ptr<Texture> texture;   // 纹理数据，由 TextureCache 共享
     std::string type;       // 纹理类型
     std::string path;       // 路径
 };
 
+/**
+ * 上传到显存的顶点格式
+ */
+enum VertexFormat
+{
+    VERTEX_FORMAT_FULL,     // VertexData，全部为 float
+    VERTEX_FORMAT_PACKED,   // PackedVertexData，见 VertexPacking.h
+};
+
+/**
+ * 网格的一级细节，各级索引依次存放在同一个索引缓冲中
+ */
+struct MeshLod
+{
+    unsigned int index_offset;  // 在索引缓冲中的起始位置
+    unsigned int index_count;
+    float        error;         // 相对原网格的几何误差（模型空间）
+};
+
+/**
+ * CPU 端网格数据，不依赖 OpenGL 上下文，可在工作线程中生成
+ */
+struct MeshData
+{
+    std::vector<VertexData>   vertices;
+    std::vector<unsigned int> indices;
+    std::vector<TextureData>  textures;     // 只填写 type 与 path
+    std::vector<MeshLod>      lods;         // 为空时只有原网格一级
+    std::vector<Meshlet>      meshlets;     // 第 0 级的分簇，为空时不做簇剔除
+};
+
 class Mesh
 {
 private:
@@ -40,16 +80,99 @@ private:
     std::vector<unsigned int> indices_;
     std::vector<TextureData>  texture_datas_;
 
-    VertexArray *vertex_array_;
+    // 顶点与索引是全局缓冲堆中的子区间，vertex_array_ 由同页同格式的网格共用
+    VertexArray  *vertex_array_;
+    VertexBuffer *vertex_buffer_;
+    IndexBuffer  *index_buffer_;
+    unsigned int  vertex_stride_;
+
+    VertexFormat vertex_format_;
+    unsigned int vertex_buffer_size_;   // 顶点缓冲大小（字节）
+    unsigned int index_buffer_size_;    // 索引缓冲大小（字节）
+    glm::vec3    position_offset_;      // 压缩格式还原位置用
+    glm::vec3    position_scale_;
+
+    std::vector<MeshLod> lods_;         // 第 0 级为原网格
+    glm::vec3    bounds_center_;        // 包围球（模型空间）
+    float        bounds_radius_;
+
+    // 簇剔除：可见簇的索引每帧写入独立的动态索引缓冲，与原顶点缓冲组成另一个 VertexArray
+    std::vector<Meshlet>      meshlets_;
+    std::vector<unsigned int> meshlet_indices_;     // 第 0 级索引的 CPU 副本
+    std::vector<unsigned int> culled_indices_;
+    VertexArray  *culled_vertex_array_;
+    IndexBuffer  *culled_index_buffer_;
+    unsigned int  culled_meshlet_count_;            // 上一次 draw_culled 剔除的簇数
+
+    // 采样器名在构造时生成，uniform 句柄按最近一次使用的着色器解析
+    std::vector<std::string>        sampler_names_;
+    const Shader                   *uniform_shader_;
+    unsigned int                    uniform_program_;
+    std::vector<UniformHandle<int>> sampler_handles_;
+    UniformHandle<glm::vec3>        position_offset_handle_;
+    UniformHandle<glm::vec3>        position_scale_handle_;
 
 public:
     Mesh(std::vector<VertexData>  vertices,
          std::vector<unsigned>    indices,
-         std::vector<TextureData> textures);
+         std::vector<TextureData> textures,
+         VertexFormat vertex_format = VERTEX_FORMAT_FULL);
+    // 直接从外部内存（如映射的缓存文件）上传，不保留 CPU 端副本
+    Mesh(const VertexData   *vertices, unsigned int vertex_count,
+         const unsigned int *indices,  unsigned int index_count,
+         std::vector<TextureData> textures,
+         VertexFormat vertex_format = VERTEX_FORMAT_FULL);
     ~Mesh();
 
-    void draw(const Renderer& renderer, Shader& shader);
+    // 归还顶点与索引占用的缓冲堆区间并删除簇剔除缓冲，Mesh 副本共享这些资源，只能由持有者调用一次
+    void release();
+
+    void draw(const Renderer& renderer, Shader& shader, unsigned int lod = 0);
+    // 一次绘制 instance_count 个实例，共用顶点数组的网格会依次挂接同一实例缓冲
+    void draw_instanced(const Renderer& renderer, Shader& shader,
+                        const InstanceBuffer& instance_buffer, unsigned int instance_count, unsigned int lod = 0);
+    // 只绘制通过视锥与法线锥测试的簇，camera_position 为模型空间坐标，返回提交的索引数
+    // 未设置簇时绘制第 0 级
+    unsigned int draw_culled(const Renderer& renderer, Shader& shader,
+                             const Frustum& frustum, const glm::vec3& camera_position);
+
+    // 追加到渲染队列，排序后统一提交
+    void submit(RenderQueue& queue, Shader& shader, const glm::mat4& model_mat, unsigned int lod = 0);
+    // 追加到合批绘制，instance 为 DrawBatch::add_instance 返回的逐绘制数据下标
+    void submit(DrawBatch& batch, unsigned int instance, unsigned int lod = 0);
+
+    // 绑定材质纹理，压缩格式时设置位置解码参数
+    void apply_uniforms(Shader& shader);
+
+    // 替换引用该路径的纹理，用于异步加载完成后换掉占位纹理
+    void set_texture(const std::string& path, const std::shared_ptr<Texture>& texture);
+
+    inline const std::vector<VertexData>& get_vertices() const { return vertices_; }
+    inline const std::vector<unsigned int>& get_indices() const { return indices_; }
+    inline const std::vector<TextureData>& get_texture_datas() const { return texture_datas_; }
+    inline VertexFormat get_vertex_format() const { return vertex_format_; }
+    inline VertexArray* get_vertex_array() const { return vertex_array_; }
+    inline IndexBuffer* get_index_buffer() const { return index_buffer_; }
+    // 顶点在共享缓冲页中的起始下标，碎片整理后会变化，需在绘制时查询
+    int get_base_vertex() const;
+    inline unsigned int get_vertex_buffer_size() const { return vertex_buffer_size_; }
+    inline unsigned int get_index_buffer_size() const { return index_buffer_size_; }
+
+    // 设置 LOD 区间，未设置时整个索引缓冲为第 0 级
+    void set_lods(std::vector<MeshLod> lods);
+    inline const std::vector<MeshLod>& get_lods() const { return lods_; }
+    inline glm::vec3 get_bounds_center() const { return bounds_center_; }
+    inline float get_bounds_radius() const { return bounds_radius_; }
+
+    // 设置第 0 级的分簇，indices 为与上传时相同的索引数据
+    void set_meshlets(std::vector<Meshlet> meshlets, const unsigned int *indices);
+    inline const std::vector<Meshlet>& get_meshlets() const { return meshlets_; }
+    inline unsigned int get_culled_meshlet_count() const { return culled_meshlet_count_; }
 
 private:
-    void setup_mesh();
+    void setup_mesh(const VertexData   *vertices, unsigned int vertex_count,
+                    const unsigned int *indices,  unsigned int index_count);
+    VertexBufferLayout create_vertex_layout() const;
+    void setup_sampler_names();
+    void resolve_uniforms(Shader& shader);
 };
@@ -0,0 +1,307 @@
+#include "MeshCache.h"
+#include "AssetPack.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+    const uint64_t MESH_CACHE_ALIGNMENT = 16;
+
+    uint64_t align_up(const uint64_t value, const uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void write_padding(std::ofstream& stream, const uint64_t from, const uint64_t to)
+    {
+        static const char zeros[MESH_CACHE_ALIGNMENT] = {};
+        if (to > from)
+            stream.write(zeros, static_cast<std::streamsize>(to - from));
+    }
+}
+
+MeshCache::MeshCache(std::string cache_path)
+    : cache_path_(std::move(cache_path)), mapped_file_(nullptr),
+      header_(nullptr), entries_(nullptr), textures_(nullptr), lods_(nullptr), meshlets_(nullptr), strings_(nullptr)
+{
+}
+
+MeshCache::~MeshCache()
+{
+    close();
+}
+
+bool MeshCache::open(const uint64_t source_hash, const unsigned int import_flags)
+{
+    close();
+
+    mapped_file_ = new MappedFile(cache_path_);
+    if (!mapped_file_->is_valid())
+    {
+        close();
+        return false;
+    }
+
+    const auto data = mapped_file_->get_data();
+    const auto size = static_cast<uint64_t>(mapped_file_->get_size());
+    if (size < sizeof(MeshCacheHeader))
+    {
+        close();
+        return false;
+    }
+
+    const auto header = reinterpret_cast<const MeshCacheHeader*>(data);
+    if (std::memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0
+        || header->version != MESH_CACHE_VERSION
+        || header->vertex_size != sizeof(VertexData)
+        || header->import_flags != import_flags
+        || header->source_hash != source_hash)
+    {
+        close();
+        return false;
+    }
+
+    const auto entries_offset = align_up(sizeof(MeshCacheHeader), MESH_CACHE_ALIGNMENT);
+    const auto textures_offset = entries_offset + header->mesh_count * sizeof(MeshCacheEntry);
+    const auto lods_offset = textures_offset + header->texture_count * sizeof(MeshCacheTexture);
+    const auto meshlets_offset = lods_offset + header->lod_count * sizeof(MeshCacheLod);
+    const auto tables_end = meshlets_offset + header->meshlet_count * sizeof(Meshlet);
+    if (tables_end > size || header->strings_offset + header->strings_size > size)
+    {
+        close();
+        return false;
+    }
+
+    const auto entries = reinterpret_cast<const MeshCacheEntry*>(data + entries_offset);
+    const auto textures = reinterpret_cast<const MeshCacheTexture*>(data + textures_offset);
+    const auto lods = reinterpret_cast<const MeshCacheLod*>(data + lods_offset);
+    const auto meshlets = reinterpret_cast<const Meshlet*>(data + meshlets_offset);
+    for (size_t i = 0; i < header->mesh_count; i++)
+    {
+        const auto& entry = entries[i];
+        auto lods_valid = entry.lod_first + entry.lod_count <= header->lod_count;
+        for (size_t j = entry.lod_first; lods_valid && j < entry.lod_first + entry.lod_count; j++)
+            lods_valid = static_cast<uint64_t>(lods[j].index_offset) + lods[j].index_count <= entry.index_count;
+
+        auto meshlets_valid = entry.meshlet_first + entry.meshlet_count <= header->meshlet_count;
+        for (size_t j = entry.meshlet_first; meshlets_valid && j < entry.meshlet_first + entry.meshlet_count; j++)
+            meshlets_valid = meshlets[j].index_offset + meshlets[j].triangle_count * 3ULL <= entry.index_count;
+
+        auto textures_valid = entry.texture_first + entry.texture_count <= header->texture_count;
+        for (size_t j = entry.texture_first; textures_valid && j < entry.texture_first + entry.texture_count; j++)
+        {
+            textures_valid = static_cast<uint64_t>(textures[j].type_offset) + textures[j].type_length <= header->strings_size
+                          && static_cast<uint64_t>(textures[j].path_offset) + textures[j].path_length <= header->strings_size;
+        }
+
+        if (entry.vertex_offset + entry.vertex_count * sizeof(VertexData) > size
+            || entry.index_offset + entry.index_count * sizeof(unsigned int) > size
+            || !textures_valid
+            || !lods_valid
+            || !meshlets_valid)
+        {
+            std::cout << "[ERROR] MeshCache: corrupted cache file " << cache_path_ << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    header_   = header;
+    entries_  = entries;
+    textures_ = textures;
+    lods_     = lods;
+    meshlets_ = meshlets;
+    strings_  = reinterpret_cast<const char*>(data + header->strings_offset);
+    return true;
+}
+
+unsigned int MeshCache::get_mesh_count() const
+{
+    return header_ ? header_->mesh_count : 0;
+}
+
+MeshCacheView MeshCache::get_mesh(const unsigned int index) const
+{
+    const auto data = mapped_file_->get_data();
+    const auto& entry = entries_[index];
+
+    MeshCacheView view {};
+    view.vertices     = reinterpret_cast<const VertexData*>(data + entry.vertex_offset);
+    view.vertex_count = entry.vertex_count;
+    view.indices      = reinterpret_cast<const unsigned int*>(data + entry.index_offset);
+    view.index_count  = entry.index_count;
+
+    for (size_t i = entry.texture_first, end = entry.texture_first + entry.texture_count; i < end; i++)
+    {
+        TextureData texture_data {};
+        texture_data.texture = nullptr;
+        texture_data.type.assign(strings_ + textures_[i].type_offset, textures_[i].type_length);
+        texture_data.path.assign(strings_ + textures_[i].path_offset, textures_[i].path_length);
+        view.textures.push_back(texture_data);
+    }
+
+    for (size_t i = entry.lod_first, end = entry.lod_first + entry.lod_count; i < end; i++)
+        view.lods.push_back({ lods_[i].index_offset, lods_[i].index_count, lods_[i].error });
+
+    view.meshlets.assign(meshlets_ + entry.meshlet_first, meshlets_ + entry.meshlet_first + entry.meshlet_count);
+
+    return view;
+}
+
+bool MeshCache::write(const std::string& cache_path,
+                      const uint64_t source_hash,
+                      const unsigned int import_flags,
+                      const std::vector<MeshData>& meshes)
+{
+    std::vector<MeshCacheEntry>   entries(meshes.size());
+    std::vector<MeshCacheTexture> textures;
+    std::vector<MeshCacheLod>     lods;
+    std::vector<Meshlet>          meshlets;
+    std::string strings;
+
+    // 计算各区块偏移：文件头 | 网格表 | 纹理表 | LOD 表 | 簇表 | 字符串区 | 顶点与索引数据
+    for (size_t i = 0, count = meshes.size(); i < count; i++)
+    {
+        entries[i].texture_first = static_cast<uint32_t>(textures.size());
+        entries[i].texture_count = static_cast<uint32_t>(meshes[i].textures.size());
+
+        for (const auto& texture_data : meshes[i].textures)
+        {
+            MeshCacheTexture texture {};
+            texture.type_offset = static_cast<uint32_t>(strings.size());
+            texture.type_length = static_cast<uint32_t>(texture_data.type.size());
+            strings += texture_data.type;
+            texture.path_offset = static_cast<uint32_t>(strings.size());
+            texture.path_length = static_cast<uint32_t>(texture_data.path.size());
+            strings += texture_data.path;
+            textures.push_back(texture);
+        }
+
+        entries[i].lod_first = static_cast<uint32_t>(lods.size());
+        entries[i].lod_count = static_cast<uint32_t>(meshes[i].lods.size());
+        for (const auto& lod : meshes[i].lods)
+            lods.push_back({ lod.index_offset, lod.index_count, lod.error, 0 });
+
+        entries[i].meshlet_first = static_cast<uint32_t>(meshlets.size());
+        entries[i].meshlet_count = static_cast<uint32_t>(meshes[i].meshlets.size());
+        meshlets.insert(meshlets.end(), meshes[i].meshlets.begin(), meshes[i].meshlets.end());
+    }
+
+    MeshCacheHeader header {};
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    header.version       = MESH_CACHE_VERSION;
+    header.vertex_size   = sizeof(VertexData);
+    header.import_flags  = import_flags;
+    header.source_hash   = source_hash;
+    header.mesh_count    = static_cast<uint32_t>(meshes.size());
+    header.texture_count = static_cast<uint32_t>(textures.size());
+    header.lod_count     = static_cast<uint32_t>(lods.size());
+    header.meshlet_count = static_cast<uint32_t>(meshlets.size());
+
+    const auto entries_offset = align_up(sizeof(MeshCacheHeader), MESH_CACHE_ALIGNMENT);
+    header.strings_offset = entries_offset
+                          + entries.size() * sizeof(MeshCacheEntry)
+                          + textures.size() * sizeof(MeshCacheTexture)
+                          + lods.size() * sizeof(MeshCacheLod)
+                          + meshlets.size() * sizeof(Meshlet);
+    header.strings_size = strings.size();
+
+    auto offset = align_up(header.strings_offset + header.strings_size, MESH_CACHE_ALIGNMENT);
+    for (size_t i = 0, count = meshes.size(); i < count; i++)
+    {
+        entries[i].vertex_count = static_cast<uint32_t>(meshes[i].vertices.size());
+        entries[i].index_count  = static_cast<uint32_t>(meshes[i].indices.size());
+
+        entries[i].vertex_offset = offset;
+        offset = align_up(offset + entries[i].vertex_count * sizeof(VertexData), MESH_CACHE_ALIGNMENT);
+        entries[i].index_offset = offset;
+        offset = align_up(offset + entries[i].index_count * sizeof(unsigned int), MESH_CACHE_ALIGNMENT);
+    }
+
+    // 先写临时文件再替换，避免中途失败留下半个缓存
+    const auto temp_path = cache_path + ".tmp";
+    std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        std::cout << "[ERROR] MeshCache: can not write cache file " << cache_path << std::endl;
+        return false;
+    }
+
+    uint64_t position = 0;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    position += sizeof(header);
+    write_padding(stream, position, entries_offset);
+    position = entries_offset;
+
+    stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(MeshCacheEntry));
+    stream.write(reinterpret_cast<const char*>(textures.data()), textures.size() * sizeof(MeshCacheTexture));
+    stream.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(MeshCacheLod));
+    stream.write(reinterpret_cast<const char*>(meshlets.data()), meshlets.size() * sizeof(Meshlet));
+    stream.write(strings.data(), strings.size());
+    position = header.strings_offset + header.strings_size;
+
+    for (size_t i = 0, count = meshes.size(); i < count; i++)
+    {
+        const auto& vertices = meshes[i].vertices;
+        const auto& indices = meshes[i].indices;
+
+        write_padding(stream, position, entries[i].vertex_offset);
+        stream.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(VertexData));
+        position = entries[i].vertex_offset + vertices.size() * sizeof(VertexData);
+
+        write_padding(stream, position, entries[i].index_offset);
+        stream.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(unsigned int));
+        position = entries[i].index_offset + indices.size() * sizeof(unsigned int);
+    }
+
+    stream.close();
+    if (!stream)
+    {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    std::remove(cache_path.c_str());
+    return std::rename(temp_path.c_str(), cache_path.c_str()) == 0;
+}
+
+uint64_t MeshCache::hash_file(const std::string& filepath)
+{
+    const auto asset = AssetPack::read(filepath);
+    if (asset.is_valid())
+        return hash_bytes(asset.data, asset.size);
+
+    const MappedFile file(filepath);
+    if (!file.is_valid())
+        return 0;
+
+    return hash_bytes(file.get_data(), file.get_size());
+}
+
+uint64_t MeshCache::hash_bytes(const void *data, const size_t size, uint64_t seed)
+{
+    // FNV-1a 64
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        seed ^= bytes[i];
+        seed *= 1099511628211ULL;
+    }
+    return seed;
+}
+
+void MeshCache::close()
+{
+    delete mapped_file_;
+    mapped_file_ = nullptr;
+    header_   = nullptr;
+    entries_  = nullptr;
+    textures_ = nullptr;
+    lods_     = nullptr;
+    meshlets_ = nullptr;
+    strings_  = nullptr;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "Mesh.h"
+
+const char         MESH_CACHE_MAGIC[4] = { 'M', 'S', 'H', 'C' };
+const unsigned int MESH_CACHE_VERSION  = 3;
+
+/**
+ * 网格缓存文件头
+ */
+struct MeshCacheHeader
+{
+    char          magic[4];         // 文件标识 "MSHC"
+    uint32_t      version;          // 缓存格式版本
+    uint32_t      vertex_size;      // sizeof(VertexData)，结构体布局变化时缓存失效
+    uint32_t      import_flags;     // Assimp 后期处理指令
+    uint64_t      source_hash;      // 源文件哈希
+    uint32_t      mesh_count;       // 网格数量
+    uint32_t      texture_count;    // 纹理引用数量
+    uint32_t      lod_count;        // LOD 条目数量
+    uint32_t      meshlet_count;    // 簇条目数量
+    uint64_t      strings_offset;   // 字符串区偏移
+    uint64_t      strings_size;     // 字符串区大小
+};
+
+/**
+ * 网格缓存条目，偏移均相对于文件起始位置
+ */
+struct MeshCacheEntry
+{
+    uint64_t      vertex_offset;
+    uint64_t      index_offset;
+    uint32_t      vertex_count;
+    uint32_t      index_count;
+    uint32_t      texture_first;    // 在纹理引用表中的起始下标
+    uint32_t      texture_count;
+    uint32_t      lod_first;        // 在 LOD 表中的起始下标
+    uint32_t      lod_count;
+    uint32_t      meshlet_first;    // 在簇表中的起始下标
+    uint32_t      meshlet_count;
+};
+
+/**
+ * LOD 条目，索引偏移相对于所属网格的索引数据
+ */
+struct MeshCacheLod
+{
+    uint32_t      index_offset;
+    uint32_t      index_count;
+    float         error;
+    uint32_t      reserved;
+};
+
+/**
+ * 材质纹理引用，字符串存放在字符串区
+ */
+struct MeshCacheTexture
+{
+    uint32_t      type_offset;
+    uint32_t      type_length;
+    uint32_t      path_offset;
+    uint32_t      path_length;
+};
+
+/**
+ * 缓存中单个网格的只读视图，顶点与索引直接指向映射内存
+ */
+struct MeshCacheView
+{
+    const VertexData   *vertices;
+    unsigned int        vertex_count;
+    const unsigned int *indices;
+    unsigned int        index_count;
+
+    std::vector<TextureData> textures;  // 只填写 type 与 path
+    std::vector<MeshLod>     lods;      // 为空时只有原网格一级
+    std::vector<Meshlet>     meshlets;  // 为空时不做簇剔除
+};
+
+/**
+ * 模型的二进制网格缓存
+ *
+ * 以源文件哈希与导入指令为键，保存处理后的顶点、索引与材质纹理引用，
+ * 加载时直接映射文件，不做解析也不逐顶点拷贝
+ */
+class MeshCache
+{
+private:
+    std::string  cache_path_;
+    MappedFile  *mapped_file_;
+
+    const MeshCacheHeader  *header_;
+    const MeshCacheEntry   *entries_;
+    const MeshCacheTexture *textures_;
+    const MeshCacheLod     *lods_;
+    const Meshlet          *meshlets_;
+    const char             *strings_;
+
+public:
+    MeshCache(std::string cache_path);
+    ~MeshCache();
+
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    // 映射缓存文件并校验，键不匹配或文件损坏时返回 false
+    bool open(uint64_t source_hash, unsigned int import_flags);
+
+    unsigned int get_mesh_count() const;
+    MeshCacheView get_mesh(unsigned int index) const;
+
+    static bool write(const std::string& cache_path,
+                      uint64_t source_hash,
+                      unsigned int import_flags,
+                      const std::vector<MeshData>& meshes);
+
+    static uint64_t hash_file(const std::string& filepath);
+    static uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+private:
+    void close();
+};
@@ -0,0 +1,408 @@
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    struct VertexHasher
+    {
+        size_t operator()(const VertexData& vertex) const
+        {
+            return static_cast<size_t>(MeshCache::hash_bytes(&vertex, sizeof(VertexData)));
+        }
+    };
+
+    struct VertexEqual
+    {
+        bool operator()(const VertexData& a, const VertexData& b) const
+        {
+            return std::memcmp(&a, &b, sizeof(VertexData)) == 0;
+        }
+    };
+
+    const unsigned int INVALID_INDEX = ~0u;
+
+    /**
+     * Tipsify 选择下一个扇形中心：优先选仍在缓存中、且剩余三角形能在缓存中完成的顶点
+     */
+    unsigned int next_fanning_vertex(const std::vector<unsigned int>& candidates,
+                                     const std::vector<unsigned int>& live_count,
+                                     const std::vector<unsigned int>& timestamps,
+                                     const unsigned int time_stamp,
+                                     const unsigned int cache_size)
+    {
+        auto best_vertex = INVALID_INDEX;
+        auto best_priority = -1;
+        for (const auto vertex : candidates)
+        {
+            if (live_count[vertex] == 0)
+                continue;
+
+            auto priority = 0;
+            if (time_stamp - timestamps[vertex] + 2 * live_count[vertex] <= cache_size)
+                priority = static_cast<int>(time_stamp - timestamps[vertex]);
+
+            if (priority > best_priority)
+            {
+                best_priority = priority;
+                best_vertex = vertex;
+            }
+        }
+        return best_vertex;
+    }
+
+    /**
+     * 候选顶点都已用完，从死角栈或按顺序扫描找下一个还有三角形的顶点
+     */
+    unsigned int skip_dead_end(const std::vector<unsigned int>& live_count,
+                               std::vector<unsigned int>& dead_end_stack,
+                               unsigned int& cursor)
+    {
+        while (!dead_end_stack.empty())
+        {
+            const auto vertex = dead_end_stack.back();
+            dead_end_stack.pop_back();
+            if (live_count[vertex] > 0)
+                return vertex;
+        }
+
+        for (; cursor < live_count.size(); cursor++)
+        {
+            if (live_count[cursor] > 0)
+                return cursor;
+        }
+
+        return INVALID_INDEX;
+    }
+}
+
+unsigned int weld_vertices(MeshData& mesh_data)
+{
+    std::unordered_map<VertexData, unsigned int, VertexHasher, VertexEqual> unique_vertices;
+    unique_vertices.reserve(mesh_data.vertices.size());
+
+    std::vector<VertexData> vertices;
+    std::vector<unsigned int> remap(mesh_data.vertices.size());
+    for (size_t i = 0, count = mesh_data.vertices.size(); i < count; i++)
+    {
+        const auto result = unique_vertices.emplace(mesh_data.vertices[i], static_cast<unsigned int>(vertices.size()));
+        if (result.second)
+            vertices.push_back(mesh_data.vertices[i]);
+        remap[i] = result.first->second;
+    }
+
+    for (auto& index : mesh_data.indices)
+        index = remap[index];
+
+    mesh_data.vertices.swap(vertices);
+    return static_cast<unsigned int>(mesh_data.vertices.size());
+}
+
+void optimize_vertex_cache(std::vector<unsigned int>& indices, const unsigned int vertex_count,
+                           std::vector<unsigned int> *clusters, const unsigned int cache_size)
+{
+    const auto triangle_count = static_cast<unsigned int>(indices.size() / 3);
+    if (clusters)
+        clusters->clear();
+    if (triangle_count == 0 || vertex_count == 0)
+        return;
+
+    // 顶点 -> 相邻三角形表
+    std::vector<unsigned int> live_count(vertex_count, 0);
+    for (const auto index : indices)
+        live_count[index]++;
+
+    std::vector<unsigned int> adjacency_offsets(vertex_count + 1, 0);
+    for (unsigned int i = 0; i < vertex_count; i++)
+        adjacency_offsets[i + 1] = adjacency_offsets[i] + live_count[i];
+
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill = adjacency_offsets;
+    for (unsigned int i = 0; i < triangle_count; i++)
+    {
+        for (unsigned int j = 0; j < 3; j++)
+            adjacency[fill[indices[i * 3 + j]]++] = i;
+    }
+
+    std::vector<unsigned int> timestamps(vertex_count, 0);
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<unsigned int> dead_end_stack;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    auto time_stamp = cache_size + 1;
+    unsigned int cursor = 0;
+    auto fanning_vertex = indices[0];
+    auto restarted = true;
+
+    while (fanning_vertex != INVALID_INDEX)
+    {
+        // 从死角或顺序扫描重新开始的位置就是簇边界
+        if (restarted && clusters)
+            clusters->push_back(static_cast<unsigned int>(result.size() / 3));
+
+        candidates.clear();
+        for (auto i = adjacency_offsets[fanning_vertex]; i < adjacency_offsets[fanning_vertex + 1]; i++)
+        {
+            const auto triangle = adjacency[i];
+            if (emitted[triangle])
+                continue;
+
+            for (unsigned int j = 0; j < 3; j++)
+            {
+                const auto vertex = indices[triangle * 3 + j];
+                result.push_back(vertex);
+                dead_end_stack.push_back(vertex);
+                candidates.push_back(vertex);
+                live_count[vertex]--;
+
+                if (time_stamp - timestamps[vertex] > cache_size)
+                    timestamps[vertex] = time_stamp++;
+            }
+            emitted[triangle] = true;
+        }
+
+        fanning_vertex = next_fanning_vertex(candidates, live_count, timestamps, time_stamp, cache_size);
+        restarted = fanning_vertex == INVALID_INDEX;
+        if (restarted)
+            fanning_vertex = skip_dead_end(live_count, dead_end_stack, cursor);
+    }
+
+    indices.swap(result);
+}
+
+void optimize_overdraw(MeshData& mesh_data, const std::vector<unsigned int>& clusters)
+{
+    const auto& vertices = mesh_data.vertices;
+    auto& indices = mesh_data.indices;
+    const auto triangle_count = static_cast<unsigned int>(indices.size() / 3);
+    if (clusters.size() < 2 || triangle_count == 0)
+        return;
+
+    // 面积加权的网格中心
+    glm::vec3 mesh_centroid(0.0f);
+    auto mesh_area = 0.0f;
+    for (unsigned int i = 0; i < triangle_count; i++)
+    {
+        const auto& a = vertices[indices[i * 3 + 0]].position;
+        const auto& b = vertices[indices[i * 3 + 1]].position;
+        const auto& c = vertices[indices[i * 3 + 2]].position;
+        const auto area = glm::length(glm::cross(b - a, c - a));
+        mesh_centroid += (a + b + c) * (area / 3.0f);
+        mesh_area += area;
+    }
+    if (mesh_area > 0.0f)
+        mesh_centroid /= mesh_area;
+
+    struct Cluster
+    {
+        unsigned int begin, end;    // 三角形范围
+        float        sort_key;
+    };
+
+    std::vector<Cluster> sorted_clusters;
+    for (size_t i = 0, count = clusters.size(); i < count; i++)
+    {
+        Cluster cluster {};
+        cluster.begin = clusters[i];
+        cluster.end = i + 1 < count ? clusters[i + 1] : triangle_count;
+
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        auto area = 0.0f;
+        for (auto t = cluster.begin; t < cluster.end; t++)
+        {
+            const auto& a = vertices[indices[t * 3 + 0]].position;
+            const auto& b = vertices[indices[t * 3 + 1]].position;
+            const auto& c = vertices[indices[t * 3 + 2]].position;
+            const auto n = glm::cross(b - a, c - a);
+            const auto triangle_area = glm::length(n);
+            centroid += (a + b + c) * (triangle_area / 3.0f);
+            normal += n;
+            area += triangle_area;
+        }
+        if (area > 0.0f)
+            centroid /= area;
+
+        // 朝外的簇更可能遮挡其他簇，排在前面
+        const auto normal_length = glm::length(normal);
+        cluster.sort_key = normal_length > 0.0f ? glm::dot(centroid - mesh_centroid, normal / normal_length) : 0.0f;
+        sorted_clusters.push_back(cluster);
+    }
+
+    std::stable_sort(sorted_clusters.begin(), sorted_clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sort_key > b.sort_key; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const auto& cluster : sorted_clusters)
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+
+    indices.swap(result);
+}
+
+void optimize_vertex_fetch(MeshData& mesh_data)
+{
+    std::vector<unsigned int> remap(mesh_data.vertices.size(), INVALID_INDEX);
+    std::vector<VertexData> vertices;
+    vertices.reserve(mesh_data.vertices.size());
+
+    for (auto& index : mesh_data.indices)
+    {
+        if (remap[index] == INVALID_INDEX)
+        {
+            remap[index] = static_cast<unsigned int>(vertices.size());
+            vertices.push_back(mesh_data.vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    // 未被引用的顶点直接丢弃
+    mesh_data.vertices.swap(vertices);
+}
+
+VertexCacheStats analyze_vertex_cache(const std::vector<unsigned int>& indices, const unsigned int vertex_count,
+                                      const unsigned int cache_size)
+{
+    VertexCacheStats stats {};
+    if (indices.empty() || vertex_count == 0)
+        return stats;
+
+    // FIFO 缓存：记录每个顶点进入缓存时的序号
+    std::vector<unsigned int> timestamps(vertex_count, 0);
+    std::vector<bool> referenced(vertex_count, false);
+    unsigned int transformed = 0;
+    unsigned int unique = 0;
+    auto time_stamp = cache_size + 1;
+
+    for (const auto index : indices)
+    {
+        if (time_stamp - timestamps[index] > cache_size)
+        {
+            timestamps[index] = time_stamp++;
+            transformed++;
+        }
+
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            unique++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(transformed) / (indices.size() / 3);
+    stats.atvr = static_cast<float>(transformed) / unique;
+    return stats;
+}
+
+std::vector<unsigned int> stripify(const std::vector<unsigned int>& indices, const unsigned int restart_index)
+{
+    const auto triangle_count = indices.size() / 3;
+    const auto edge_key = [](const unsigned int from, const unsigned int to)
+    {
+        return static_cast<uint64_t>(from) << 32 | to;
+    };
+
+    // 有向边 -> 按绕序包含该边的三角形
+    std::unordered_multimap<uint64_t, unsigned int> edge_triangles;
+    edge_triangles.reserve(indices.size());
+    for (unsigned int t = 0; t < triangle_count; t++)
+    {
+        for (unsigned int k = 0; k < 3; k++)
+            edge_triangles.emplace(edge_key(indices[t * 3 + k], indices[t * 3 + (k + 1) % 3]), t);
+    }
+
+    std::vector<bool> emitted(triangle_count, false);
+
+    // 找一个包含有向边 from -> to 的未输出三角形，返回其第三个顶点
+    const auto find_next = [&](const unsigned int from, const unsigned int to, unsigned int& triangle)
+    {
+        const auto range = edge_triangles.equal_range(edge_key(from, to));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (emitted[it->second])
+                continue;
+
+            triangle = it->second;
+            for (unsigned int k = 0; k < 3; k++)
+            {
+                const auto vertex = indices[triangle * 3 + k];
+                if (vertex != from && vertex != to)
+                    return vertex;
+            }
+            return indices[triangle * 3];
+        }
+        return INVALID_INDEX;
+    };
+
+    std::vector<unsigned int> strip;
+    strip.reserve(indices.size() / 2);
+    for (unsigned int t = 0; t < triangle_count; t++)
+    {
+        if (emitted[t])
+            continue;
+
+        // 选一个能接上第二个三角形的旋转作为起点，第二个三角形需包含反向边 v2 -> v1
+        unsigned int rotation = 0;
+        for (unsigned int r = 0; r < 3; r++)
+        {
+            unsigned int unused;
+            emitted[t] = true;
+            const auto next = find_next(indices[t * 3 + (r + 2) % 3], indices[t * 3 + (r + 1) % 3], unused);
+            emitted[t] = false;
+            if (next != INVALID_INDEX)
+            {
+                rotation = r;
+                break;
+            }
+        }
+
+        if (!strip.empty())
+            strip.push_back(restart_index);
+
+        const auto strip_begin = strip.size();
+        for (unsigned int k = 0; k < 3; k++)
+            strip.push_back(indices[t * 3 + (rotation + k) % 3]);
+        emitted[t] = true;
+
+        // 条带第 i 个三角形：i 为偶数时为 (v[i], v[i+1], v[i+2])，奇数时为 (v[i+1], v[i], v[i+2])
+        while (true)
+        {
+            const auto n = strip.size();
+            const auto a = strip[n - 2];
+            const auto b = strip[n - 1];
+            const auto even = (n - 2 - strip_begin) % 2 == 0;
+
+            unsigned int triangle = 0;
+            const auto next = even ? find_next(a, b, triangle) : find_next(b, a, triangle);
+            if (next == INVALID_INDEX)
+                break;
+
+            strip.push_back(next);
+            emitted[triangle] = true;
+        }
+    }
+
+    return strip;
+}
+
+void optimize_mesh(MeshData& mesh_data, VertexCacheStats *before, VertexCacheStats *after)
+{
+    if (before)
+        *before = analyze_vertex_cache(mesh_data.indices, static_cast<unsigned int>(mesh_data.vertices.size()));
+
+    const auto vertex_count = weld_vertices(mesh_data);
+
+    std::vector<unsigned int> clusters;
+    optimize_vertex_cache(mesh_data.indices, vertex_count, &clusters);
+    optimize_overdraw(mesh_data, clusters);
+    optimize_vertex_fetch(mesh_data);
+
+    if (after)
+        *after = analyze_vertex_cache(mesh_data.indices, static_cast<unsigned int>(mesh_data.vertices.size()));
+}
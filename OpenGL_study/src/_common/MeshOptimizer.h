@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+struct MeshData;
+
+/**
+ * 顶点缓存命中统计，按 FIFO 顶点缓存模拟
+ */
+struct VertexCacheStats
+{
+    float acmr;     // 平均每个三角形变换的顶点数，越接近 0.5 越好
+    float atvr;     // 变换的顶点数 / 唯一顶点数，理想值为 1
+};
+
+// 模拟的后变换顶点缓存大小
+const unsigned int VERTEX_CACHE_SIZE = 16;
+
+// 合并完全相同的顶点，返回合并后的顶点数
+unsigned int weld_vertices(MeshData& mesh_data);
+
+// Tipsify 三角形重排，提高后变换顶点缓存命中率；clusters 返回各簇起始三角形下标
+void optimize_vertex_cache(std::vector<unsigned int>& indices, unsigned int vertex_count,
+                           std::vector<unsigned int> *clusters = nullptr,
+                           unsigned int cache_size = VERTEX_CACHE_SIZE);
+
+// 按簇朝外程度排序，先画外侧三角形以减少过度绘制
+void optimize_overdraw(MeshData& mesh_data, const std::vector<unsigned int>& clusters);
+
+// 按索引首次出现的顺序重排顶点，提高顶点拉取的内存局部性
+void optimize_vertex_fetch(MeshData& mesh_data);
+
+VertexCacheStats analyze_vertex_cache(const std::vector<unsigned int>& indices, unsigned int vertex_count,
+                                      unsigned int cache_size = VERTEX_CACHE_SIZE);
+
+// 把三角形列表转换为三角形带，各条带之间以 restart_index 分隔（配合图元重启绘制），保持三角形朝向
+// 按原三角形顺序贪心延伸，宜在 optimize_vertex_cache 之后调用
+std::vector<unsigned int> stripify(const std::vector<unsigned int>& indices, unsigned int restart_index = ~0u);
+
+// 依次执行以上全部步骤，输出优化前后的统计
+void optimize_mesh(MeshData& mesh_data, VertexCacheStats *before = nullptr, VertexCacheStats *after = nullptr);
@@ -0,0 +1,308 @@
+#include "MeshSimplifier.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * 对称 4x4 矩阵，只存上三角
+     */
+    struct Quadric
+    {
+        double a2, ab, ac, ad;
+        double     b2, bc, bd;
+        double         c2, cd;
+        double             d2;
+        double weight;      // 累计面积，用于把误差归一化为平均距离平方
+
+        void add_plane(const glm::dvec3& n, const double d, const double w)
+        {
+            a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+            b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+            c2 += w * n.z * n.z; cd += w * n.z * d;
+            d2 += w * d * d;
+            weight += w;
+        }
+
+        void add(const Quadric& q)
+        {
+            a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+            b2 += q.b2; bc += q.bc; bd += q.bd;
+            c2 += q.c2; cd += q.cd;
+            d2 += q.d2;
+            weight += q.weight;
+        }
+
+        double error(const glm::vec3& p) const
+        {
+            const double x = p.x, y = p.y, z = p.z;
+            const auto e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                         + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                         + c2 * z * z + 2 * cd * z
+                         + d2;
+            return weight > 0.0 ? glm::abs(e) / weight : 0.0;
+        }
+    };
+
+    struct Collapse
+    {
+        unsigned int from, to;
+        double       error;
+    };
+
+    uint64_t edge_key(const unsigned int a, const unsigned int b)
+    {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    /**
+     * 把 from 移到 to 的位置后，from 周围的三角形是否会翻转或退化
+     */
+    bool collapse_flips(const std::vector<VertexData>& vertices,
+                        const std::vector<unsigned int>& indices,
+                        const std::vector<unsigned int>& adjacency_offsets,
+                        const std::vector<unsigned int>& adjacency,
+                        const unsigned int from, const unsigned int to)
+    {
+        const auto& target = vertices[to].position;
+        for (auto i = adjacency_offsets[from]; i < adjacency_offsets[from + 1]; i++)
+        {
+            const auto triangle = adjacency[i];
+            const auto i0 = indices[triangle * 3 + 0];
+            const auto i1 = indices[triangle * 3 + 1];
+            const auto i2 = indices[triangle * 3 + 2];
+
+            // 同时包含 from 与 to 的三角形会被删除，不用检查
+            if (i0 == to || i1 == to || i2 == to)
+                continue;
+
+            const auto& p0 = vertices[i0].position;
+            const auto& p1 = vertices[i1].position;
+            const auto& p2 = vertices[i2].position;
+            const auto before = glm::cross(p1 - p0, p2 - p0);
+
+            const auto& q0 = i0 == from ? target : p0;
+            const auto& q1 = i1 == from ? target : p1;
+            const auto& q2 = i2 == from ? target : p2;
+            const auto after = glm::cross(q1 - q0, q2 - q0);
+
+            if (glm::dot(before, after) <= 0.0f)
+                return true;
+        }
+        return false;
+    }
+}
+
+std::vector<unsigned int> simplify_indices(const std::vector<VertexData>& vertices,
+                                           const std::vector<unsigned int>& indices,
+                                           const unsigned int target_index_count,
+                                           const float target_error,
+                                           float *result_error)
+{
+    const auto vertex_count = static_cast<unsigned int>(vertices.size());
+    std::vector<unsigned int> result = indices;
+    auto max_error = 0.0;
+
+    // 每个顶点的误差二次型
+    std::vector<Quadric> quadrics(vertex_count, Quadric {});
+    for (size_t i = 0, count = result.size() / 3; i < count; i++)
+    {
+        const auto& p0 = vertices[result[i * 3 + 0]].position;
+        const auto& p1 = vertices[result[i * 3 + 1]].position;
+        const auto& p2 = vertices[result[i * 3 + 2]].position;
+
+        glm::dvec3 normal = glm::cross(glm::dvec3(p1 - p0), glm::dvec3(p2 - p0));
+        const auto area = glm::length(normal);
+        if (area <= 0.0)
+            continue;
+
+        normal /= area;
+        const auto d = -glm::dot(normal, glm::dvec3(p0));
+        for (unsigned int j = 0; j < 3; j++)
+            quadrics[result[i * 3 + j]].add_plane(normal, d, area);
+    }
+
+    // 只被一个三角形使用的边是边界，端点锁定
+    std::unordered_map<uint64_t, unsigned int> edge_counts;
+    for (size_t i = 0, count = result.size() / 3; i < count; i++)
+    {
+        for (unsigned int j = 0; j < 3; j++)
+            edge_counts[edge_key(result[i * 3 + j], result[i * 3 + (j + 1) % 3])]++;
+    }
+
+    std::vector<bool> locked(vertex_count, false);
+    for (const auto& edge : edge_counts)
+    {
+        if (edge.second == 1)
+        {
+            locked[edge.first >> 32] = true;
+            locked[edge.first & 0xFFFFFFFF] = true;
+        }
+    }
+
+    const auto error_limit = static_cast<double>(target_error) * target_error;
+    std::vector<Collapse> collapses;
+    std::vector<unsigned int> adjacency_offsets, adjacency, remap(vertex_count);
+    std::vector<bool> touched(vertex_count);
+
+    // 每一轮按代价从小到大执行互不相邻的折叠，直到达到目标或误差上限
+    while (result.size() > target_index_count)
+    {
+        const auto triangle_count = static_cast<unsigned int>(result.size() / 3);
+
+        collapses.clear();
+        for (unsigned int i = 0; i < triangle_count; i++)
+        {
+            for (unsigned int j = 0; j < 3; j++)
+            {
+                const auto a = result[i * 3 + j];
+                const auto b = result[i * 3 + (j + 1) % 3];
+                // 内部边正反各出现一次，只处理一个方向；边界边两端都已锁定
+                if (a > b)
+                    continue;
+
+                auto merged = quadrics[a];
+                merged.add(quadrics[b]);
+                const auto error_a_to_b = locked[a] ? -1.0 : merged.error(vertices[b].position);
+                const auto error_b_to_a = locked[b] ? -1.0 : merged.error(vertices[a].position);
+
+                if (error_a_to_b >= 0.0 && (error_b_to_a < 0.0 || error_a_to_b <= error_b_to_a))
+                    collapses.push_back({ a, b, error_a_to_b });
+                else if (error_b_to_a >= 0.0)
+                    collapses.push_back({ b, a, error_b_to_a });
+            }
+        }
+
+        if (collapses.empty())
+            break;
+
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        // 顶点 -> 三角形
+        adjacency_offsets.assign(vertex_count + 1, 0);
+        for (const auto index : result)
+            adjacency_offsets[index + 1]++;
+        for (unsigned int i = 0; i < vertex_count; i++)
+            adjacency_offsets[i + 1] += adjacency_offsets[i];
+        adjacency.resize(result.size());
+        auto fill = adjacency_offsets;
+        for (unsigned int i = 0; i < triangle_count; i++)
+        {
+            for (unsigned int j = 0; j < 3; j++)
+                adjacency[fill[result[i * 3 + j]]++] = i;
+        }
+
+        for (unsigned int i = 0; i < vertex_count; i++)
+            remap[i] = i;
+        std::fill(touched.begin(), touched.end(), false);
+
+        // 每次内部折叠约删除两个三角形
+        auto remaining = triangle_count;
+        const auto target_triangles = target_index_count / 3;
+        auto applied = 0u;
+        auto reached_limit = false;
+        for (const auto& collapse : collapses)
+        {
+            if (collapse.error > error_limit)
+            {
+                reached_limit = true;
+                break;
+            }
+            if (remaining <= target_triangles)
+                break;
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+            if (collapse_flips(vertices, result, adjacency_offsets, adjacency, collapse.from, collapse.to))
+                continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            max_error = glm::max(max_error, collapse.error);
+
+            // 锁住 from 的一环邻域，保证同一轮中的翻转检查仍然有效
+            for (auto i = adjacency_offsets[collapse.from]; i < adjacency_offsets[collapse.from + 1]; i++)
+            {
+                const auto triangle = adjacency[i];
+                for (unsigned int j = 0; j < 3; j++)
+                    touched[result[triangle * 3 + j]] = true;
+            }
+
+            remaining = remaining > 2 ? remaining - 2 : 0;
+            applied++;
+        }
+
+        if (applied == 0)
+            break;
+
+        // 重映射并删除退化三角形
+        size_t write = 0;
+        for (size_t i = 0, count = result.size() / 3; i < count; i++)
+        {
+            const auto a = remap[result[i * 3 + 0]];
+            const auto b = remap[result[i * 3 + 1]];
+            const auto c = remap[result[i * 3 + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+
+        if (reached_limit)
+            break;
+    }
+
+    if (result_error)
+        *result_error = static_cast<float>(glm::sqrt(max_error));
+    return result;
+}
+
+void generate_lods(MeshData& mesh_data, const LodSettings& settings)
+{
+    weld_vertices(mesh_data);
+
+    const auto index_count = static_cast<unsigned int>(mesh_data.indices.size());
+
+    mesh_data.lods.clear();
+    mesh_data.lods.push_back({ 0, index_count, 0.0f });
+    if (index_count == 0)
+        return;
+
+    // 误差上限按包围球半径换算为绝对距离
+    auto min_position = mesh_data.vertices[0].position;
+    auto max_position = mesh_data.vertices[0].position;
+    for (const auto& vertex : mesh_data.vertices)
+    {
+        min_position = glm::min(min_position, vertex.position);
+        max_position = glm::max(max_position, vertex.position);
+    }
+    const auto radius = glm::length(max_position - min_position) * 0.5f;
+    const auto target_error = settings.max_error * radius;
+
+    const std::vector<unsigned int> source(mesh_data.indices);
+    auto previous_count = index_count;
+    for (const auto ratio : settings.triangle_ratios)
+    {
+        const auto target_count = static_cast<unsigned int>(index_count / 3 * ratio) * 3;
+
+        float error = 0.0f;
+        auto lod_indices = simplify_indices(mesh_data.vertices, source, target_count, target_error, &error);
+
+        // 误差上限内已简化不动，后续级别没有意义
+        const auto lod_count = static_cast<unsigned int>(lod_indices.size());
+        if (lod_count == 0 || lod_count > previous_count * 0.9f)
+            break;
+
+        optimize_vertex_cache(lod_indices, static_cast<unsigned int>(mesh_data.vertices.size()));
+
+        mesh_data.lods.push_back({ static_cast<unsigned int>(mesh_data.indices.size()), lod_count, error });
+        mesh_data.indices.insert(mesh_data.indices.end(), lod_indices.begin(), lod_indices.end());
+        previous_count = lod_count;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+struct MeshData;
+struct VertexData;
+
+/**
+ * LOD 生成参数
+ */
+struct LodSettings
+{
+    std::vector<float> triangle_ratios { 0.5f, 0.25f, 0.125f };    // 每级相对原网格的三角形比例
+    float max_error = 0.02f;                                        // 允许的最大误差，相对网格包围球半径
+};
+
+/**
+ * 二次误差度量（QEM）边折叠简化
+ *
+ * 只把顶点折叠到已有顶点上，结果仍引用原顶点缓冲，因此各级 LOD 可共用一份顶点数据。
+ * 边界与属性接缝上的顶点被锁定，不参与折叠。
+ * target_error 为模型空间的绝对距离，result_error 返回实际误差
+ */
+std::vector<unsigned int> simplify_indices(const std::vector<VertexData>& vertices,
+                                           const std::vector<unsigned int>& indices,
+                                           unsigned int target_index_count,
+                                           float target_error,
+                                           float *result_error = nullptr);
+
+// 生成 LOD 链，追加到 mesh_data.indices 之后并填写 mesh_data.lods，第 0 级为原网格
+void generate_lods(MeshData& mesh_data, const LodSettings& settings);
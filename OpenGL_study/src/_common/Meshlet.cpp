@@ -0,0 +1,173 @@
+#include "Meshlet.h"
+#include "Mesh.h"
+
+namespace
+{
+    void finish_meshlet(Meshlet& meshlet, const MeshData& mesh_data)
+    {
+        const auto& vertices = mesh_data.vertices;
+        const auto& indices = mesh_data.indices;
+        const auto first = meshlet.index_offset;
+        const auto last = meshlet.index_offset + meshlet.triangle_count * 3;
+
+        // 包围球：取包围盒中心
+        auto min_position = vertices[indices[first]].position;
+        auto max_position = min_position;
+        for (auto i = first; i < last; i++)
+        {
+            min_position = glm::min(min_position, vertices[indices[i]].position);
+            max_position = glm::max(max_position, vertices[indices[i]].position);
+        }
+
+        meshlet.center = (min_position + max_position) * 0.5f;
+        meshlet.radius = 0.0f;
+        for (auto i = first; i < last; i++)
+            meshlet.radius = glm::max(meshlet.radius, glm::length(vertices[indices[i]].position - meshlet.center));
+
+        // 法线锥轴取三角形法线的平均方向
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangle_count);
+        glm::vec3 axis(0.0f);
+        for (auto i = first; i < last; i += 3)
+        {
+            const auto& p0 = vertices[indices[i + 0]].position;
+            const auto& p1 = vertices[indices[i + 1]].position;
+            const auto& p2 = vertices[indices[i + 2]].position;
+            const auto normal = glm::cross(p1 - p0, p2 - p0);
+            const auto length = glm::length(normal);
+            if (length <= 0.0f)
+                continue;
+
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+
+        meshlet.cone_axis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.cone_apex = meshlet.center;
+        meshlet.cone_cutoff = 2.0f;
+
+        const auto axis_length = glm::length(axis);
+        if (normals.empty() || axis_length <= 0.0f)
+            return;
+        axis /= axis_length;
+
+        auto min_dot = 1.0f;
+        for (const auto& normal : normals)
+            min_dot = glm::min(min_dot, glm::dot(axis, normal));
+
+        // 法线张角超过约 84 度时锥体几乎不可能剔除，直接放弃
+        if (min_dot <= 0.1f)
+            return;
+
+        // 锥顶沿轴后退，保证从锥内看向任一三角形都在其背面
+        auto max_t = 0.0f;
+        auto n = 0;
+        for (auto i = first; i < last; i += 3)
+        {
+            const auto& p0 = vertices[indices[i]].position;
+            const auto& p1 = vertices[indices[i + 1]].position;
+            const auto& p2 = vertices[indices[i + 2]].position;
+            if (glm::length(glm::cross(p1 - p0, p2 - p0)) <= 0.0f)
+                continue;
+
+            const auto& normal = normals[n++];
+            const auto t = glm::dot(meshlet.center - p0, normal) / glm::dot(axis, normal);
+            max_t = glm::max(max_t, t);
+        }
+
+        meshlet.cone_axis = axis;
+        meshlet.cone_apex = meshlet.center - axis * max_t;
+        meshlet.cone_cutoff = glm::sqrt(1.0f - min_dot * min_dot);
+    }
+}
+
+Frustum::Frustum(const glm::mat4& matrix)
+{
+    const auto row0 = glm::vec4(matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0]);
+    const auto row1 = glm::vec4(matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1]);
+    const auto row2 = glm::vec4(matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2]);
+    const auto row3 = glm::vec4(matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]);
+
+    planes[0] = row3 + row0;    // 左
+    planes[1] = row3 - row0;    // 右
+    planes[2] = row3 + row1;    // 下
+    planes[3] = row3 - row1;    // 上
+    planes[4] = row3 + row2;    // 近
+    planes[5] = row3 - row2;    // 远
+
+    for (auto& plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+bool Frustum::intersects_sphere(const glm::vec3& center, const float radius) const
+{
+    for (const auto& plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+std::vector<Meshlet> build_meshlets(const MeshData& mesh_data)
+{
+    std::vector<Meshlet> meshlets;
+
+    const auto index_count = mesh_data.lods.empty()
+                           ? static_cast<unsigned int>(mesh_data.indices.size())
+                           : mesh_data.lods[0].index_count;
+    if (index_count == 0)
+        return meshlets;
+
+    // 记录顶点最后一次被加入的簇编号，避免每簇清空查找表
+    std::vector<unsigned int> vertex_meshlet(mesh_data.vertices.size(), ~0u);
+    const auto& indices = mesh_data.indices;
+
+    Meshlet meshlet {};
+    unsigned int vertex_count = 0;
+    for (unsigned int i = 0; i < index_count; i += 3)
+    {
+        const auto id = static_cast<unsigned int>(meshlets.size());
+        unsigned int new_vertices = 0;
+        for (unsigned int j = 0; j < 3; j++)
+            new_vertices += vertex_meshlet[indices[i + j]] != id ? 1 : 0;
+
+        if (vertex_count + new_vertices > MESHLET_MAX_VERTICES || meshlet.triangle_count == MESHLET_MAX_TRIANGLES)
+        {
+            finish_meshlet(meshlet, mesh_data);
+            meshlets.push_back(meshlet);
+
+            meshlet = Meshlet {};
+            meshlet.index_offset = i;
+            vertex_count = 0;
+            i -= 3;
+            continue;
+        }
+
+        for (unsigned int j = 0; j < 3; j++)
+        {
+            if (vertex_meshlet[indices[i + j]] != id)
+            {
+                vertex_meshlet[indices[i + j]] = id;
+                vertex_count++;
+            }
+        }
+        meshlet.triangle_count++;
+    }
+
+    if (meshlet.triangle_count > 0)
+    {
+        finish_meshlet(meshlet, mesh_data);
+        meshlets.push_back(meshlet);
+    }
+
+    return meshlets;
+}
+
+bool is_meshlet_visible(const Meshlet& meshlet, const Frustum& frustum, const glm::vec3& camera_position)
+{
+    if (!frustum.intersects_sphere(meshlet.center, meshlet.radius))
+        return false;
+
+    return glm::dot(glm::normalize(meshlet.cone_apex - camera_position), meshlet.cone_axis) < meshlet.cone_cutoff;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "MOS_glm.h"
+
+struct MeshData;
+
+const unsigned int MESHLET_MAX_VERTICES  = 64;
+const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+/**
+ * 网格簇：索引缓冲中一段连续的三角形，带包围球与法线锥，用于 CPU 端整簇剔除
+ * 直接写入网格缓存，修改布局时需提升 MESH_CACHE_VERSION
+ */
+struct Meshlet
+{
+    unsigned int index_offset;      // 在索引缓冲中的起始位置
+    unsigned int triangle_count;
+
+    glm::vec3    center;            // 包围球（模型空间）
+    float        radius;
+
+    glm::vec3    cone_apex;         // 法线锥，视线方向落在锥内时整簇背向相机
+    glm::vec3    cone_axis;
+    float        cone_cutoff;       // 大于 1 表示不能做背面剔除
+};
+
+/**
+ * 模型空间的视锥体平面，由 proj * view * model 提取
+ */
+struct Frustum
+{
+    glm::vec4 planes[6];            // xyz 为朝内的单位法线，w 为距离
+
+    explicit Frustum(const glm::mat4& matrix);
+
+    bool intersects_sphere(const glm::vec3& center, float radius) const;
+};
+
+// 按现有三角形顺序贪心分簇，每簇不超过 MESHLET_MAX_VERTICES 个顶点与 MESHLET_MAX_TRIANGLES 个三角形
+// 只处理第 0 级 LOD 的索引，簇内三角形顺序不变
+std::vector<Meshlet> build_meshlets(const MeshData& mesh_data);
+
+// 簇是否可见：在视锥内且不整簇背向相机，camera_position 为模型空间坐标
+bool is_meshlet_visible(const Meshlet& meshlet, const Frustum& frustum, const glm::vec3& camera_position);
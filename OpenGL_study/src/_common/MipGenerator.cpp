@@ -0,0 +1,363 @@
+#include "MipGenerator.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MIP_GENERATOR_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+
+    // 单个像素 4 个 float 通道，SSE2 下为一个 __m128
+    struct Pixel4
+    {
+#ifdef MIP_GENERATOR_SSE2
+        __m128 value;
+
+        static Pixel4 zero() { return { _mm_setzero_ps() }; }
+        static Pixel4 load(const float *source) { return { _mm_loadu_ps(source) }; }
+        void store(float *target) const { _mm_storeu_ps(target, value); }
+        void add_scaled(const Pixel4& other, const float weight) { value = _mm_add_ps(value, _mm_mul_ps(other.value, _mm_set1_ps(weight))); }
+#else
+        float value[4];
+
+        static Pixel4 zero() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+        static Pixel4 load(const float *source) { Pixel4 pixel; std::memcpy(pixel.value, source, sizeof(pixel.value)); return pixel; }
+        void store(float *target) const { std::memcpy(target, value, sizeof(value)); }
+        void add_scaled(const Pixel4& other, const float weight) { for (auto i = 0; i < 4; i++) value[i] += other.value[i] * weight; }
+#endif
+    };
+
+    // 2 倍降采样的可分离滤波核，第 i 个输出像素取源像素 2i + offset
+    struct FilterKernel
+    {
+        int   first_offset;
+        int   tap_count;
+        float weights[8];
+    };
+
+    double bessel_i0(const double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (auto k = 1; k < 32; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    FilterKernel make_kernel(const MipFilter filter)
+    {
+        FilterKernel kernel {};
+        if (filter == MIP_FILTER_BOX)
+        {
+            kernel.first_offset = 0;
+            kernel.tap_count = 2;
+            kernel.weights[0] = kernel.weights[1] = 0.5f;
+            return kernel;
+        }
+
+        // 输出像素中心位于源像素 2i + 0.5，支撑半径 3 个源像素
+        const auto alpha = 4.0;
+        const auto radius = 3.0;
+        kernel.first_offset = -2;
+        kernel.tap_count = 6;
+
+        double weights[6], sum = 0.0;
+        for (auto i = 0; i < kernel.tap_count; i++)
+        {
+            const auto distance = std::fabs(kernel.first_offset + i - 0.5);
+            const auto x = distance / 2.0;
+            const auto sinc = x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+            const auto ratio = distance / radius;
+            const auto window = bessel_i0(alpha * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / bessel_i0(alpha);
+            weights[i] = sinc * window;
+            sum += weights[i];
+        }
+        for (auto i = 0; i < kernel.tap_count; i++)
+            kernel.weights[i] = static_cast<float>(weights[i] / sum);
+        return kernel;
+    }
+
+    struct SrgbTables
+    {
+        float         to_linear[256];
+        unsigned char to_srgb[4096];
+
+        SrgbTables()
+        {
+            for (auto i = 0; i < 256; i++)
+            {
+                const auto value = i / 255.0;
+                to_linear[i] = static_cast<float>(value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4));
+            }
+            for (auto i = 0; i < 4096; i++)
+            {
+                const auto value = i / 4095.0;
+                const auto encoded = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+                to_srgb[i] = static_cast<unsigned char>(std::lround(std::min(std::max(encoded, 0.0), 1.0) * 255.0));
+            }
+        }
+    };
+
+    const SrgbTables& get_srgb_tables()
+    {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    // 把 [0, count) 切分给线程池，没有线程池时直接在当前线程执行
+    template <typename F>
+    void parallel_for(ThreadPool *thread_pool, const unsigned int count, const F& func)
+    {
+        if (thread_pool == nullptr || count < 64)
+        {
+            func(0u, count);
+            return;
+        }
+
+        const auto group_count = std::min(count / 16, thread_pool->get_thread_count() * 4);
+        const auto group_size = (count + group_count - 1) / group_count;
+        std::vector<std::future<void>> tasks;
+        for (auto begin = 0u; begin < count; begin += group_size)
+        {
+            const auto end = std::min(count, begin + group_size);
+            tasks.push_back(thread_pool->submit([&func, begin, end]() { func(begin, end); }));
+        }
+        for (auto& task : tasks)
+            task.get();
+    }
+
+    // 8 位 RGBA 盒式滤波，SSE2 下一次输出两个像素
+    void box_rgba8_rows(const unsigned char *source, const unsigned int width, const unsigned int height,
+                        unsigned char *target, const unsigned int target_width,
+                        const unsigned int first_row, const unsigned int last_row)
+    {
+        for (auto y = first_row; y < last_row; y++)
+        {
+            const auto row0 = source + static_cast<size_t>(std::min(y * 2, height - 1)) * width * 4;
+            const auto row1 = source + static_cast<size_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+            auto output = target + static_cast<size_t>(y) * target_width * 4;
+
+            auto x = 0u;
+#ifdef MIP_GENERATOR_SSE2
+            if (width >= 2)
+            {
+                const auto zero = _mm_setzero_si128();
+                const auto rounding = _mm_set1_epi16(2);
+                for (; x + 2 <= target_width && x * 2 + 4 <= width; x += 2)
+                {
+                    // 两行各 4 个源像素
+                    const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                    const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                    const auto low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    const auto high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                    // 相邻两个像素求和
+                    const auto sum_low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+                    const auto sum_high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+                    const auto sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sum_low, sum_high), rounding), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(sum, zero));
+                }
+            }
+#endif
+            for (; x < target_width; x++)
+            {
+                const auto x0 = std::min(x * 2, width - 1) * 4;
+                const auto x1 = std::min(x * 2 + 1, width - 1) * 4;
+                for (auto k = 0; k < 4; k++)
+                    output[x * 4 + k] = static_cast<unsigned char>((row0[x0 + k] + row0[x1 + k] + row1[x0 + k] + row1[x1 + k] + 2) / 4);
+            }
+        }
+    }
+
+    // 一级可分离滤波：先水平后垂直
+    void filter_level(const std::vector<float>& source, const unsigned int width, const unsigned int height,
+                      std::vector<float>& target, const unsigned int target_width, const unsigned int target_height,
+                      const FilterKernel& kernel, ThreadPool *thread_pool)
+    {
+        std::vector<float> horizontal(static_cast<size_t>(target_width) * height * 4);
+        parallel_for(thread_pool, height, [&](const unsigned int first_row, const unsigned int last_row)
+        {
+            for (auto y = first_row; y < last_row; y++)
+            {
+                const auto row = source.data() + static_cast<size_t>(y) * width * 4;
+                auto output = horizontal.data() + static_cast<size_t>(y) * target_width * 4;
+                for (auto x = 0u; x < target_width; x++)
+                {
+                    const auto first = static_cast<int>(x * 2) + kernel.first_offset;
+                    auto sum = Pixel4::zero();
+                    if (first >= 0 && first + kernel.tap_count <= static_cast<int>(width))
+                    {
+                        // 内部像素不需要钳制
+                        const auto taps = row + first * 4;
+                        for (auto i = 0; i < kernel.tap_count; i++)
+                            sum.add_scaled(Pixel4::load(taps + i * 4), kernel.weights[i]);
+                    }
+                    else
+                    {
+                        for (auto i = 0; i < kernel.tap_count; i++)
+                        {
+                            const auto sx = std::min(std::max(first + i, 0), static_cast<int>(width) - 1);
+                            sum.add_scaled(Pixel4::load(row + sx * 4), kernel.weights[i]);
+                        }
+                    }
+                    sum.store(output + x * 4);
+                }
+            }
+        });
+
+        target.resize(static_cast<size_t>(target_width) * target_height * 4);
+        parallel_for(thread_pool, target_height, [&](const unsigned int first_row, const unsigned int last_row)
+        {
+            const auto row_size = static_cast<size_t>(target_width) * 4;
+            for (auto y = first_row; y < last_row; y++)
+            {
+                const float *rows[8];
+                for (auto i = 0; i < kernel.tap_count; i++)
+                {
+                    const auto sy = std::min(std::max(static_cast<int>(y * 2) + kernel.first_offset + i, 0), static_cast<int>(height) - 1);
+                    rows[i] = horizontal.data() + sy * row_size;
+                }
+
+                auto output = target.data() + y * row_size;
+                for (auto x = 0u; x < target_width; x++)
+                {
+                    auto sum = Pixel4::zero();
+                    for (auto i = 0; i < kernel.tap_count; i++)
+                        sum.add_scaled(Pixel4::load(rows[i] + x * 4), kernel.weights[i]);
+                    sum.store(output + x * 4);
+                }
+            }
+        });
+    }
+
+    // 颜色通道数：灰度图只有第 0 个分量，RGB(A) 为前 3 个
+    int get_color_channels(const int channels)
+    {
+        return channels >= 3 ? 3 : 1;
+    }
+
+    // 按行转换，width 个像素一行
+    void to_float(const unsigned char *pixels, const unsigned int width, const unsigned int height, const int channels,
+                  const bool srgb, std::vector<float>& result, ThreadPool *thread_pool)
+    {
+        const auto& tables = get_srgb_tables();
+        const auto color_channels = srgb ? get_color_channels(channels) : 0;
+
+        // 线性通道也查表，省去除法
+        float lookup[4][256];
+        for (auto k = 0; k < 4; k++)
+        {
+            for (auto v = 0; v < 256; v++)
+                lookup[k][v] = k < color_channels ? tables.to_linear[v] : v / 255.0f;
+        }
+
+        result.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+        parallel_for(thread_pool, height, [&](const unsigned int first_row, const unsigned int last_row)
+        {
+            for (auto i = static_cast<size_t>(first_row) * width, end = static_cast<size_t>(last_row) * width; i < end; i++)
+            {
+                for (auto k = 0; k < channels; k++)
+                    result[i * 4 + k] = lookup[k][pixels[i * channels + k]];
+            }
+        });
+    }
+
+    void to_bytes(const std::vector<float>& values, const unsigned int width, const unsigned int height, const int channels,
+                  const bool srgb, unsigned char *pixels, ThreadPool *thread_pool)
+    {
+        const auto& tables = get_srgb_tables();
+        const auto color_channels = srgb ? get_color_channels(channels) : 0;
+
+        parallel_for(thread_pool, height, [&](const unsigned int first_row, const unsigned int last_row)
+        {
+            for (auto i = static_cast<size_t>(first_row) * width, end = static_cast<size_t>(last_row) * width; i < end; i++)
+            {
+                for (auto k = 0; k < channels; k++)
+                {
+                    // Kaiser 核有负瓣，结果可能越界
+                    const auto value = std::min(std::max(values[i * 4 + k], 0.0f), 1.0f);
+                    pixels[i * channels + k] = k < color_channels
+                        ? tables.to_srgb[static_cast<int>(value * 4095.0f + 0.5f)]
+                        : static_cast<unsigned char>(value * 255.0f + 0.5f);
+                }
+            }
+        });
+    }
+}
+
+MipChain generate_mip_chain(const unsigned char *pixels, const int width, const int height, const int channels,
+                            const MipSettings& settings, ThreadPool *thread_pool)
+{
+    MipChain chain;
+    if (!settings.enabled || pixels == nullptr || width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return chain;
+
+    chain.channels = channels;
+
+    auto level_width = static_cast<unsigned int>(width);
+    auto level_height = static_cast<unsigned int>(height);
+    size_t total_size = 0;
+    while (level_width > 1 || level_height > 1)
+    {
+        level_width = std::max(1u, level_width / 2);
+        level_height = std::max(1u, level_height / 2);
+        chain.levels.push_back({ level_width, level_height, total_size });
+        total_size += static_cast<size_t>(level_width) * level_height * channels;
+    }
+    chain.data.resize(total_size);
+    if (chain.levels.empty())
+        return chain;
+
+    // 8 位 RGBA 盒式滤波走整数快速路径，逐级从上一级结果降采样
+    if (settings.filter == MIP_FILTER_BOX && !settings.srgb && channels == 4)
+    {
+        auto source = pixels;
+        auto source_width = static_cast<unsigned int>(width), source_height = static_cast<unsigned int>(height);
+        for (const auto& level : chain.levels)
+        {
+            const auto target = chain.data.data() + level.offset;
+            parallel_for(thread_pool, level.height, [&](const unsigned int first_row, const unsigned int last_row)
+            {
+                box_rgba8_rows(source, source_width, source_height, target, level.width, first_row, last_row);
+            });
+
+            source = target;
+            source_width = level.width;
+            source_height = level.height;
+        }
+        return chain;
+    }
+
+    // 其余情况在 float 中逐级滤波，避免每级重复量化
+    const auto kernel = make_kernel(settings.filter);
+    std::vector<float> current, next;
+    to_float(pixels, width, height, channels, settings.srgb, current, thread_pool);
+
+    auto source_width = static_cast<unsigned int>(width), source_height = static_cast<unsigned int>(height);
+    for (const auto& level : chain.levels)
+    {
+        filter_level(current, source_width, source_height, next, level.width, level.height, kernel, thread_pool);
+        to_bytes(next, level.width, level.height, channels, settings.srgb, chain.data.data() + level.offset, thread_pool);
+
+        std::swap(current, next);
+        source_width = level.width;
+        source_height = level.height;
+    }
+
+    return chain;
+}
+
+const char* get_mip_filter_name(const MipFilter filter)
+{
+    return filter == MIP_FILTER_KAISER ? "kaiser" : "box";
+}
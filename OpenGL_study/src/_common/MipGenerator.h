@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+enum MipFilter
+{
+    MIP_FILTER_BOX,         // 2x2 平均，与 glGenerateMipmap 等价
+    MIP_FILTER_KAISER,      // 6 抽头 Kaiser 窗 sinc，更锐利，远处纹理不易发糊
+};
+
+/**
+ * mip 生成参数
+ */
+struct MipSettings
+{
+    bool      enabled = true;       // 为假时不生成，只使用原图
+    MipFilter filter = MIP_FILTER_BOX;
+    bool      srgb   = false;       // 颜色通道按 sRGB 编码，在线性空间滤波（alpha 不参与转换）
+};
+
+/**
+ * 第 1 级起的全部 mip 级别（不含原图），各级紧密排列，通道数与原图相同
+ */
+struct MipChain
+{
+    struct Level
+    {
+        unsigned int width;
+        unsigned int height;
+        size_t       offset;    // 在 data 中的偏移
+    };
+
+    int                        channels = 0;
+    std::vector<Level>         levels;
+    std::vector<unsigned char> data;
+
+    inline bool empty() const { return levels.empty(); }
+    inline const unsigned char* get_level_data(const size_t level) const { return data.data() + levels[level].offset; }
+};
+
+// 生成完整 mip 链直到 1x1
+// thread_pool 非空时每级按行分给线程池并行，调用线程等待完成，不要在线程池工作线程中传入线程池
+MipChain generate_mip_chain(const unsigned char *pixels, int width, int height, int channels,
+                            const MipSettings& settings = MipSettings(), ThreadPool *thread_pool = nullptr);
+
+const char* get_mip_filter_name(MipFilter filter);
@@ -1,49 +1,650 @@
 #include "Model.h"
+#include "AssetPack.h"
+#include "Camera.h"
+#include "DrawBatch.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
+#include "UploadQueue.h"
 
-Model::Model(const std::string& path, const bool& gamma)
-    : path_(path), gamma_correction_(gamma)
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <unordered_set>
+
+namespace
+{
+    // 材质纹理类型及其在着色器中的名称，按此顺序加载
+    const struct
+    {
+        aiTextureType type;
+        const char   *type_name;
+    } MATERIAL_TEXTURE_TYPES[] = {
+        { aiTextureType_DIFFUSE,  "texture_diffuse"  },
+        { aiTextureType_SPECULAR, "texture_specular" },
+        { aiTextureType_HEIGHT,   "texture_normal"   },
+        { aiTextureType_AMBIENT,  "texture_height"   },
+    };
+
+    // 会改变导入结果的加载选项，不同组合分别缓存
+    const unsigned int MODEL_CACHED_LOAD_FLAGS = MODEL_LOAD_OPTIMIZE | MODEL_LOAD_LOD | MODEL_LOAD_MESHLETS;
+
+    std::string get_cache_path(const std::string& path, const unsigned int load_flags)
+    {
+        const auto cached_flags = load_flags & MODEL_CACHED_LOAD_FLAGS;
+        if (cached_flags == 0)
+            return path + ".meshcache";
+        return path + "." + std::to_string(cached_flags) + ".meshcache";
+    }
+
+    // .obj 中 mtllib 引用的材质库路径（相对模型所在目录），其他格式返回空
+    std::vector<std::string> find_material_libraries(const std::string& path)
+    {
+        std::vector<std::string> libraries;
+        const auto dot = path.find_last_of('.');
+        if (dot == std::string::npos || (path.compare(dot, std::string::npos, ".obj") != 0
+                                      && path.compare(dot, std::string::npos, ".OBJ") != 0))
+            return libraries;
+
+        std::string text;
+        const auto asset = AssetPack::read(path);
+        if (asset.is_valid())
+        {
+            text.assign(reinterpret_cast<const char*>(asset.data), asset.size);
+        }
+        else
+        {
+            const MappedFile file(path);
+            if (!file.is_valid())
+                return libraries;
+            text.assign(reinterpret_cast<const char*>(file.get_data()), file.get_size());
+        }
+
+        const auto slash = path.find_last_of("/\\");
+        const auto directory = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::istringstream tokens(line);
+            std::string keyword;
+            if (!(tokens >> keyword) || keyword != "mtllib")
+                continue;
+
+            std::string library;
+            while (tokens >> library)
+                libraries.push_back(directory + library);
+        }
+        return libraries;
+    }
+
+    // 源文件及其材质库的哈希混入加载选项作为缓存键，源文件不存在时返回 0
+    uint64_t get_cache_key(const std::string& path, const unsigned int load_flags, const LodSettings& lod_settings)
+    {
+        auto key = MeshCache::hash_file(path);
+        if (key == 0)
+            return key;
+
+        // 材质库决定纹理路径，改动 .mtl 也要让缓存失效；缺失的库按名字计入，补上后同样失效
+        for (const auto& library : find_material_libraries(path))
+        {
+            const auto library_hash = MeshCache::hash_file(library);
+            key = MeshCache::hash_bytes(library.data(), library.size(), key);
+            key = MeshCache::hash_bytes(&library_hash, sizeof(library_hash), key);
+        }
+
+        const auto cached_flags = load_flags & MODEL_CACHED_LOAD_FLAGS;
+        if (cached_flags == 0)
+            return key;
+
+        key = MeshCache::hash_bytes(&cached_flags, sizeof(cached_flags), key);
+        if (load_flags & MODEL_LOAD_LOD)
+        {
+            const auto& ratios = lod_settings.triangle_ratios;
+            key = MeshCache::hash_bytes(ratios.data(), ratios.size() * sizeof(float), key);
+            key = MeshCache::hash_bytes(&lod_settings.max_error, sizeof(float), key);
+        }
+        return key;
+    }
+
+    VertexFormat get_vertex_format(const unsigned int load_flags)
+    {
+        return load_flags & MODEL_LOAD_PACKED_VERTICES ? VERTEX_FORMAT_PACKED : VERTEX_FORMAT_FULL;
+    }
+
+    // 资源包条目的只读流，直接读取映射内存
+    class AssetPackIOStream : public Assimp::IOStream
+    {
+    private:
+        AssetView view_;
+        size_t    position_;
+
+    public:
+        explicit AssetPackIOStream(const AssetView& view)
+            : view_(view), position_(0)
+        {
+        }
+
+        size_t Read(void *buffer, const size_t size, const size_t count) override
+        {
+            if (size == 0 || count == 0)
+                return 0;
+
+            const auto read_count = std::min(count, (view_.size - position_) / size);
+            std::memcpy(buffer, view_.data + position_, read_count * size);
+            position_ += read_count * size;
+            return read_count;
+        }
+
+        size_t Write(const void*, size_t, size_t) override
+        {
+            return 0;
+        }
+
+        aiReturn Seek(const size_t offset, const aiOrigin origin) override
+        {
+            const auto base = origin == aiOrigin_SET ? 0 : origin == aiOrigin_CUR ? position_ : view_.size;
+            if (base + offset > view_.size)
+                return aiReturn_FAILURE;
+
+            position_ = base + offset;
+            return aiReturn_SUCCESS;
+        }
+
+        size_t Tell() const override { return position_; }
+        size_t FileSize() const override { return view_.size; }
+        void Flush() override {}
+    };
+
+    // 优先从资源包读取（如 .obj 引用的 .mtl），包中没有的文件交给默认实现
+    class AssetPackIOSystem : public Assimp::IOSystem
+    {
+    private:
+        Assimp::DefaultIOSystem file_system_;
+
+    public:
+        bool Exists(const char *file) const override
+        {
+            return AssetPack::exists(file) || file_system_.Exists(file);
+        }
+
+        char getOsSeparator() const override
+        {
+            return '/';
+        }
+
+        Assimp::IOStream* Open(const char *file, const char *mode) override
+        {
+            const auto asset = std::strchr(mode, 'w') == nullptr ? AssetPack::read(file) : AssetView();
+            if (asset.is_valid())
+                return new AssetPackIOStream(asset);
+            return file_system_.Open(file, mode);
+        }
+
+        void Close(Assimp::IOStream *stream) override
+        {
+            if (dynamic_cast<AssetPackIOStream*>(stream) != nullptr)
+                delete stream;
+            else
+                file_system_.Close(stream);
+        }
+    };
+}
+
+Model::Model(const std::string& path, const bool& gamma,
+             const unsigned int load_flags, const LodSettings& lod_settings)
+    : path_(path), gamma_correction_(gamma), load_flags_(load_flags),
+      lod_settings_(lod_settings), lod_pixel_error_(1.0f),
+      drawn_triangle_count_(0), culled_meshlet_count_(0),
+      handle_(std::make_shared<Model*>(this)), importing_(false), pending_textures_(0)
 {
     load_model(path);
 }
 
-Model::~Model() = default;
+Model::~Model()
+{
+    // 令尚未执行的后台任务失效
+    handle_.reset();
+
+    for (auto& mesh : meshes_)
+        mesh.release();
+}
 
 void Model::draw(const Renderer& renderer, Shader& shader)
 {
+    drawn_triangle_count_ = 0;
+    culled_meshlet_count_ = 0;
     for (auto& mesh : meshes_)
+    {
         mesh.draw(renderer, shader);
+        drawn_triangle_count_ += mesh.get_lods()[0].index_count / 3;
+    }
+}
+
+void Model::draw_instanced(const Renderer& renderer, Shader& shader,
+                           const InstanceBuffer& instance_buffer, const unsigned int instance_count)
+{
+    drawn_triangle_count_ = 0;
+    culled_meshlet_count_ = 0;
+    for (auto& mesh : meshes_)
+    {
+        mesh.draw_instanced(renderer, shader, instance_buffer, instance_count);
+        drawn_triangle_count_ += mesh.get_lods()[0].index_count / 3 * instance_count;
+    }
+}
+
+void Model::submit(RenderQueue& queue, Shader& shader, const glm::mat4& model_mat)
+{
+    drawn_triangle_count_ = 0;
+    culled_meshlet_count_ = 0;
+    for (auto& mesh : meshes_)
+    {
+        mesh.submit(queue, shader, model_mat);
+        drawn_triangle_count_ += mesh.get_lods()[0].index_count / 3;
+    }
+}
+
+void Model::submit(DrawBatch& batch, const glm::mat4& model_mat, const glm::vec4& color)
+{
+    drawn_triangle_count_ = 0;
+    culled_meshlet_count_ = 0;
+    const auto instance = batch.add_instance(model_mat, color);
+    for (auto& mesh : meshes_)
+    {
+        mesh.submit(batch, instance);
+        drawn_triangle_count_ += mesh.get_lods()[0].index_count / 3;
+    }
+}
+
+void Model::draw(const Renderer& renderer, Shader& shader, const Camera& camera, const glm::mat4& model_mat)
+{
+    draw_lod(renderer, shader, camera, model_mat, nullptr);
+}
+
+void Model::draw(const Renderer& renderer, Shader& shader, const Camera& camera,
+                 const glm::mat4& proj_mat, const glm::mat4& model_mat)
+{
+    // 视锥平面与相机位置都变换到模型空间，簇数据无需逐帧变换
+    const Frustum frustum(proj_mat * camera.get_view_matrix() * model_mat);
+    draw_lod(renderer, shader, camera, model_mat, &frustum);
+}
+
+void Model::draw_lod(const Renderer& renderer, Shader& shader, const Camera& camera,
+                     const glm::mat4& model_mat, const Frustum *frustum)
+{
+    GLint viewport[4];
+    GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+
+    // 距离为 1 处每单位长度对应的像素数
+    const auto pixels_per_unit = viewport[3] * 0.5f / glm::tan(glm::radians(camera.get_zoom()) * 0.5f);
+
+    // 非均匀缩放取最大轴，误差只会被高估
+    const auto scale = glm::max(glm::length(glm::vec3(model_mat[0])),
+                                glm::max(glm::length(glm::vec3(model_mat[1])),
+                                         glm::length(glm::vec3(model_mat[2]))));
+
+    const auto camera_position = glm::vec3(glm::inverse(model_mat) * glm::vec4(camera.get_position(), 1.0f));
+
+    drawn_triangle_count_ = 0;
+    culled_meshlet_count_ = 0;
+    for (auto& mesh : meshes_)
+    {
+        const auto& lods = mesh.get_lods();
+        const auto center = glm::vec3(model_mat * glm::vec4(mesh.get_bounds_center(), 1.0f));
+        const auto distance = glm::length(center - camera.get_position()) - mesh.get_bounds_radius() * scale;
+
+        // 选投影误差不超过阈值的最粗一级，相机在包围球内时用原网格
+        unsigned int lod = 0;
+        if (distance > 0.0f)
+        {
+            while (lod + 1 < lods.size()
+                   && lods[lod + 1].error * scale * pixels_per_unit / distance <= lod_pixel_error_)
+                lod++;
+        }
+
+        if (lod == 0 && frustum != nullptr)
+        {
+            drawn_triangle_count_ += mesh.draw_culled(renderer, shader, *frustum, camera_position) / 3;
+            culled_meshlet_count_ += mesh.get_culled_meshlet_count();
+            continue;
+        }
+
+        mesh.draw(renderer, shader, lod);
+        drawn_triangle_count_ += lods[lod].index_count / 3;
+    }
+}
+
+unsigned int Model::get_vertex_buffer_size() const
+{
+    unsigned int size = 0;
+    for (const auto& mesh : meshes_)
+        size += mesh.get_vertex_buffer_size();
+    return size;
+}
+
+unsigned int Model::get_index_buffer_size() const
+{
+    unsigned int size = 0;
+    for (const auto& mesh : meshes_)
+        size += mesh.get_index_buffer_size();
+    return size;
 }
 
 void Model::load_model(const std::string& path)
+{
+    directory_ = path.substr(0, path.find_last_of('/'));
+
+    if (load_flags_ & MODEL_LOAD_ASYNC)
+    {
+        load_model_async();
+        return;
+    }
+
+    // 缓存有效时跳过 Assimp 导入
+    const auto cache_path = get_cache_path(path, load_flags_);
+    const auto source_hash = get_cache_key(path, load_flags_, lod_settings_);
+    if (source_hash != 0 && load_from_cache(cache_path, source_hash))
+        return;
+
+    std::vector<MeshData> mesh_datas;
+    if (!import_meshes(path, load_flags_, lod_settings_, mesh_datas))
+        return;
+
+    // 先并行解码全部材质纹理，创建网格时即可直接命中
+    std::vector<TextureData> texture_requests;
+    for (const auto& mesh_data : mesh_datas)
+        texture_requests.insert(texture_requests.end(), mesh_data.textures.begin(), mesh_data.textures.end());
+    const auto preloaded_textures = preload_textures(texture_requests);
+
+    if (source_hash != 0 && !MeshCache::write(cache_path, source_hash, MODEL_IMPORT_FLAGS, mesh_datas))
+        std::cout << "[WARNING] Model: failed to write mesh cache " << cache_path << std::endl;
+
+    meshes_.reserve(mesh_datas.size());
+    for (auto& mesh_data : mesh_datas)
+    {
+        for (auto& texture_data : mesh_data.textures)
+            texture_data = load_texture(texture_data.path, texture_data.type);
+
+        meshes_.emplace_back(std::move(mesh_data.vertices),
+                             std::move(mesh_data.indices),
+                             std::move(mesh_data.textures),
+                             get_vertex_format(load_flags_));
+        meshes_.back().set_lods(std::move(mesh_data.lods));
+        meshes_.back().set_meshlets(std::move(mesh_data.meshlets), meshes_.back().get_indices().data());
+    }
+}
+
+void Model::load_model_async()
+{
+    importing_ = true;
+
+    // 工作线程只解析与解码，所有 OpenGL 调用都经由 UploadQueue 回到上下文线程
+    std::weak_ptr<Model*> handle = handle_;
+    const auto path = path_;
+    const auto load_flags = load_flags_;
+    const auto lod_settings = lod_settings_;
+    ThreadPool::get_instance().submit([handle, path, load_flags, lod_settings]()
+    {
+        const auto cancelled = [handle]() { return handle.expired(); };
+        if (cancelled())
+            return;
+
+        auto& upload_queue = UploadQueue::get_instance();
+        std::vector<TextureData> texture_requests;
+
+        const auto cache_path = get_cache_path(path, load_flags);
+        const auto source_hash = get_cache_key(path, load_flags, lod_settings);
+        const auto cache = std::make_shared<MeshCache>(cache_path);
+        if (source_hash != 0 && cache->open(source_hash, MODEL_IMPORT_FLAGS))
+        {
+            for (unsigned int i = 0, count = cache->get_mesh_count(); i < count; i++)
+            {
+                const auto view = std::make_shared<MeshCacheView>(cache->get_mesh(i));
+                texture_requests.insert(texture_requests.end(), view->textures.begin(), view->textures.end());
+
+                // 任务持有 cache，映射内存在上传完成前一直有效
+                upload_queue.push([handle, cache, view]()
+                {
+                    const auto self = handle.lock();
+                    if (self)
+                        (*self)->add_mesh(view->vertices, view->vertex_count,
+                                          view->indices,  view->index_count,
+                                          view->textures, view->lods, view->meshlets);
+                }, cancelled);
+            }
+        }
+        else
+        {
+            std::vector<MeshData> mesh_datas;
+            if (import_meshes(path, load_flags, lod_settings, mesh_datas)
+                && source_hash != 0
+                && !MeshCache::write(cache_path, source_hash, MODEL_IMPORT_FLAGS, mesh_datas))
+                std::cout << "[WARNING] Model: failed to write mesh cache " << cache_path << std::endl;
+
+            for (auto& mesh_data : mesh_datas)
+            {
+                const auto data = std::make_shared<MeshData>(std::move(mesh_data));
+                texture_requests.insert(texture_requests.end(), data->textures.begin(), data->textures.end());
+
+                upload_queue.push([handle, data]()
+                {
+                    const auto self = handle.lock();
+                    if (self)
+                        (*self)->add_mesh(data->vertices.data(), data->vertices.size(),
+                                          data->indices.data(),  data->indices.size(),
+                                          data->textures, data->lods, data->meshlets);
+                }, cancelled);
+            }
+        }
+
+        // 几何体先入队，模型先以占位纹理显示，再逐个请求纹理
+        std::unordered_set<std::string> seen;
+        for (const auto& request : texture_requests)
+        {
+            if (!seen.insert(request.path).second)
+                continue;
+
+            const auto texture_path = request.path;
+            upload_queue.push([handle, texture_path]()
+            {
+                const auto self = handle.lock();
+                if (self)
+                    (*self)->stream_texture(texture_path);
+            }, cancelled);
+        }
+
+        upload_queue.push([handle]()
+        {
+            const auto self = handle.lock();
+            if (self)
+                (*self)->importing_ = false;
+        }, cancelled);
+    });
+}
+
+bool Model::load_from_cache(const std::string& cache_path, const uint64_t source_hash)
+{
+    MeshCache cache(cache_path);
+    if (!cache.open(source_hash, MODEL_IMPORT_FLAGS))
+        return false;
+
+    std::vector<MeshCacheView> views;
+    std::vector<TextureData> texture_requests;
+    for (unsigned int i = 0, count = cache.get_mesh_count(); i < count; i++)
+    {
+        views.push_back(cache.get_mesh(i));
+        const auto& textures = views.back().textures;
+        texture_requests.insert(texture_requests.end(), textures.begin(), textures.end());
+    }
+    const auto preloaded_textures = preload_textures(texture_requests);
+
+    meshes_.reserve(views.size());
+    for (auto& view : views)
+    {
+        for (auto& texture_data : view.textures)
+            texture_data = load_texture(texture_data.path, texture_data.type);
+
+        // 顶点与索引直接从映射内存上传
+        meshes_.emplace_back(view.vertices, view.vertex_count,
+                             view.indices,  view.index_count,
+                             std::move(view.textures),
+                             get_vertex_format(load_flags_));
+        meshes_.back().set_lods(std::move(view.lods));
+        meshes_.back().set_meshlets(std::move(view.meshlets), view.indices);
+    }
+
+    return true;
+}
+
+bool Model::import_meshes(const std::string& path, const unsigned int load_flags,
+                          const LodSettings& lod_settings, std::vector<MeshData>& mesh_datas)
 {
     Assimp::Importer importer;
-    // 后期指令参考 http://assimp.sourceforge.net/lib_html/postprocess_8h.html
-    const auto scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    if (AssetPack::exists(path))
+        importer.SetIOHandler(new AssetPackIOSystem());     // Importer 负责释放
+    const auto scene = importer.ReadFile(path, MODEL_IMPORT_FLAGS);
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
     {
         std::cout << "[ERROR] Load model fail, ASSIMP::" << importer.GetErrorString() << std::endl;
-        return;
+        return false;
     }
 
-    directory_ = path.substr(0, path.find_last_of('/'));
-    process_node(scene->mRootNode, scene);
+    process_node(scene->mRootNode, scene, mesh_datas);
+
+    if (load_flags & MODEL_LOAD_OPTIMIZE)
+    {
+        // ACMR 按三角形数加权汇总；ATVR 由全部网格的顶点变换次数除以唯一顶点数得到
+        VertexCacheStats total_before {}, total_after {};
+        size_t total_triangles = 0;
+        size_t vertex_count_before = 0, vertex_count_after = 0;
+        double transformed_before = 0.0, transformed_after = 0.0;
+        for (auto& mesh_data : mesh_datas)
+        {
+            const auto triangle_count = mesh_data.indices.size() / 3;
+            vertex_count_before += mesh_data.vertices.size();
+
+            VertexCacheStats before {}, after {};
+            optimize_mesh(mesh_data, &before, &after);
+
+            vertex_count_after += mesh_data.vertices.size();
+            total_before.acmr += before.acmr * triangle_count;
+            total_after.acmr  += after.acmr  * triangle_count;
+            // ACMR × 三角形数 = 顶点变换次数
+            transformed_before += before.acmr * triangle_count;
+            transformed_after  += after.acmr  * triangle_count;
+            total_triangles += triangle_count;
+        }
+
+        if (total_triangles > 0)
+        {
+            total_before.acmr /= total_triangles;
+            total_after.acmr  /= total_triangles;
+        }
+        if (vertex_count_before > 0 && vertex_count_after > 0)
+        {
+            total_before.atvr = static_cast<float>(transformed_before / vertex_count_before);
+            total_after.atvr  = static_cast<float>(transformed_after  / vertex_count_after);
+        }
+
+        std::cout << "[INFO] Model: optimized " << path
+                  << ", vertices " << vertex_count_before << " -> " << vertex_count_after
+                  << ", ACMR " << total_before.acmr << " -> " << total_after.acmr
+                  << ", ATVR " << total_before.atvr << " -> " << total_after.atvr << std::endl;
+    }
+
+    if (load_flags & MODEL_LOAD_LOD)
+    {
+        for (auto& mesh_data : mesh_datas)
+            generate_lods(mesh_data, lod_settings);
+    }
+
+    // LOD 生成会合并顶点并改写索引，分簇放在最后
+    if (load_flags & MODEL_LOAD_MESHLETS)
+    {
+        for (auto& mesh_data : mesh_datas)
+            mesh_data.meshlets = build_meshlets(mesh_data);
+    }
+
+    return true;
 }
 
-void Model::process_node(aiNode* node, const aiScene* scene)
+void Model::process_node(aiNode* node, const aiScene* scene, std::vector<MeshData>& mesh_datas)
 {
     for (size_t i = 0, count = node->mNumMeshes; i < count; i++)
     {
         const auto mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes_.push_back(process_mesh(mesh, scene));
+        mesh_datas.push_back(process_mesh(mesh, scene));
     }
 
     for (size_t i = 0, count = node->mNumChildren; i < count; i++)
     {
-        process_node(node->mChildren[i], scene);
+        process_node(node->mChildren[i], scene, mesh_datas);
     }
 }
 
-Mesh Model::process_mesh(aiMesh* mesh, const aiScene* scene)
+std::string Model::get_texture_path(const std::string& path) const
+{
+    const auto filepath = directory_ + "/" + path;
+    const auto dot = filepath.find_last_of('.');
+    const auto slash = filepath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return filepath;
+
+    const auto stem = filepath.substr(0, dot);
+    for (const auto *extension : { ".dds", ".ktx" })
+    {
+        if (AssetPack::exists(stem + extension) || std::ifstream(stem + extension, std::ios::binary).good())
+            return stem + extension;
+    }
+    return filepath;
+}
+
+std::vector<std::shared_ptr<Texture>> Model::preload_textures(const std::vector<TextureData>& requests) const
+{
+    // 去重，已在全局缓存中的纹理直接复用
+    // 返回值持有新建纹理的引用，保证创建网格之前不会被释放
+    std::vector<std::shared_ptr<Texture>> textures;
+    std::vector<std::string> pending;
+    std::unordered_set<std::string> seen;
+    for (const auto& request : requests)
+    {
+        const auto filepath = get_texture_path(request.path);
+        if (!seen.insert(TextureCache::canonical_path(filepath)).second)
+            continue;
+
+        auto texture = TextureCache::find(filepath, true);
+        if (texture)
+            textures.push_back(std::move(texture));
+        else
+            pending.push_back(filepath);
+    }
+
+    if (pending.empty())
+        return textures;
+
+    // 工作线程只负责 stb_image 解码，glTexImage2D 仍在当前（上下文）线程按原顺序执行
+    auto& thread_pool = ThreadPool::get_instance();
+    std::vector<std::future<TextureImage>> images;
+    images.reserve(pending.size());
+    for (const auto& filepath : pending)
+        images.push_back(thread_pool.submit([filepath]() { return TextureImage(filepath); }));
+
+    // 等待期间继续处理上传队列，线程池可能正被异步加载的模型占用
+    auto& upload_queue = UploadQueue::get_instance();
+    for (auto& image : images)
+        textures.push_back(TextureCache::add(upload_queue.wait(image), true));
+
+    return textures;
+}
+
+MeshData Model::process_mesh(aiMesh* mesh, const aiScene* scene)
 {
     std::vector<VertexData>   vertices;
     std::vector<unsigned int> indices;
@@ -89,54 +690,90 @@ Mesh Model::process_mesh(aiMesh* mesh, const aiScene* scene)
             indices.push_back(face.mIndices[j]);
     }
 
+    // 这里只记录纹理路径，由调用方统一加载
     const auto material = scene->mMaterials[mesh->mMaterialIndex];
-    auto diffuse_maps = load_material_textures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-    texture_datas.insert(texture_datas.end(), diffuse_maps.begin(), diffuse_maps.end());
+    for (const auto& texture_type : MATERIAL_TEXTURE_TYPES)
+    {
+        for (size_t i = 0, count = material->GetTextureCount(texture_type.type); i < count; i++)
+        {
+            aiString str;
+            material->GetTexture(texture_type.type, i, &str);
 
-    auto specular_maps = load_material_textures(material, aiTextureType_SPECULAR, "texture_specular");
-    texture_datas.insert(texture_datas.end(), specular_maps.begin(), specular_maps.end());
+            TextureData texture_data {};
+            texture_data.type = texture_type.type_name;
+            texture_data.path = str.C_Str();
+            texture_datas.push_back(texture_data);
+        }
+    }
 
-    auto normal_maps = load_material_textures(material, aiTextureType_HEIGHT, "texture_normal");
-    texture_datas.insert(texture_datas.end(), normal_maps.begin(), normal_maps.end());
+    MeshData mesh_data;
+    mesh_data.vertices = std::move(vertices);
+    mesh_data.indices  = std::move(indices);
+    mesh_data.textures = std::move(texture_datas);
+    return mesh_data;
+}
 
-    auto height_maps = load_material_textures(material, aiTextureType_AMBIENT, "texture_height");
-    texture_datas.insert(texture_datas.end(), height_maps.begin(), height_maps.end());
+TextureData Model::load_texture(const std::string& path, const std::string& type_name) const
+{
+    TextureData texture_data {};
+    texture_data.texture = TextureCache::get(get_texture_path(path), true);
+    texture_data.type = type_name;
+    texture_data.path = path;
+    return texture_data;
+}
 
-    return Mesh(vertices, indices, texture_datas);
+void Model::add_mesh(const VertexData   *vertices, const unsigned int vertex_count,
+                     const unsigned int *indices,  const unsigned int index_count,
+                     std::vector<TextureData> textures,
+                     std::vector<MeshLod> lods,
+                     std::vector<Meshlet> meshlets)
+{
+    // 已就绪的纹理直接使用，其余先用占位纹理
+    for (auto& texture_data : textures)
+    {
+        texture_data.texture = TextureCache::find(get_texture_path(texture_data.path), true);
+        if (!texture_data.texture)
+            texture_data.texture = TextureCache::get_placeholder();
+    }
+
+    meshes_.emplace_back(vertices, vertex_count, indices, index_count, std::move(textures), get_vertex_format(load_flags_));
+    meshes_.back().set_lods(std::move(lods));
+    meshes_.back().set_meshlets(std::move(meshlets), indices);
 }
 
-std::vector<TextureData> Model::load_material_textures(aiMaterial* mat,
-                                                       const aiTextureType type,
-                                                       const std::string& type_name)
+void Model::stream_texture(const std::string& path)
 {
-    std::vector<TextureData> texture_datas;
+    const auto filepath = get_texture_path(path);
+    const auto texture = TextureCache::find(filepath, true);
+    if (texture)
+    {
+        apply_texture(path, texture);
+        return;
+    }
 
-    for (size_t i = 0, count = mat->GetTextureCount(type); i < count; i++)
+    pending_textures_++;
+
+    std::weak_ptr<Model*> handle = handle_;
+    ThreadPool::get_instance().submit([handle, path, filepath]()
     {
-        aiString str;
-        mat->GetTexture(type, i, &str);
+        if (handle.expired())
+            return;
 
-        auto skip = false;
-        for (auto &loaded_texture_data : loaded_texture_datas_)
+        const auto image = std::make_shared<TextureImage>(filepath);
+        UploadQueue::get_instance().push([handle, path, image]()
         {
-            if (std::strcmp(loaded_texture_data.path.data(), str.C_Str()) == 0)
-            {
-                texture_datas.push_back(loaded_texture_data);
-                skip = true;
-                break;
-            }
-        }
+            const auto self = handle.lock();
+            if (!self)
+                return;
 
-        if (!skip)
-        {
-            TextureData texture_data {};
-            texture_data.texture = new Texture(directory_ + "/" + str.C_Str(), true);
-            texture_data.type = type_name;
-            texture_data.path = str.C_Str();
-            texture_datas.push_back(texture_data);
-            loaded_texture_datas_.push_back(texture_data);
-        }
-    }
+            (*self)->apply_texture(path, TextureCache::add(*image, true));
+            (*self)->pending_textures_--;
+        }, [handle]() { return handle.expired(); });
+    });
+}
 
-    return texture_datas;
+void Model::apply_texture(const std::string& path, const std::shared_ptr<Texture>& texture)
+{
+    for (auto& mesh : meshes_)
+        mesh.set_texture(path, texture);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -7,12 +9,38 @@
 
 #include "Shader.h"
 #include "Mesh.h"
+#include "MeshSimplifier.h"
+#include "Texture.h"
 
 class Mesh;
 class Shader;
 class Renderer;
+class RenderQueue;
+class InstanceBuffer;
+class DrawBatch;
+class Camera;
 struct TextureData;
 struct VertexData;
+struct MeshData;
+struct MeshLod;
+struct Meshlet;
+struct Frustum;
+
+// Assimp 后期处理指令，参考 http://assimp.sourceforge.net/lib_html/postprocess_8h.html
+const unsigned int MODEL_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+
+/**
+ * 模型加载选项
+ */
+enum ModelLoadFlags
+{
+    MODEL_LOAD_DEFAULT = 0,
+    MODEL_LOAD_ASYNC   = 1 << 0,    // 后台导入，纹理就绪前使用占位纹理绘制
+    MODEL_LOAD_PACKED_VERTICES = 1 << 1,    // 以压缩顶点格式上传，着色器需解码，见 VertexPacking.h
+    MODEL_LOAD_OPTIMIZE        = 1 << 2,    // 导入后合并顶点并重排索引与顶点，见 MeshOptimizer.h
+    MODEL_LOAD_LOD             = 1 << 3,    // 导入时生成 LOD 链，按屏幕误差选择，见 MeshSimplifier.h
+    MODEL_LOAD_MESHLETS        = 1 << 4,    // 导入时将原网格分簇，绘制时逐簇剔除，见 Meshlet.h
+};
 
 class Model
 {
@@ -21,21 +49,83 @@ private:
     std::string path_;
     std::string directory_;
     bool gamma_correction_;
+    unsigned int load_flags_;
+    LodSettings  lod_settings_;
+    float        lod_pixel_error_;          // 允许的屏幕空间误差（像素）
+    unsigned int drawn_triangle_count_;     // 上一次 draw 提交的三角形数
+    unsigned int culled_meshlet_count_;     // 上一次 draw 剔除的簇数
 
-    std::vector<TextureData> loaded_texture_datas_;
+    // 后台任务持有弱引用，模型析构后任务自动失效
+    std::shared_ptr<Model*> handle_;
+    bool         importing_;            // 后台导入尚未完成
+    unsigned int pending_textures_;     // 尚未上传的纹理数量
 
 public:
-    Model(const std::string& path, const bool& gamma = false);
+    Model(const std::string& path, const bool& gamma = false,
+          const unsigned int load_flags = MODEL_LOAD_DEFAULT,
+          const LodSettings& lod_settings = LodSettings());
     ~Model();
 
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
     void draw(const Renderer& renderer, Shader& shader);
+    // 按每个网格在屏幕上的误差选择 LOD，fov 取 camera.get_zoom()
+    void draw(const Renderer& renderer, Shader& shader, const Camera& camera, const glm::mat4& model_mat);
+    // 同上，选中第 0 级的网格再按簇做视锥与背面剔除（需 MODEL_LOAD_MESHLETS）
+    void draw(const Renderer& renderer, Shader& shader, const Camera& camera,
+              const glm::mat4& proj_mat, const glm::mat4& model_mat);
+
+    // 每个网格一次绘制 instance_count 个实例，变换取自实例缓冲，不做 LOD 选择
+    void draw_instanced(const Renderer& renderer, Shader& shader,
+                        const InstanceBuffer& instance_buffer, unsigned int instance_count);
+
+    // 各网格以第 0 级追加到渲染队列
+    void submit(RenderQueue& queue, Shader& shader, const glm::mat4& model_mat);
+    // 各网格以第 0 级追加到合批绘制，共用一条逐绘制数据
+    void submit(DrawBatch& batch, const glm::mat4& model_mat, const glm::vec4& color = glm::vec4(1.0f));
+
+    inline float get_lod_pixel_error() const { return lod_pixel_error_; }
+    inline void set_lod_pixel_error(const float pixel_error) { lod_pixel_error_ = pixel_error; }
+    inline unsigned int get_drawn_triangle_count() const { return drawn_triangle_count_; }
+    inline unsigned int get_culled_meshlet_count() const { return culled_meshlet_count_; }
+
+    inline const std::vector<Mesh>& get_meshes() const { return meshes_; }
+
+    // 几何体与纹理是否已全部上传
+    inline bool is_loaded() const { return !importing_ && pending_textures_ == 0; }
+
+    // 全部网格顶点缓冲大小（字节）
+    unsigned int get_vertex_buffer_size() const;
+    // 全部网格索引缓冲大小（字节）
+    unsigned int get_index_buffer_size() const;
 
 private:
     void load_model(const std::string& path);
-    void process_node(aiNode *node, const aiScene *scene);
-    Mesh process_mesh(aiMesh *mesh, const aiScene *scene);
-    std::vector<TextureData> load_material_textures(aiMaterial *mat,
-                                                    aiTextureType type,
-                                                    const std::string& type_name);
-};
+    void load_model_async();
+    bool load_from_cache(const std::string& cache_path, uint64_t source_hash);
 
+    // frustum 为空时不做簇剔除
+    void draw_lod(const Renderer& renderer, Shader& shader, const Camera& camera,
+                  const glm::mat4& model_mat, const Frustum *frustum);
+
+    // 以下导入函数不访问成员，可在工作线程调用
+    static bool import_meshes(const std::string& path, unsigned int load_flags,
+                              const LodSettings& lod_settings, std::vector<MeshData>& mesh_datas);
+    static void process_node(aiNode *node, const aiScene *scene, std::vector<MeshData>& mesh_datas);
+    static MeshData process_mesh(aiMesh *mesh, const aiScene *scene);
+
+    // 材质纹理的完整路径，同目录下存在烘焙好的 .dds / .ktx 时优先使用
+    std::string get_texture_path(const std::string& path) const;
+    std::vector<std::shared_ptr<Texture>> preload_textures(const std::vector<TextureData>& requests) const;
+    TextureData load_texture(const std::string& path, const std::string& type_name) const;
+
+    // 异步加载：在上下文线程添加网格、请求纹理、替换占位纹理
+    void add_mesh(const VertexData   *vertices, unsigned int vertex_count,
+                  const unsigned int *indices,  unsigned int index_count,
+                  std::vector<TextureData> textures,
+                  std::vector<MeshLod> lods,
+                  std::vector<Meshlet> meshlets);
+    void stream_texture(const std::string& path);
+    void apply_texture(const std::string& path, const std::shared_ptr<Texture>& texture);
+};
@@ -0,0 +1,257 @@
+#include "OffsetAllocator.h"
+
+namespace
+{
+    unsigned int find_last_set(uint32_t value)
+    {
+        unsigned int bit = 0;
+        while (value >>= 1)
+            bit++;
+        return bit;
+    }
+
+    unsigned int find_first_set(uint32_t value)
+    {
+        unsigned int bit = 0;
+        while ((value & 1) == 0)
+        {
+            value >>= 1;
+            bit++;
+        }
+        return bit;
+    }
+}
+
+OffsetAllocator::OffsetAllocator(const unsigned int size)
+    : size_(size), free_size_(0), allocation_count_(0), fl_bitmap_(0)
+{
+    reset();
+}
+
+OffsetAllocation OffsetAllocator::allocate(const unsigned int size, unsigned int alignment)
+{
+    alignment = alignment > 0 ? alignment : 1;
+    OffsetAllocation allocation { 0, 0, OFFSET_ALLOCATOR_INVALID };
+    if (size == 0 || size > size_ || alignment - 1 > size_ - size)
+        return allocation;
+
+    // 按最坏情况的对齐余量查找，保证找到的块一定放得下
+    auto node = find_free(size + alignment - 1);
+    if (node == OFFSET_ALLOCATOR_INVALID)
+        return allocation;
+    remove_free(node);
+
+    const auto padding = (alignment - nodes_[node].offset % alignment) % alignment;
+    if (padding > 0)
+    {
+        // 前部余量留作空闲块
+        split(node, padding);
+        const auto front = node;
+        node = nodes_[front].next_physical;
+        remove_free(node);
+        insert_free(front);
+    }
+
+    if (nodes_[node].size > size)
+        split(node, size);
+
+    nodes_[node].used = true;
+    free_size_ -= size;
+    allocation_count_++;
+
+    allocation.offset = nodes_[node].offset;
+    allocation.size   = size;
+    allocation.node   = node;
+    return allocation;
+}
+
+void OffsetAllocator::free(const OffsetAllocation& allocation)
+{
+    auto node = allocation.node;
+    if (node >= nodes_.size() || !nodes_[node].used)
+        return;
+
+    nodes_[node].used = false;
+    free_size_ += nodes_[node].size;
+    allocation_count_--;
+
+    // 与前一个空闲块合并
+    const auto prev = nodes_[node].prev_physical;
+    if (prev != OFFSET_ALLOCATOR_INVALID && !nodes_[prev].used)
+    {
+        remove_free(prev);
+        nodes_[prev].size += nodes_[node].size;
+        nodes_[prev].next_physical = nodes_[node].next_physical;
+        if (nodes_[node].next_physical != OFFSET_ALLOCATOR_INVALID)
+            nodes_[nodes_[node].next_physical].prev_physical = prev;
+        unused_nodes_.push_back(node);
+        node = prev;
+    }
+
+    // 与后一个空闲块合并
+    const auto next = nodes_[node].next_physical;
+    if (next != OFFSET_ALLOCATOR_INVALID && !nodes_[next].used)
+    {
+        remove_free(next);
+        nodes_[node].size += nodes_[next].size;
+        nodes_[node].next_physical = nodes_[next].next_physical;
+        if (nodes_[next].next_physical != OFFSET_ALLOCATOR_INVALID)
+            nodes_[nodes_[next].next_physical].prev_physical = node;
+        unused_nodes_.push_back(next);
+    }
+
+    insert_free(node);
+}
+
+void OffsetAllocator::reset()
+{
+    fl_bitmap_ = 0;
+    for (unsigned int fl = 0; fl < FL_COUNT; fl++)
+    {
+        sl_bitmaps_[fl] = 0;
+        for (unsigned int sl = 0; sl < SL_COUNT; sl++)
+            free_heads_[fl][sl] = OFFSET_ALLOCATOR_INVALID;
+    }
+
+    nodes_.clear();
+    unused_nodes_.clear();
+    free_size_ = size_;
+    allocation_count_ = 0;
+
+    if (size_ > 0)
+        insert_free(create_node(0, size_));
+}
+
+unsigned int OffsetAllocator::get_largest_free_block() const
+{
+    if (fl_bitmap_ == 0)
+        return 0;
+
+    // 最高的非空档位中逐个比较
+    const auto fl = find_last_set(fl_bitmap_);
+    const auto sl = find_last_set(sl_bitmaps_[fl]);
+    unsigned int largest = 0;
+    for (auto node = free_heads_[fl][sl]; node != OFFSET_ALLOCATOR_INVALID; node = nodes_[node].next_free)
+        largest = nodes_[node].size > largest ? nodes_[node].size : largest;
+    return largest;
+}
+
+void OffsetAllocator::mapping_insert(const unsigned int size, unsigned int& fl, unsigned int& sl)
+{
+    if (size < SL_COUNT)
+    {
+        fl = 0;
+        sl = size;
+        return;
+    }
+
+    const auto last_bit = find_last_set(size);
+    fl = last_bit - SL_BITS + 1;
+    sl = (size >> (last_bit - SL_BITS)) ^ SL_COUNT;
+}
+
+void OffsetAllocator::mapping_search(unsigned int size, unsigned int& fl, unsigned int& sl)
+{
+    // 向上取整到下一档，该档中任何块都不小于 size
+    if (size >= SL_COUNT)
+    {
+        const auto round = (1u << (find_last_set(size) - SL_BITS)) - 1;
+        size = size > 0xFFFFFFFF - round ? 0xFFFFFFFF : size + round;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+unsigned int OffsetAllocator::create_node(const unsigned int offset, const unsigned int size)
+{
+    const Node node { offset, size,
+                      OFFSET_ALLOCATOR_INVALID, OFFSET_ALLOCATOR_INVALID,
+                      OFFSET_ALLOCATOR_INVALID, OFFSET_ALLOCATOR_INVALID,
+                      false };
+
+    if (!unused_nodes_.empty())
+    {
+        const auto index = unused_nodes_.back();
+        unused_nodes_.pop_back();
+        nodes_[index] = node;
+        return index;
+    }
+
+    nodes_.push_back(node);
+    return static_cast<unsigned int>(nodes_.size() - 1);
+}
+
+void OffsetAllocator::insert_free(const unsigned int node)
+{
+    unsigned int fl, sl;
+    mapping_insert(nodes_[node].size, fl, sl);
+
+    const auto head = free_heads_[fl][sl];
+    nodes_[node].prev_free = OFFSET_ALLOCATOR_INVALID;
+    nodes_[node].next_free = head;
+    if (head != OFFSET_ALLOCATOR_INVALID)
+        nodes_[head].prev_free = node;
+
+    free_heads_[fl][sl] = node;
+    fl_bitmap_ |= 1u << fl;
+    sl_bitmaps_[fl] |= 1u << sl;
+}
+
+void OffsetAllocator::remove_free(const unsigned int node)
+{
+    const auto prev = nodes_[node].prev_free;
+    const auto next = nodes_[node].next_free;
+    if (prev != OFFSET_ALLOCATOR_INVALID)
+        nodes_[prev].next_free = next;
+    if (next != OFFSET_ALLOCATOR_INVALID)
+        nodes_[next].prev_free = prev;
+
+    unsigned int fl, sl;
+    mapping_insert(nodes_[node].size, fl, sl);
+    if (free_heads_[fl][sl] == node)
+    {
+        free_heads_[fl][sl] = next;
+        if (next == OFFSET_ALLOCATOR_INVALID)
+        {
+            sl_bitmaps_[fl] &= ~(1u << sl);
+            if (sl_bitmaps_[fl] == 0)
+                fl_bitmap_ &= ~(1u << fl);
+        }
+    }
+
+    nodes_[node].prev_free = OFFSET_ALLOCATOR_INVALID;
+    nodes_[node].next_free = OFFSET_ALLOCATOR_INVALID;
+}
+
+unsigned int OffsetAllocator::find_free(const unsigned int size) const
+{
+    unsigned int fl, sl;
+    mapping_search(size, fl, sl);
+    if (fl >= FL_COUNT)
+        return OFFSET_ALLOCATOR_INVALID;
+
+    auto sl_map = sl_bitmaps_[fl] & (~0u << sl);
+    if (sl_map == 0)
+    {
+        const auto fl_map = fl + 1 < FL_COUNT ? fl_bitmap_ & (~0u << (fl + 1)) : 0;
+        if (fl_map == 0)
+            return OFFSET_ALLOCATOR_INVALID;
+
+        fl = find_first_set(fl_map);
+        sl_map = sl_bitmaps_[fl];
+    }
+
+    return free_heads_[fl][find_first_set(sl_map)];
+}
+
+void OffsetAllocator::split(const unsigned int node, const unsigned int size)
+{
+    const auto rest = create_node(nodes_[node].offset + size, nodes_[node].size - size);
+    nodes_[rest].prev_physical = node;
+    nodes_[rest].next_physical = nodes_[node].next_physical;
+    if (nodes_[node].next_physical != OFFSET_ALLOCATOR_INVALID)
+        nodes_[nodes_[node].next_physical].prev_physical = rest;
+
+    nodes_[node].next_physical = rest;
+    nodes_[node].size = size;
+    insert_free(rest);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * 一次分配的结果，node 为 OFFSET_ALLOCATOR_INVALID 时表示分配失败
+ */
+struct OffsetAllocation
+{
+    unsigned int offset;
+    unsigned int size;
+    unsigned int node;
+};
+
+const unsigned int OFFSET_ALLOCATOR_INVALID = 0xFFFFFFFF;
+
+/**
+ * TLSF（两级隔离适配）偏移分配器
+ *
+ * 只管理 [0, size) 区间内的偏移，不持有内存，分配与释放都是 O(1)；
+ * 释放时与相邻空闲块合并。用于在大块显存缓冲中划分子区间
+ */
+class OffsetAllocator
+{
+private:
+    static const unsigned int SL_BITS  = 4;                 // 每级再细分 16 档
+    static const unsigned int SL_COUNT = 1 << SL_BITS;
+    static const unsigned int FL_COUNT = 32;
+
+    struct Node
+    {
+        unsigned int offset;
+        unsigned int size;
+        unsigned int prev_physical;     // 地址相邻的前后块
+        unsigned int next_physical;
+        unsigned int prev_free;         // 同一空闲链表中的前后块
+        unsigned int next_free;
+        bool         used;
+    };
+
+    unsigned int size_;
+    unsigned int free_size_;
+    unsigned int allocation_count_;
+
+    uint32_t     fl_bitmap_;
+    uint32_t     sl_bitmaps_[FL_COUNT];
+    unsigned int free_heads_[FL_COUNT][SL_COUNT];
+
+    std::vector<Node>         nodes_;
+    std::vector<unsigned int> unused_nodes_;
+
+public:
+    explicit OffsetAllocator(unsigned int size);
+
+    // alignment 可以不是 2 的幂（如顶点步长），对齐产生的前后余量归还空闲链表
+    OffsetAllocation allocate(unsigned int size, unsigned int alignment = 1);
+    void free(const OffsetAllocation& allocation);
+
+    // 清空全部分配
+    void reset();
+
+    inline unsigned int get_size() const { return size_; }
+    inline unsigned int get_free_size() const { return free_size_; }
+    inline unsigned int get_allocation_count() const { return allocation_count_; }
+    // 最大的空闲块，与 get_free_size 的差距即碎片程度
+    unsigned int get_largest_free_block() const;
+
+private:
+    static void mapping_insert(unsigned int size, unsigned int& fl, unsigned int& sl);
+    static void mapping_search(unsigned int size, unsigned int& fl, unsigned int& sl);
+
+    unsigned int create_node(unsigned int offset, unsigned int size);
+    void insert_free(unsigned int node);
+    void remove_free(unsigned int node);
+    unsigned int find_free(unsigned int size) const;
+    // 从 node 前部切下 size 字节留在 node 中，剩余部分成为新的空闲块
+    void split(unsigned int node, unsigned int size);
+};
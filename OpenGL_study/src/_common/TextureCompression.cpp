@@ -0,0 +1,602 @@
+#include "TextureCompression.h"
+#include "ThreadPool.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+
+namespace
+{
+    unsigned int color_distance(const unsigned char *a, const unsigned char *b)
+    {
+        const int dr = a[0] - b[0];
+        const int dg = a[1] - b[1];
+        const int db = a[2] - b[2];
+        return dr * dr + dg * dg + db * db;
+    }
+
+    uint16_t pack_565(const float r, const float g, const float b)
+    {
+        const auto r5 = static_cast<int>(std::lround(std::min(std::max(r, 0.0f), 255.0f) * 31.0f / 255.0f));
+        const auto g6 = static_cast<int>(std::lround(std::min(std::max(g, 0.0f), 255.0f) * 63.0f / 255.0f));
+        const auto b5 = static_cast<int>(std::lround(std::min(std::max(b, 0.0f), 255.0f) * 31.0f / 255.0f));
+        return static_cast<uint16_t>(r5 << 11 | g6 << 5 | b5);
+    }
+
+    void unpack_565(const uint16_t color, unsigned char *rgb)
+    {
+        const auto r5 = color >> 11 & 0x1F;
+        const auto g6 = color >> 5 & 0x3F;
+        const auto b5 = color & 0x1F;
+        rgb[0] = static_cast<unsigned char>(r5 << 3 | r5 >> 2);
+        rgb[1] = static_cast<unsigned char>(g6 << 2 | g6 >> 4);
+        rgb[2] = static_cast<unsigned char>(b5 << 3 | b5 >> 2);
+    }
+
+    // 四色模式的调色板
+    void build_palette(const uint16_t c0, const uint16_t c1, unsigned char palette[4][3])
+    {
+        unpack_565(c0, palette[0]);
+        unpack_565(c1, palette[1]);
+        for (auto i = 0; i < 3; i++)
+        {
+            palette[2][i] = static_cast<unsigned char>((2 * palette[0][i] + palette[1][i]) / 3);
+            palette[3][i] = static_cast<unsigned char>((palette[0][i] + 2 * palette[1][i]) / 3);
+        }
+    }
+
+    // 为每个像素选最近的调色板颜色，返回总误差
+    unsigned int fit_indices(const unsigned char rgba[64], const uint16_t c0, const uint16_t c1, unsigned char indices[16])
+    {
+        unsigned char palette[4][3];
+        build_palette(c0, c1, palette);
+
+        unsigned int error = 0;
+        for (auto i = 0; i < 16; i++)
+        {
+            auto best = 0u;
+            auto best_distance = color_distance(rgba + i * 4, palette[0]);
+            for (auto j = 1u; j < 4; j++)
+            {
+                const auto distance = color_distance(rgba + i * 4, palette[j]);
+                if (distance < best_distance)
+                {
+                    best_distance = distance;
+                    best = j;
+                }
+            }
+            indices[i] = static_cast<unsigned char>(best);
+            error += best_distance;
+        }
+        return error;
+    }
+
+    // 由当前索引最小二乘求解两个端点
+    bool refine_endpoints(const unsigned char rgba[64], const unsigned char indices[16], uint16_t& c0, uint16_t& c1)
+    {
+        static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+        float ax[3] = { 0.0f, 0.0f, 0.0f }, bx[3] = { 0.0f, 0.0f, 0.0f };
+        for (auto i = 0; i < 16; i++)
+        {
+            const auto a = weights[indices[i]];
+            const auto b = 1.0f - a;
+            aa += a * a;
+            bb += b * b;
+            ab += a * b;
+            for (auto k = 0; k < 3; k++)
+            {
+                ax[k] += a * rgba[i * 4 + k];
+                bx[k] += b * rgba[i * 4 + k];
+            }
+        }
+
+        const auto determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f)
+            return false;
+
+        float e0[3], e1[3];
+        for (auto k = 0; k < 3; k++)
+        {
+            e0[k] = (ax[k] * bb - bx[k] * ab) / determinant;
+            e1[k] = (bx[k] * aa - ax[k] * ab) / determinant;
+        }
+        c0 = pack_565(e0[0], e0[1], e0[2]);
+        c1 = pack_565(e1[0], e1[1], e1[2]);
+        return true;
+    }
+
+    void write_color_block(uint16_t c0, uint16_t c1, unsigned char indices[16], unsigned char output[8])
+    {
+        // c0 > c1 表示四色模式，相等时全部取 c0
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+            for (auto i = 0; i < 16; i++)
+                indices[i] ^= 1;    // 0 <-> 1，2 <-> 3
+        }
+        else if (c0 == c1)
+        {
+            std::memset(indices, 0, 16);
+        }
+
+        uint32_t bits = 0;
+        for (auto i = 0; i < 16; i++)
+            bits |= static_cast<uint32_t>(indices[i]) << (i * 2);
+
+        output[0] = static_cast<unsigned char>(c0 & 0xFF);
+        output[1] = static_cast<unsigned char>(c0 >> 8);
+        output[2] = static_cast<unsigned char>(c1 & 0xFF);
+        output[3] = static_cast<unsigned char>(c1 >> 8);
+        for (auto i = 0; i < 4; i++)
+            output[4 + i] = static_cast<unsigned char>(bits >> (i * 8) & 0xFF);
+    }
+
+    void decode_color_block(const unsigned char input[8], unsigned char rgba[64], const bool four_color_only)
+    {
+        const auto c0 = static_cast<uint16_t>(input[0] | input[1] << 8);
+        const auto c1 = static_cast<uint16_t>(input[2] | input[3] << 8);
+
+        unsigned char palette[4][4];
+        unpack_565(c0, palette[0]);
+        unpack_565(c1, palette[1]);
+        palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+        if (c0 > c1 || four_color_only)
+        {
+            for (auto i = 0; i < 3; i++)
+            {
+                palette[2][i] = static_cast<unsigned char>((2 * palette[0][i] + palette[1][i]) / 3);
+                palette[3][i] = static_cast<unsigned char>((palette[0][i] + 2 * palette[1][i]) / 3);
+            }
+        }
+        else
+        {
+            // 三色模式，第四种为透明黑
+            for (auto i = 0; i < 3; i++)
+            {
+                palette[2][i] = static_cast<unsigned char>((palette[0][i] + palette[1][i]) / 2);
+                palette[3][i] = 0;
+            }
+            palette[3][3] = 0;
+        }
+
+        const auto bits = static_cast<uint32_t>(input[4] | input[5] << 8 | input[6] << 16) | static_cast<uint32_t>(input[7]) << 24;
+        for (auto i = 0; i < 16; i++)
+            std::memcpy(rgba + i * 4, palette[bits >> (i * 2) & 3], 4);
+    }
+
+    // 单通道调色板，a0 > a1 为八值模式
+    void build_alpha_palette(const unsigned int a0, const unsigned int a1, unsigned char palette[8])
+    {
+        palette[0] = static_cast<unsigned char>(a0);
+        palette[1] = static_cast<unsigned char>(a1);
+        if (a0 > a1)
+        {
+            for (auto i = 2u; i < 8; i++)
+                palette[i] = static_cast<unsigned char>(((8 - i) * a0 + (i - 1) * a1) / 7);
+        }
+        else
+        {
+            for (auto i = 2u; i < 6; i++)
+                palette[i] = static_cast<unsigned char>(((6 - i) * a0 + (i - 1) * a1) / 5);
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    // 按 4x4 块取像素，越界时钳制到边缘
+    void fetch_block(const unsigned char *rgba, const unsigned int width, const unsigned int height,
+                     const unsigned int block_x, const unsigned int block_y, unsigned char block[64])
+    {
+        for (auto y = 0u; y < 4; y++)
+        {
+            const auto py = std::min(block_y * 4 + y, height - 1);
+            for (auto x = 0u; x < 4; x++)
+            {
+                const auto px = std::min(block_x * 4 + x, width - 1);
+                std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(py) * width + px) * 4, 4);
+            }
+        }
+    }
+
+    void encode_block(const CompressedFormat format, const unsigned char block[64], unsigned char *output)
+    {
+        switch (format)
+        {
+        case COMPRESSED_FORMAT_BC1: encode_bc1_block(block, output); break;
+        case COMPRESSED_FORMAT_BC3: encode_bc3_block(block, output); break;
+        case COMPRESSED_FORMAT_BC4: encode_bc4_block(block, 0, output); break;
+        case COMPRESSED_FORMAT_BC5: encode_bc5_block(block, output); break;
+        default: break;
+        }
+    }
+
+    std::vector<unsigned char> expand_to_rgba(const unsigned char *pixels, const int width, const int height, const int channels)
+    {
+        const auto count = static_cast<size_t>(width) * height;
+        std::vector<unsigned char> rgba(count * 4);
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto src = pixels + i * channels;
+            auto dst = rgba.data() + i * 4;
+            if (channels <= 2)
+            {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = channels == 2 ? src[1] : 255;
+            }
+            else
+            {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = channels == 4 ? src[3] : 255;
+            }
+        }
+        return rgba;
+    }
+
+    // 单位法线由 x、y 重建 z，与 res/shaders/normal_map.glsl 一致
+    unsigned char reconstruct_normal_z(const unsigned char x, const unsigned char y)
+    {
+        const auto nx = x / 255.0f * 2.0f - 1.0f;
+        const auto ny = y / 255.0f * 2.0f - 1.0f;
+        const auto nz = std::sqrt(std::max(0.0f, 1.0f - nx * nx - ny * ny));
+        return static_cast<unsigned char>(std::lround((nz * 0.5f + 0.5f) * 255.0f));
+    }
+}
+
+unsigned int get_block_size(const CompressedFormat format)
+{
+    switch (format)
+    {
+    case COMPRESSED_FORMAT_BC1:
+    case COMPRESSED_FORMAT_BC4:
+    case COMPRESSED_FORMAT_ETC2_RGB:
+        return 8;
+    case COMPRESSED_FORMAT_BC3:
+    case COMPRESSED_FORMAT_BC5:
+    case COMPRESSED_FORMAT_BC7:
+    case COMPRESSED_FORMAT_ETC2_RGBA:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+size_t get_compressed_size(const CompressedFormat format, const unsigned int width, const unsigned int height)
+{
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * get_block_size(format);
+}
+
+unsigned int get_gl_internal_format(const CompressedFormat format)
+{
+    switch (format)
+    {
+    case COMPRESSED_FORMAT_BC1:       return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case COMPRESSED_FORMAT_BC3:       return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case COMPRESSED_FORMAT_BC4:       return GL_COMPRESSED_RED_RGTC1;
+    case COMPRESSED_FORMAT_BC5:       return GL_COMPRESSED_RG_RGTC2;
+    case COMPRESSED_FORMAT_BC7:       return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case COMPRESSED_FORMAT_ETC2_RGB:  return GL_COMPRESSED_RGB8_ETC2;
+    case COMPRESSED_FORMAT_ETC2_RGBA: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+    default:                          return 0;
+    }
+}
+
+const char* get_format_name(const CompressedFormat format)
+{
+    switch (format)
+    {
+    case COMPRESSED_FORMAT_BC1:       return "BC1";
+    case COMPRESSED_FORMAT_BC3:       return "BC3";
+    case COMPRESSED_FORMAT_BC4:       return "BC4";
+    case COMPRESSED_FORMAT_BC5:       return "BC5";
+    case COMPRESSED_FORMAT_BC7:       return "BC7";
+    case COMPRESSED_FORMAT_ETC2_RGB:  return "ETC2_RGB";
+    case COMPRESSED_FORMAT_ETC2_RGBA: return "ETC2_RGBA";
+    default:                          return "NONE";
+    }
+}
+
+void encode_bc1_block(const unsigned char rgba[64], unsigned char output[8])
+{
+    // 主成分方向上的两个极值作为端点
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (auto i = 0; i < 16; i++)
+    {
+        for (auto k = 0; k < 3; k++)
+            mean[k] += rgba[i * 4 + k] / 16.0f;
+    }
+
+    float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (auto i = 0; i < 16; i++)
+    {
+        const auto r = rgba[i * 4 + 0] - mean[0];
+        const auto g = rgba[i * 4 + 1] - mean[1];
+        const auto b = rgba[i * 4 + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // 幂迭代求最大特征向量
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (auto iteration = 0; iteration < 8; iteration++)
+    {
+        const float next[3] = {
+            axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2],
+            axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4],
+            axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5],
+        };
+        const auto length = std::max(std::fabs(next[0]), std::max(std::fabs(next[1]), std::fabs(next[2])));
+        if (length < 1e-6f)
+            break;
+        for (auto k = 0; k < 3; k++)
+            axis[k] = next[k] / length;
+    }
+
+    auto min_t = 0.0f, max_t = 0.0f;
+    for (auto i = 0; i < 16; i++)
+    {
+        const auto t = (rgba[i * 4 + 0] - mean[0]) * axis[0]
+                     + (rgba[i * 4 + 1] - mean[1]) * axis[1]
+                     + (rgba[i * 4 + 2] - mean[2]) * axis[2];
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+
+    // 端点向内收缩 1/16，减小量化后两端的误差
+    const auto inset = (max_t - min_t) / 16.0f;
+    max_t -= inset;
+    min_t += inset;
+
+    auto c0 = pack_565(mean[0] + axis[0] * max_t, mean[1] + axis[1] * max_t, mean[2] + axis[2] * max_t);
+    auto c1 = pack_565(mean[0] + axis[0] * min_t, mean[1] + axis[1] * min_t, mean[2] + axis[2] * min_t);
+
+    unsigned char indices[16];
+    auto error = fit_indices(rgba, c0, c1, indices);
+
+    // 最小二乘迭代两次，误差不再下降时停止
+    for (auto iteration = 0; iteration < 2 && error > 0; iteration++)
+    {
+        auto r0 = c0, r1 = c1;
+        if (!refine_endpoints(rgba, indices, r0, r1))
+            break;
+
+        unsigned char refined[16];
+        const auto refined_error = fit_indices(rgba, r0, r1, refined);
+        if (refined_error >= error)
+            break;
+
+        c0 = r0;
+        c1 = r1;
+        error = refined_error;
+        std::memcpy(indices, refined, sizeof(indices));
+    }
+
+    write_color_block(c0, c1, indices, output);
+}
+
+void encode_bc3_block(const unsigned char rgba[64], unsigned char output[16])
+{
+    encode_bc4_block(rgba, 3, output);
+    encode_bc1_block(rgba, output + 8);
+}
+
+void encode_bc4_block(const unsigned char rgba[64], const unsigned int channel, unsigned char output[8])
+{
+    unsigned int min_value = 255, max_value = 0;
+    for (auto i = 0; i < 16; i++)
+    {
+        min_value = std::min<unsigned int>(min_value, rgba[i * 4 + channel]);
+        max_value = std::max<unsigned int>(max_value, rgba[i * 4 + channel]);
+    }
+
+    output[0] = static_cast<unsigned char>(max_value);
+    output[1] = static_cast<unsigned char>(min_value);
+
+    uint64_t bits = 0;
+    if (max_value > min_value)
+    {
+        unsigned char palette[8];
+        build_alpha_palette(max_value, min_value, palette);
+        for (auto i = 0; i < 16; i++)
+        {
+            const int value = rgba[i * 4 + channel];
+            auto best = 0u;
+            auto best_distance = 256;
+            for (auto j = 0u; j < 8; j++)
+            {
+                const auto distance = std::abs(value - palette[j]);
+                if (distance < best_distance)
+                {
+                    best_distance = distance;
+                    best = j;
+                }
+            }
+            bits |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+
+    for (auto i = 0; i < 6; i++)
+        output[2 + i] = static_cast<unsigned char>(bits >> (i * 8) & 0xFF);
+}
+
+void encode_bc5_block(const unsigned char rgba[64], unsigned char output[16])
+{
+    encode_bc4_block(rgba, 0, output);
+    encode_bc4_block(rgba, 1, output + 8);
+}
+
+void decode_bc1_block(const unsigned char input[8], unsigned char rgba[64])
+{
+    decode_color_block(input, rgba, false);
+}
+
+void decode_bc4_block(const unsigned char input[8], const unsigned int channel, unsigned char rgba[64])
+{
+    unsigned char palette[8];
+    build_alpha_palette(input[0], input[1], palette);
+
+    uint64_t bits = 0;
+    for (auto i = 0; i < 6; i++)
+        bits |= static_cast<uint64_t>(input[2 + i]) << (i * 8);
+
+    for (auto i = 0; i < 16; i++)
+        rgba[i * 4 + channel] = palette[bits >> (i * 3) & 7];
+}
+
+CompressedFormat choose_compressed_format(const unsigned char *pixels, const int width, const int height, const int channels,
+                                          const bool normal_map)
+{
+    if (normal_map)
+        return COMPRESSED_FORMAT_BC5;
+
+    const auto count = static_cast<size_t>(width) * height;
+    auto has_alpha = false;
+    auto is_gray = channels <= 2;
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto pixel = pixels + i * channels;
+        if ((channels == 2 && pixel[1] < 255) || (channels == 4 && pixel[3] < 255))
+            has_alpha = true;
+        if (channels >= 3 && (pixel[0] != pixel[1] || pixel[0] != pixel[2]))
+            is_gray = false;
+    }
+
+    if (has_alpha)
+        return COMPRESSED_FORMAT_BC3;
+    return is_gray ? COMPRESSED_FORMAT_BC4 : COMPRESSED_FORMAT_BC1;
+}
+
+CompressedImage compress_image(const unsigned char *pixels, const int width, const int height, const int channels,
+                               const CompressedFormat format, const MipSettings& mip_settings)
+{
+    CompressedImage image;
+    if (pixels == nullptr || width <= 0 || height <= 0 || channels < 1 || channels > 4)
+        return image;
+    if (format != COMPRESSED_FORMAT_BC1 && format != COMPRESSED_FORMAT_BC3
+        && format != COMPRESSED_FORMAT_BC4 && format != COMPRESSED_FORMAT_BC5)
+        return image;
+
+    auto& thread_pool = ThreadPool::get_instance();
+    const auto mip_chain = generate_mip_chain(pixels, width, height, channels, mip_settings, &thread_pool);
+
+    // 先算出全部级别的布局
+    image.format = format;
+    image.levels.push_back({ static_cast<unsigned int>(width), static_cast<unsigned int>(height), 0,
+                             get_compressed_size(format, width, height) });
+    auto total_size = image.levels.back().size;
+    for (const auto& level : mip_chain.levels)
+    {
+        const auto size = get_compressed_size(format, level.width, level.height);
+        image.levels.push_back({ level.width, level.height, total_size, size });
+        total_size += size;
+    }
+    image.data.resize(total_size);
+
+    const auto block_size = get_block_size(format);
+    for (size_t level = 0, count = image.levels.size(); level < count; level++)
+    {
+        const auto& info = image.levels[level];
+        const auto blocks_x = (info.width + 3) / 4;
+        const auto blocks_y = (info.height + 3) / 4;
+        auto output = image.data.data() + info.offset;
+
+        const auto rgba = level == 0
+            ? expand_to_rgba(pixels, width, height, channels)
+            : expand_to_rgba(mip_chain.get_level_data(level - 1), info.width, info.height, channels);
+
+        // 按块行分组，每组一个任务
+        const auto group_count = std::min(blocks_y, thread_pool.get_thread_count() * 4);
+        const auto rows_per_group = (blocks_y + group_count - 1) / group_count;
+        std::vector<std::future<void>> tasks;
+        for (auto first_row = 0u; first_row < blocks_y; first_row += rows_per_group)
+        {
+            const auto last_row = std::min(blocks_y, first_row + rows_per_group);
+            const auto source = rgba.data();
+            tasks.push_back(thread_pool.submit([=]()
+            {
+                unsigned char block[64];
+                for (auto y = first_row; y < last_row; y++)
+                {
+                    for (auto x = 0u; x < blocks_x; x++)
+                    {
+                        fetch_block(source, info.width, info.height, x, y, block);
+                        encode_block(format, block, output + (static_cast<size_t>(y) * blocks_x + x) * block_size);
+                    }
+                }
+            }));
+        }
+        for (auto& task : tasks)
+            task.get();
+    }
+
+    return image;
+}
+
+bool decompress_level(const CompressedImage& image, const size_t level, std::vector<unsigned char>& rgba)
+{
+    if (level >= image.levels.size())
+        return false;
+
+    const auto format = image.format;
+    if (format != COMPRESSED_FORMAT_BC1 && format != COMPRESSED_FORMAT_BC3
+        && format != COMPRESSED_FORMAT_BC4 && format != COMPRESSED_FORMAT_BC5)
+        return false;
+
+    const auto& info = image.levels[level];
+    const auto blocks_x = (info.width + 3) / 4;
+    const auto blocks_y = (info.height + 3) / 4;
+    const auto block_size = get_block_size(format);
+    rgba.assign(static_cast<size_t>(info.width) * info.height * 4, 255);
+
+    unsigned char block[64];
+    for (auto by = 0u; by < blocks_y; by++)
+    {
+        for (auto bx = 0u; bx < blocks_x; bx++)
+        {
+            const auto input = image.get_level_data(level) + (static_cast<size_t>(by) * blocks_x + bx) * block_size;
+            std::memset(block, 255, sizeof(block));
+            switch (format)
+            {
+            case COMPRESSED_FORMAT_BC1:
+                decode_color_block(input, block, false);
+                break;
+            case COMPRESSED_FORMAT_BC3:
+                decode_color_block(input + 8, block, true);
+                decode_bc4_block(input, 3, block);
+                break;
+            case COMPRESSED_FORMAT_BC4:
+                decode_bc4_block(input, 0, block);
+                for (auto i = 0; i < 16; i++)
+                    block[i * 4 + 1] = block[i * 4 + 2] = block[i * 4];
+                break;
+            default:
+                decode_bc4_block(input, 0, block);
+                decode_bc4_block(input + 8, 1, block);
+                for (auto i = 0; i < 16; i++)
+                    block[i * 4 + 2] = reconstruct_normal_z(block[i * 4], block[i * 4 + 1]);
+                break;
+            }
+
+            // 只写回图片范围内的像素
+            for (auto y = 0u; y < 4 && by * 4 + y < info.height; y++)
+            {
+                for (auto x = 0u; x < 4 && bx * 4 + x < info.width; x++)
+                {
+                    std::memcpy(rgba.data() + ((static_cast<size_t>(by) * 4 + y) * info.width + bx * 4 + x) * 4,
+                                block + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+
+    return true;
+}
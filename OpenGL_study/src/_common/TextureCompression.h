@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MipGenerator.h"
+
+/**
+ * GPU 块压缩格式，均以 4x4 像素为一块
+ */
+enum CompressedFormat
+{
+    COMPRESSED_FORMAT_NONE,
+    COMPRESSED_FORMAT_BC1,          // RGB，8 字节/块
+    COMPRESSED_FORMAT_BC3,          // RGBA，16 字节/块
+    COMPRESSED_FORMAT_BC4,          // R，8 字节/块，适合灰度图（高光贴图等）
+    COMPRESSED_FORMAT_BC5,          // RG，16 字节/块，适合法线贴图（着色器用 normal_map.glsl 重建 z）
+    COMPRESSED_FORMAT_BC7,          // RGBA，16 字节/块，仅支持加载
+    COMPRESSED_FORMAT_ETC2_RGB,     // 仅支持加载，用于不支持 BCn 的平台
+    COMPRESSED_FORMAT_ETC2_RGBA,
+};
+
+/**
+ * 压缩后的图片及其全部 mip 级别，数据连续存放
+ */
+struct CompressedImage
+{
+    struct Level
+    {
+        unsigned int width;
+        unsigned int height;
+        size_t       offset;    // 在 data 中的偏移
+        size_t       size;
+    };
+
+    CompressedFormat           format = COMPRESSED_FORMAT_NONE;
+    std::vector<Level>         levels;
+    std::vector<unsigned char> data;
+
+    inline bool is_valid() const { return format != COMPRESSED_FORMAT_NONE && !levels.empty(); }
+    inline const unsigned char* get_level_data(const size_t level) const { return data.data() + levels[level].offset; }
+};
+
+unsigned int get_block_size(CompressedFormat format);
+size_t get_compressed_size(CompressedFormat format, unsigned int width, unsigned int height);
+// 对应的 OpenGL 内部格式
+unsigned int get_gl_internal_format(CompressedFormat format);
+const char* get_format_name(CompressedFormat format);
+
+// 单块编解码，rgba 为 4x4 像素按行存放的 RGBA8
+void encode_bc1_block(const unsigned char rgba[64], unsigned char output[8]);
+void encode_bc3_block(const unsigned char rgba[64], unsigned char output[16]);
+// 单通道，channel 为 rgba 中的分量下标
+void encode_bc4_block(const unsigned char rgba[64], unsigned int channel, unsigned char output[8]);
+void encode_bc5_block(const unsigned char rgba[64], unsigned char output[16]);
+
+void decode_bc1_block(const unsigned char input[8], unsigned char rgba[64]);
+void decode_bc4_block(const unsigned char input[8], unsigned int channel, unsigned char rgba[64]);
+
+// 按内容选择格式：单色用 BC4（上传时以 swizzle 把 R 复制到 G、B），有透明度用 BC3，否则 BC1；normal_map 为真时用 BC5
+CompressedFormat choose_compressed_format(const unsigned char *pixels, int width, int height, int channels,
+                                          bool normal_map);
+
+// 压缩整张图片，按 mip_settings 生成完整 mip 链（enabled 为假时只有一级）
+// mip 生成与块编码都按行分给 ThreadPool 并行，调用线程等待完成，不要在线程池工作线程中调用
+CompressedImage compress_image(const unsigned char *pixels, int width, int height, int channels,
+                               CompressedFormat format, const MipSettings& mip_settings = MipSettings());
+
+// 解压为 RGBA8，用于驱动不支持该格式时回退及误差统计，只支持 BC1/BC3/BC4/BC5
+bool decompress_level(const CompressedImage& image, size_t level, std::vector<unsigned char>& rgba);
@@ -0,0 +1,431 @@
+#include "TextureContainer.h"
+#include "MappedFile.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    const uint32_t KTX_ENDIANNESS = 0x04030201;
+
+    const uint32_t DDS_MAGIC        = 0x20534444;   // "DDS "
+    const uint32_t DDS_HEADER_SIZE  = 124;
+    const uint32_t DDS_PIXEL_FORMAT_SIZE = 32;
+    const uint32_t DDS_DX10_SIZE    = 20;
+
+    const uint32_t DDSD_CAPS        = 0x1;
+    const uint32_t DDSD_HEIGHT      = 0x2;
+    const uint32_t DDSD_WIDTH       = 0x4;
+    const uint32_t DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    const uint32_t DDSD_LINEARSIZE  = 0x80000;
+    const uint32_t DDPF_FOURCC      = 0x4;
+    const uint32_t DDSCAPS_COMPLEX  = 0x8;
+    const uint32_t DDSCAPS_TEXTURE  = 0x1000;
+    const uint32_t DDSCAPS_MIPMAP   = 0x400000;
+
+    const uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+    const uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+    constexpr uint32_t make_four_cc(const char a, const char b, const char c, const char d)
+    {
+        return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 | static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+    }
+
+    uint32_t read_u32(const unsigned char *data)
+    {
+        return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8
+             | static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+    }
+
+    uint32_t swap_u32(const uint32_t value)
+    {
+        return value >> 24 | (value >> 8 & 0xFF00) | (value << 8 & 0xFF0000) | value << 24;
+    }
+
+    void write_u32(std::ofstream& stream, const uint32_t value)
+    {
+        const unsigned char bytes[4] = {
+            static_cast<unsigned char>(value & 0xFF), static_cast<unsigned char>(value >> 8 & 0xFF),
+            static_cast<unsigned char>(value >> 16 & 0xFF), static_cast<unsigned char>(value >> 24 & 0xFF),
+        };
+        stream.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    }
+
+    CompressedFormat format_from_four_cc(const uint32_t four_cc)
+    {
+        switch (four_cc)
+        {
+        case make_four_cc('D', 'X', 'T', '1'): return COMPRESSED_FORMAT_BC1;
+        case make_four_cc('D', 'X', 'T', '5'): return COMPRESSED_FORMAT_BC3;
+        case make_four_cc('A', 'T', 'I', '1'):
+        case make_four_cc('B', 'C', '4', 'U'): return COMPRESSED_FORMAT_BC4;
+        case make_four_cc('A', 'T', 'I', '2'):
+        case make_four_cc('B', 'C', '5', 'U'): return COMPRESSED_FORMAT_BC5;
+        default:                               return COMPRESSED_FORMAT_NONE;
+        }
+    }
+
+    uint32_t four_cc_from_format(const CompressedFormat format)
+    {
+        switch (format)
+        {
+        case COMPRESSED_FORMAT_BC1: return make_four_cc('D', 'X', 'T', '1');
+        case COMPRESSED_FORMAT_BC3: return make_four_cc('D', 'X', 'T', '5');
+        case COMPRESSED_FORMAT_BC4: return make_four_cc('B', 'C', '4', 'U');
+        case COMPRESSED_FORMAT_BC5: return make_four_cc('B', 'C', '5', 'U');
+        case COMPRESSED_FORMAT_BC7: return make_four_cc('D', 'X', '1', '0');
+        default:                    return 0;
+        }
+    }
+
+    CompressedFormat format_from_dxgi(const uint32_t dxgi_format)
+    {
+        switch (dxgi_format)
+        {
+        case 71: case 72: return COMPRESSED_FORMAT_BC1;
+        case 77: case 78: return COMPRESSED_FORMAT_BC3;
+        case 80:          return COMPRESSED_FORMAT_BC4;
+        case 83:          return COMPRESSED_FORMAT_BC5;
+        case 98: case 99: return COMPRESSED_FORMAT_BC7;
+        default:          return COMPRESSED_FORMAT_NONE;
+        }
+    }
+
+    CompressedFormat format_from_gl(const uint32_t internal_format)
+    {
+        const CompressedFormat formats[] = {
+            COMPRESSED_FORMAT_BC1, COMPRESSED_FORMAT_BC3, COMPRESSED_FORMAT_BC4, COMPRESSED_FORMAT_BC5,
+            COMPRESSED_FORMAT_BC7, COMPRESSED_FORMAT_ETC2_RGB, COMPRESSED_FORMAT_ETC2_RGBA,
+        };
+        for (const auto format : formats)
+        {
+            if (get_gl_internal_format(format) == internal_format)
+                return format;
+        }
+        return COMPRESSED_FORMAT_NONE;
+    }
+
+    // 依次排出各 mip 级别，数据须紧密排列
+    bool build_levels(CompressedImage& image, const unsigned int width, const unsigned int height, const unsigned int level_count,
+                      const unsigned char *data, const size_t size)
+    {
+        image.levels.clear();
+
+        auto level_width = width, level_height = height;
+        size_t offset = 0;
+        for (auto i = 0u; i < level_count; i++)
+        {
+            const auto level_size = get_compressed_size(image.format, level_width, level_height);
+            if (offset + level_size > size)
+                return false;
+
+            image.levels.push_back({ level_width, level_height, offset, level_size });
+            offset += level_size;
+            level_width = std::max(1u, level_width / 2);
+            level_height = std::max(1u, level_height / 2);
+        }
+
+        image.data.assign(data, data + offset);
+        return true;
+    }
+
+    bool has_extension(const std::string& filepath, const char *extension)
+    {
+        const auto length = std::strlen(extension);
+        if (filepath.size() < length)
+            return false;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            const auto c = filepath[filepath.size() - length + i];
+            if (std::tolower(static_cast<unsigned char>(c)) != extension[i])
+                return false;
+        }
+        return true;
+    }
+}
+
+bool load_texture_container(const std::string& filepath, CompressedImage& image)
+{
+    const MappedFile file(filepath);
+    if (!file.is_valid())
+    {
+        std::cout << "[ERROR] TextureContainer: failed to open " << filepath << std::endl;
+        return false;
+    }
+    return load_texture_container(file.get_data(), file.get_size(), filepath, image);
+}
+
+bool load_texture_container(const unsigned char *data, const size_t size, const std::string& name, CompressedImage& image)
+{
+    if (size >= 4 && read_u32(data) == DDS_MAGIC)
+        return load_dds(data, size, name, image);
+    if (size >= sizeof(KTX_IDENTIFIER) && std::memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0)
+        return load_ktx(data, size, name, image);
+
+    std::cout << "[ERROR] TextureContainer: unknown container format " << name << std::endl;
+    return false;
+}
+
+bool load_dds(const std::string& filepath, CompressedImage& image)
+{
+    const MappedFile file(filepath);
+    return load_dds(file.get_data(), file.get_size(), filepath, image);
+}
+
+bool load_dds(const unsigned char *data, const size_t size, const std::string& filepath, CompressedImage& image)
+{
+    image = CompressedImage();
+
+    if (data == nullptr || size < 4 + DDS_HEADER_SIZE || read_u32(data) != DDS_MAGIC || read_u32(data + 4) != DDS_HEADER_SIZE)
+    {
+        std::cout << "[ERROR] TextureContainer: invalid DDS file " << filepath << std::endl;
+        return false;
+    }
+
+    const auto header = data + 4;
+    const auto height = read_u32(header + 8);
+    const auto width = read_u32(header + 12);
+    const auto flags = read_u32(header + 4);
+    const auto mip_count = (flags & DDSD_MIPMAPCOUNT) ? std::max(1u, read_u32(header + 24)) : 1u;
+    const auto pixel_format = header + 72;
+    const auto four_cc = read_u32(pixel_format + 8);
+
+    size_t data_offset = 4 + DDS_HEADER_SIZE;
+    if (!(read_u32(pixel_format + 4) & DDPF_FOURCC))
+    {
+        std::cout << "[ERROR] TextureContainer: uncompressed DDS is not supported " << filepath << std::endl;
+        return false;
+    }
+
+    if (four_cc == make_four_cc('D', 'X', '1', '0'))
+    {
+        if (size < data_offset + DDS_DX10_SIZE)
+        {
+            std::cout << "[ERROR] TextureContainer: truncated DX10 header " << filepath << std::endl;
+            return false;
+        }
+
+        const auto dx10 = data + data_offset;
+        if (read_u32(dx10 + 4) != D3D10_RESOURCE_DIMENSION_TEXTURE2D || read_u32(dx10 + 12) > 1)
+        {
+            std::cout << "[ERROR] TextureContainer: only single 2D DDS textures are supported " << filepath << std::endl;
+            return false;
+        }
+        image.format = format_from_dxgi(read_u32(dx10));
+        data_offset += DDS_DX10_SIZE;
+    }
+    else
+    {
+        image.format = format_from_four_cc(four_cc);
+    }
+
+    if (image.format == COMPRESSED_FORMAT_NONE)
+    {
+        std::cout << "[ERROR] TextureContainer: unsupported DDS format " << filepath << std::endl;
+        return false;
+    }
+
+    if (width == 0 || height == 0 || !build_levels(image, width, height, mip_count, data + data_offset, size - data_offset))
+    {
+        std::cout << "[ERROR] TextureContainer: truncated DDS data " << filepath << std::endl;
+        image = CompressedImage();
+        return false;
+    }
+
+    return true;
+}
+
+bool load_ktx(const std::string& filepath, CompressedImage& image)
+{
+    const MappedFile file(filepath);
+    return load_ktx(file.get_data(), file.get_size(), filepath, image);
+}
+
+bool load_ktx(const unsigned char *data, const size_t size, const std::string& filepath, CompressedImage& image)
+{
+    image = CompressedImage();
+
+    // 标识符 12 字节 + 13 个 uint32 字段
+    const size_t header_size = sizeof(KTX_IDENTIFIER) + 13 * 4;
+
+    if (data == nullptr || size < header_size || std::memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0)
+    {
+        std::cout << "[ERROR] TextureContainer: invalid KTX file " << filepath << std::endl;
+        return false;
+    }
+
+    const auto fields = data + sizeof(KTX_IDENTIFIER);
+    const auto endianness = read_u32(fields);
+    if (endianness != KTX_ENDIANNESS && swap_u32(endianness) != KTX_ENDIANNESS)
+    {
+        std::cout << "[ERROR] TextureContainer: invalid KTX endianness " << filepath << std::endl;
+        return false;
+    }
+    const auto swap = endianness != KTX_ENDIANNESS;
+    const auto field = [&](const int index) { const auto value = read_u32(fields + index * 4); return swap ? swap_u32(value) : value; };
+
+    const auto gl_type = field(1);
+    const auto internal_format = field(4);
+    const auto width = field(6);
+    const auto height = field(7);
+    const auto depth = field(8);
+    const auto array_count = field(9);
+    const auto face_count = field(10);
+    const auto mip_count = std::max(1u, field(11));
+    const auto key_value_size = field(12);
+
+    if (gl_type != 0 || depth > 1 || array_count > 1 || face_count != 1 || width == 0 || height == 0)
+    {
+        std::cout << "[ERROR] TextureContainer: only single compressed 2D KTX textures are supported " << filepath << std::endl;
+        return false;
+    }
+
+    image.format = format_from_gl(internal_format);
+    if (image.format == COMPRESSED_FORMAT_NONE)
+    {
+        std::cout << "[ERROR] TextureContainer: unsupported KTX internal format " << filepath << std::endl;
+        return false;
+    }
+
+    // 每级前有 4 字节 imageSize，级别数据按 4 字节对齐（压缩块天然满足）
+    auto offset = header_size + key_value_size;
+    auto level_width = width, level_height = height;
+    size_t total_size = 0;
+    for (auto i = 0u; i < mip_count; i++)
+    {
+        if (offset + 4 > size)
+            break;
+
+        const auto stored_size = swap ? swap_u32(read_u32(data + offset)) : read_u32(data + offset);
+        const auto level_size = get_compressed_size(image.format, level_width, level_height);
+        if (stored_size != level_size || offset + 4 + level_size > size)
+            break;
+
+        image.levels.push_back({ level_width, level_height, total_size, level_size });
+        image.data.insert(image.data.end(), data + offset + 4, data + offset + 4 + level_size);
+        total_size += level_size;
+        offset += 4 + ((level_size + 3) & ~static_cast<size_t>(3));
+        level_width = std::max(1u, level_width / 2);
+        level_height = std::max(1u, level_height / 2);
+    }
+
+    if (image.levels.size() != mip_count)
+    {
+        std::cout << "[ERROR] TextureContainer: truncated KTX data " << filepath << std::endl;
+        image = CompressedImage();
+        return false;
+    }
+
+    return true;
+}
+
+bool save_dds(const std::string& filepath, const CompressedImage& image)
+{
+    const auto four_cc = four_cc_from_format(image.format);
+    if (!image.is_valid() || four_cc == 0)
+    {
+        std::cout << "[ERROR] TextureContainer: DDS does not support format " << get_format_name(image.format) << std::endl;
+        return false;
+    }
+
+    std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        std::cout << "[ERROR] TextureContainer: failed to create " << filepath << std::endl;
+        return false;
+    }
+
+    const auto& base = image.levels.front();
+    const auto mip_count = static_cast<uint32_t>(image.levels.size());
+
+    write_u32(stream, DDS_MAGIC);
+    write_u32(stream, DDS_HEADER_SIZE);
+    write_u32(stream, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | (mip_count > 1 ? DDSD_MIPMAPCOUNT : 0));
+    write_u32(stream, base.height);
+    write_u32(stream, base.width);
+    write_u32(stream, static_cast<uint32_t>(base.size));    // pitchOrLinearSize
+    write_u32(stream, 0);                                   // depth
+    write_u32(stream, mip_count);
+    for (auto i = 0; i < 11; i++)
+        write_u32(stream, 0);                               // reserved1
+
+    write_u32(stream, DDS_PIXEL_FORMAT_SIZE);
+    write_u32(stream, DDPF_FOURCC);
+    write_u32(stream, four_cc);
+    for (auto i = 0; i < 5; i++)
+        write_u32(stream, 0);                               // RGB 位数与掩码
+
+    write_u32(stream, DDSCAPS_TEXTURE | (mip_count > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0));
+    for (auto i = 0; i < 4; i++)
+        write_u32(stream, 0);                               // caps2..4, reserved2
+
+    if (image.format == COMPRESSED_FORMAT_BC7)
+    {
+        write_u32(stream, DXGI_FORMAT_BC7_UNORM);
+        write_u32(stream, D3D10_RESOURCE_DIMENSION_TEXTURE2D);
+        write_u32(stream, 0);                               // miscFlag
+        write_u32(stream, 1);                               // arraySize
+        write_u32(stream, 0);                               // miscFlags2
+    }
+
+    stream.write(reinterpret_cast<const char*>(image.data.data()), static_cast<std::streamsize>(image.data.size()));
+    return static_cast<bool>(stream);
+}
+
+bool save_ktx(const std::string& filepath, const CompressedImage& image)
+{
+    if (!image.is_valid())
+        return false;
+
+    std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        std::cout << "[ERROR] TextureContainer: failed to create " << filepath << std::endl;
+        return false;
+    }
+
+    const auto& base = image.levels.front();
+    const auto internal_format = get_gl_internal_format(image.format);
+    const uint32_t base_internal_format =
+        image.format == COMPRESSED_FORMAT_BC4 ? GL_RED :
+        image.format == COMPRESSED_FORMAT_BC5 ? GL_RG :
+        image.format == COMPRESSED_FORMAT_BC1 || image.format == COMPRESSED_FORMAT_ETC2_RGB ? GL_RGB : GL_RGBA;
+
+    stream.write(reinterpret_cast<const char*>(KTX_IDENTIFIER), sizeof(KTX_IDENTIFIER));
+    write_u32(stream, KTX_ENDIANNESS);
+    write_u32(stream, 0);                   // glType，压缩格式为 0
+    write_u32(stream, 1);                   // glTypeSize
+    write_u32(stream, 0);                   // glFormat
+    write_u32(stream, internal_format);
+    write_u32(stream, base_internal_format);
+    write_u32(stream, base.width);
+    write_u32(stream, base.height);
+    write_u32(stream, 0);                   // pixelDepth
+    write_u32(stream, 0);                   // numberOfArrayElements
+    write_u32(stream, 1);                   // numberOfFaces
+    write_u32(stream, static_cast<uint32_t>(image.levels.size()));
+    write_u32(stream, 0);                   // bytesOfKeyValueData
+
+    static const char padding[4] = {};
+    for (size_t i = 0, count = image.levels.size(); i < count; i++)
+    {
+        const auto& level = image.levels[i];
+        write_u32(stream, static_cast<uint32_t>(level.size));
+        stream.write(reinterpret_cast<const char*>(image.get_level_data(i)), static_cast<std::streamsize>(level.size));
+        stream.write(padding, static_cast<std::streamsize>((4 - level.size % 4) % 4));
+    }
+
+    return static_cast<bool>(stream);
+}
+
+bool is_texture_container_path(const std::string& filepath)
+{
+    return has_extension(filepath, ".dds") || has_extension(filepath, ".ktx");
+}
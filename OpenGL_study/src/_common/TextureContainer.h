@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+#include "TextureCompression.h"
+
+/**
+ * 预压缩纹理容器的读写，支持 DDS（含 DX10 扩展头）与 KTX 1.1
+ * 只处理单张二维纹理，文件中须存放全部 mip 级别（至少一级）
+ */
+
+// 按文件头自动识别 DDS / KTX
+bool load_texture_container(const std::string& filepath, CompressedImage& image);
+// 从内存读取（如资源包中的条目），name 只用于日志
+bool load_texture_container(const unsigned char *data, size_t size, const std::string& name, CompressedImage& image);
+
+bool load_dds(const std::string& filepath, CompressedImage& image);
+bool load_dds(const unsigned char *data, size_t size, const std::string& name, CompressedImage& image);
+bool load_ktx(const std::string& filepath, CompressedImage& image);
+bool load_ktx(const unsigned char *data, size_t size, const std::string& name, CompressedImage& image);
+
+// DDS 写入传统 FourCC 头，BC7 写入 DX10 扩展头
+bool save_dds(const std::string& filepath, const CompressedImage& image);
+bool save_ktx(const std::string& filepath, const CompressedImage& image);
+
+// 扩展名为 .dds 或 .ktx
+bool is_texture_container_path(const std::string& filepath);
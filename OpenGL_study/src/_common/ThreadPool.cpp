@@ -0,0 +1,53 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int thread_count)
+    : stop_(false)
+{
+    // 默认保留一个核心给 OpenGL 上下文线程
+    if (thread_count == 0)
+    {
+        const auto hardware_count = std::thread::hardware_concurrency();
+        thread_count = hardware_count > 1 ? hardware_count - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < thread_count; i++)
+        workers_.emplace_back(&ThreadPool::worker_loop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+ThreadPool& ThreadPool::get_instance()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+void ThreadPool::worker_loop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+
+            if (stop_ && tasks_.empty())
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * 固定大小的工作线程池，用于不依赖 OpenGL 上下文的后台任务（如图片解码）
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread>          workers_;
+    std::queue<std::function<void()>> tasks_;
+
+    std::mutex              mutex_;
+    std::condition_variable condition_;
+    bool                    stop_;
+
+public:
+    ThreadPool(unsigned int thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& func) -> std::future<decltype(func())>
+    {
+        using ResultType = decltype(func());
+
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(func));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([task]() { (*task)(); });
+        }
+        condition_.notify_one();
+        return result;
+    }
+
+    inline unsigned int get_thread_count() const { return static_cast<unsigned int>(workers_.size()); }
+
+    // 进程内共享的线程池
+    static ThreadPool& get_instance();
+
+private:
+    void worker_loop();
+};
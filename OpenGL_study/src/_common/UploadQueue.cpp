@@ -0,0 +1,64 @@
+#include "UploadQueue.h"
+
+#include <utility>
+
+UploadQueue::UploadQueue(const size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1)
+{
+}
+
+UploadQueue& UploadQueue::get_instance()
+{
+    // 不随静态对象析构，退出时仍在收尾的工作线程可以安全访问
+    static auto instance = new UploadQueue();
+    return *instance;
+}
+
+bool UploadQueue::push(std::function<void()> task, const std::function<bool()>& cancelled)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (tasks_.size() >= capacity_)
+    {
+        if (cancelled != nullptr && cancelled())
+            return false;
+
+        // 定时醒来检查是否被取消
+        not_full_.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    tasks_.push(std::move(task));
+    return true;
+}
+
+unsigned int UploadQueue::pump(const float budget_ms)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float, std::milli>(budget_ms);
+
+    unsigned int executed = 0;
+    do
+    {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tasks_.empty())
+                break;
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        not_full_.notify_one();
+
+        task();
+        executed++;
+    }
+    while (std::chrono::steady_clock::now() - start_time < budget);
+
+    return executed;
+}
+
+size_t UploadQueue::get_pending_count()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+
+/**
+ * 工作线程向 OpenGL 上下文线程提交上传任务的有界队列
+ *
+ * 工作线程 push，队列满时阻塞，避免解码结果无限堆积；
+ * 上下文线程每帧调用 pump，在时间预算内执行任务，大模型导入不会造成单帧卡顿
+ */
+class UploadQueue
+{
+private:
+    std::queue<std::function<void()>> tasks_;
+    size_t capacity_;
+
+    std::mutex              mutex_;
+    std::condition_variable not_full_;
+
+public:
+    UploadQueue(size_t capacity = 64);
+
+    UploadQueue(const UploadQueue&) = delete;
+    UploadQueue& operator=(const UploadQueue&) = delete;
+
+    // 提交任务，队列满时等待；等待期间 cancelled 返回 true 则放弃并返回 false
+    bool push(std::function<void()> task, const std::function<bool()>& cancelled = nullptr);
+
+    // 在上下文线程执行任务直到用完预算（毫秒），至少执行一个，返回执行数量
+    unsigned int pump(float budget_ms);
+
+    // 在上下文线程等待工作线程结果，等待期间持续执行上传任务，避免与阻塞的生产者互相等待
+    template <typename T>
+    T wait(std::future<T>& future)
+    {
+        while (future.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+            pump(0.0f);
+        return future.get();
+    }
+
+    size_t get_pending_count();
+
+    // 进程内共享的上传队列
+    static UploadQueue& get_instance();
+};
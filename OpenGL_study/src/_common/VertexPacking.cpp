@@ -0,0 +1,100 @@
+#include "VertexPacking.h"
+#include "Mesh.h"
+
+namespace
+{
+    int16_t to_snorm16(const float value)
+    {
+        return static_cast<int16_t>(glm::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    glm::vec2 sign_not_zero(const glm::vec2& value)
+    {
+        return { value.x >= 0.0f ? 1.0f : -1.0f, value.y >= 0.0f ? 1.0f : -1.0f };
+    }
+}
+
+glm::vec2 encode_octahedral(const glm::vec3& normal)
+{
+    const auto length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+    if (length <= 0.0f)
+        return glm::vec2(0.0f);
+
+    const auto n = normal / length;
+    const glm::vec2 xy(n.x, n.y);
+    if (n.z >= 0.0f)
+        return xy;
+
+    // 下半球折叠到四个角
+    return (1.0f - glm::abs(glm::vec2(n.y, n.x))) * sign_not_zero(xy);
+}
+
+glm::vec3 decode_octahedral(const glm::vec2& encoded)
+{
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y));
+    const auto t = glm::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+PackedVertices pack_vertices(const VertexData *vertices, const unsigned int vertex_count)
+{
+    PackedVertices packed;
+    packed.vertices.resize(vertex_count);
+    packed.position_offset = glm::vec3(0.0f);
+    packed.position_scale = glm::vec3(1.0f);
+
+    if (vertex_count == 0)
+        return packed;
+
+    auto min_position = vertices[0].position;
+    auto max_position = vertices[0].position;
+    for (unsigned int i = 1; i < vertex_count; i++)
+    {
+        min_position = glm::min(min_position, vertices[i].position);
+        max_position = glm::max(max_position, vertices[i].position);
+    }
+
+    // 扁平网格某一轴长度为 0，避免除零
+    packed.position_offset = (min_position + max_position) * 0.5f;
+    packed.position_scale = glm::max((max_position - min_position) * 0.5f, glm::vec3(1e-6f));
+
+    for (unsigned int i = 0; i < vertex_count; i++)
+    {
+        const auto& vertex = vertices[i];
+        auto& result = packed.vertices[i];
+
+        const auto position = (vertex.position - packed.position_offset) / packed.position_scale;
+        result.position[0] = to_snorm16(position.x);
+        result.position[1] = to_snorm16(position.y);
+        result.position[2] = to_snorm16(position.z);
+        result.position[3] = 0;
+
+        const auto normal = encode_octahedral(vertex.normal);
+        result.normal[0] = to_snorm16(normal.x);
+        result.normal[1] = to_snorm16(normal.y);
+
+        const auto tex_coords = glm::packHalf2x16(vertex.tex_coords);
+        result.tex_coords[0] = static_cast<uint16_t>(tex_coords & 0xFFFF);
+        result.tex_coords[1] = static_cast<uint16_t>(tex_coords >> 16);
+
+        // 副切线只保留相对 cross(N, T) 的方向
+        const auto handedness = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+        const auto tangent_length = glm::length(vertex.tangent);
+        const auto tangent = tangent_length > 0.0f ? vertex.tangent / tangent_length : glm::vec3(0.0f);
+        result.tangent = glm::packSnorm3x10_1x2(glm::vec4(tangent, handedness));
+    }
+
+    return packed;
+}
+
+VertexBufferLayout packed_vertex_layout()
+{
+    VertexBufferLayout layout;
+    layout.push<short>(4);              // 顶点位置
+    layout.push<short>(2);              // 顶点法线
+    layout.push<HalfFloat>(2);          // 顶点纹理
+    layout.push<PackedInt2101010>(4);   // 切线向量与副切线方向
+    return layout;
+}
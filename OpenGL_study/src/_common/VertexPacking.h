@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MOS_glm.h"
+#include "VertexBufferLayout.h"
+
+struct VertexData;
+
+/**
+ * 压缩顶点数据，20 字节（VertexData 为 56 字节）
+ *
+ * 着色器中需要解码：
+ * 位置   = u_PositionOffset + a_Position * u_PositionScale
+ * 法线   = 八面体解码(a_Normal)
+ * 副切线 = cross(法线, a_Tangent.xyz) * sign(a_Tangent.w)
+ */
+struct PackedVertexData
+{
+    int16_t  position[4];       // 相对网格包围盒的 snorm16，w 未使用，用于 4 字节对齐
+    int16_t  normal[2];         // 八面体编码法线，snorm16
+    uint16_t tex_coords[2];     // 半精度纹理坐标
+    uint32_t tangent;           // GL_INT_2_10_10_10_REV，xyz 为切线，w 为副切线方向
+};
+
+static_assert(sizeof(PackedVertexData) == 20, "PackedVertexData must be tightly packed");
+
+/**
+ * 压缩后的网格顶点，以及还原位置所需的包围盒参数
+ */
+struct PackedVertices
+{
+    std::vector<PackedVertexData> vertices;
+    glm::vec3 position_offset;  // 包围盒中心
+    glm::vec3 position_scale;   // 包围盒半边长
+};
+
+// 八面体编码：单位向量映射到 [-1, 1]^2
+glm::vec2 encode_octahedral(const glm::vec3& normal);
+glm::vec3 decode_octahedral(const glm::vec2& encoded);
+
+PackedVertices pack_vertices(const VertexData *vertices, unsigned int vertex_count);
+
+// 与 PackedVertexData 对应的顶点布局，属性位置依次为 位置、法线、纹理坐标、切线
+VertexBufferLayout packed_vertex_layout();
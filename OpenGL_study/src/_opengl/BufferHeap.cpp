@@ -0,0 +1,204 @@
+#include "BufferHeap.h"
+
+#include <algorithm>
+#include <utility>
+
+BufferHeap::BufferHeap(std::string name, const unsigned int page_size)
+    : name_(std::move(name)), page_size_(page_size)
+{
+}
+
+BufferHeap::~BufferHeap()
+{
+    for (auto& page : pages_)
+        GLCall(glDeleteBuffers(1, &page.renderer_id));
+}
+
+unsigned int BufferHeap::allocate(const void *data, const unsigned int size, const unsigned int alignment)
+{
+    if (size == 0)
+        return BUFFER_HEAP_INVALID;
+
+    OffsetAllocation allocation { 0, 0, OFFSET_ALLOCATOR_INVALID };
+    unsigned int page = 0;
+    for (const auto count = pages_.size(); page < count; page++)
+    {
+        allocation = pages_[page].allocator.allocate(size, alignment);
+        if (allocation.node != OFFSET_ALLOCATOR_INVALID)
+            break;
+    }
+
+    // 现有页都放不下时新建一页，超大的分配单独占一页
+    if (allocation.node == OFFSET_ALLOCATOR_INVALID)
+    {
+        page = create_page(std::max(page_size_, size + alignment));
+        allocation = pages_[page].allocator.allocate(size, alignment);
+        if (allocation.node == OFFSET_ALLOCATOR_INVALID)
+        {
+            std::cout << "[ERROR] BufferHeap " << name_ << ": failed to allocate " << size << " bytes" << std::endl;
+            return BUFFER_HEAP_INVALID;
+        }
+    }
+
+    unsigned int handle;
+    if (!free_entries_.empty())
+    {
+        handle = free_entries_.back();
+        free_entries_.pop_back();
+    }
+    else
+    {
+        handle = static_cast<unsigned int>(entries_.size());
+        entries_.emplace_back();
+    }
+    entries_[handle] = { page, allocation, alignment, true };
+
+    if (data != nullptr)
+        update(handle, data, size);
+
+    return handle;
+}
+
+void BufferHeap::update(const unsigned int handle, const void *data, const unsigned int size, const unsigned int offset) const
+{
+    // 使用 GL_COPY_WRITE_BUFFER，不影响当前 VertexArray 的索引缓冲绑定
+    const auto& entry = entries_[handle];
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, pages_[entry.page].renderer_id));
+    GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, entry.allocation.offset + offset, size, data));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+}
+
+void BufferHeap::free(const unsigned int handle)
+{
+    if (handle >= entries_.size() || !entries_[handle].live)
+        return;
+
+    auto& entry = entries_[handle];
+    pages_[entry.page].allocator.free(entry.allocation);
+    entry.live = false;
+    free_entries_.push_back(handle);
+}
+
+unsigned int BufferHeap::defragment()
+{
+    unsigned int moved = 0;
+    for (unsigned int page = 0, count = static_cast<unsigned int>(pages_.size()); page < count; page++)
+    {
+        auto& allocator = pages_[page].allocator;
+        if (allocator.get_allocation_count() == 0 || allocator.get_largest_free_block() == allocator.get_free_size())
+            continue;
+
+        // 按原偏移顺序在新的分配器中重新分配，全部放得下才提交
+        std::vector<unsigned int> handles;
+        for (unsigned int i = 0, entry_count = static_cast<unsigned int>(entries_.size()); i < entry_count; i++)
+        {
+            if (entries_[i].live && entries_[i].page == page)
+                handles.push_back(i);
+        }
+        std::sort(handles.begin(), handles.end(), [this](const unsigned int a, const unsigned int b)
+        {
+            return entries_[a].allocation.offset < entries_[b].allocation.offset;
+        });
+
+        OffsetAllocator packed(allocator.get_size());
+        std::vector<OffsetAllocation> allocations;
+        for (const auto handle : handles)
+        {
+            allocations.push_back(packed.allocate(entries_[handle].allocation.size, entries_[handle].alignment));
+            if (allocations.back().node == OFFSET_ALLOCATOR_INVALID)
+                break;
+        }
+        if (allocations.back().node == OFFSET_ALLOCATOR_INVALID)
+            continue;
+
+        // 先拷到临时缓冲再拷回，避免同一缓冲内区间重叠
+        unsigned int temp_buffer;
+        GLCall(glGenBuffers(1, &temp_buffer));
+        GLCall(glBindBuffer(GL_COPY_READ_BUFFER, pages_[page].renderer_id));
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, temp_buffer));
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, allocator.get_size(), nullptr, GL_STREAM_COPY));
+
+        for (size_t i = 0, handle_count = handles.size(); i < handle_count; i++)
+        {
+            auto& entry = entries_[handles[i]];
+            GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                       entry.allocation.offset, allocations[i].offset, allocations[i].size));
+            if (allocations[i].offset != entry.allocation.offset)
+                moved += allocations[i].size;
+            entry.allocation = allocations[i];
+        }
+        allocator = std::move(packed);
+
+        GLCall(glBindBuffer(GL_COPY_READ_BUFFER, temp_buffer));
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, pages_[page].renderer_id));
+        for (const auto handle : handles)
+        {
+            const auto& allocation = entries_[handle].allocation;
+            GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                       allocation.offset, allocation.offset, allocation.size));
+        }
+
+        GLCall(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+        GLCall(glDeleteBuffers(1, &temp_buffer));
+    }
+
+    return moved;
+}
+
+unsigned int BufferHeap::get_allocation_count() const
+{
+    unsigned int count = 0;
+    for (const auto& page : pages_)
+        count += page.allocator.get_allocation_count();
+    return count;
+}
+
+unsigned int BufferHeap::get_capacity() const
+{
+    unsigned int capacity = 0;
+    for (const auto& page : pages_)
+        capacity += page.allocator.get_size();
+    return capacity;
+}
+
+unsigned int BufferHeap::get_used_size() const
+{
+    unsigned int used = 0;
+    for (const auto& page : pages_)
+        used += page.allocator.get_size() - page.allocator.get_free_size();
+    return used;
+}
+
+unsigned int BufferHeap::get_largest_free_block() const
+{
+    unsigned int largest = 0;
+    for (const auto& page : pages_)
+        largest = std::max(largest, page.allocator.get_largest_free_block());
+    return largest;
+}
+
+BufferHeap& BufferHeap::get_vertex_heap()
+{
+    // 与 UploadQueue 相同，不随静态对象析构（此时上下文可能已销毁）
+    static auto heap = new BufferHeap("vertex");
+    return *heap;
+}
+
+BufferHeap& BufferHeap::get_index_heap()
+{
+    static auto heap = new BufferHeap("index", 4 * 1024 * 1024);
+    return *heap;
+}
+
+unsigned int BufferHeap::create_page(const unsigned int size)
+{
+    unsigned int renderer_id;
+    GLCall(glGenBuffers(1, &renderer_id));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id));
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STATIC_DRAW));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+
+    pages_.push_back({ renderer_id, OffsetAllocator(size) });
+    return static_cast<unsigned int>(pages_.size() - 1);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "OffsetAllocator.h"
+
+const unsigned int BUFFER_HEAP_INVALID = 0xFFFFFFFF;
+
+/**
+ * 显存缓冲堆
+ *
+ * 由若干大块 OpenGL 缓冲（页）组成，用 OffsetAllocator 在页内划分子区间，
+ * 多个网格的顶点或索引共用同一个缓冲对象，绘制时以偏移 / base vertex 区分。
+ * 分配以句柄表示，碎片整理只在页内移动数据，缓冲对象不变，使用方每次绘制时重新查询偏移。
+ * 所有函数必须在 OpenGL 上下文线程调用
+ */
+class BufferHeap
+{
+private:
+    struct Page
+    {
+        unsigned int    renderer_id;
+        OffsetAllocator allocator;
+    };
+
+    struct Entry
+    {
+        unsigned int     page;
+        OffsetAllocation allocation;
+        unsigned int     alignment;
+        bool             live;
+    };
+
+    std::string  name_;
+    unsigned int page_size_;
+    std::vector<Page>         pages_;
+    std::vector<Entry>        entries_;
+    std::vector<unsigned int> free_entries_;
+
+public:
+    BufferHeap(std::string name, unsigned int page_size = 16 * 1024 * 1024);
+    ~BufferHeap();
+
+    BufferHeap(const BufferHeap&) = delete;
+    BufferHeap& operator=(const BufferHeap&) = delete;
+
+    // 分配并上传，返回句柄，失败时返回 BUFFER_HEAP_INVALID
+    // offset 保证是 alignment 的整数倍，顶点数据传步长即可用 offset / 步长作为 base vertex
+    unsigned int allocate(const void *data, unsigned int size, unsigned int alignment);
+    // 覆盖已分配区间中的一段
+    void update(unsigned int handle, const void *data, unsigned int size, unsigned int offset = 0) const;
+    void free(unsigned int handle);
+
+    // 逐页压实存活的分配，返回移动的字节数
+    unsigned int defragment();
+
+    inline unsigned int get_buffer(const unsigned int handle) const { return pages_[entries_[handle].page].renderer_id; }
+    inline unsigned int get_offset(const unsigned int handle) const { return entries_[handle].allocation.offset; }
+    inline unsigned int get_size(const unsigned int handle) const { return entries_[handle].allocation.size; }
+
+    inline unsigned int get_page_count() const { return static_cast<unsigned int>(pages_.size()); }
+    unsigned int get_allocation_count() const;
+    unsigned int get_capacity() const;
+    unsigned int get_used_size() const;
+    // 各页中最大的空闲块，远小于空闲总量时说明碎片较多
+    unsigned int get_largest_free_block() const;
+
+    // 全局的顶点与索引缓冲堆，网格默认从这里分配
+    static BufferHeap& get_vertex_heap();
+    static BufferHeap& get_index_heap();
+
+private:
+    unsigned int create_page(unsigned int size);
+};
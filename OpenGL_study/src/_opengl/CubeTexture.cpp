@@ -1,60 +1,182 @@
 #include "CubeTexture.h"
+#include "GLState.h"
+#include "ThreadPool.h"
+#include "UploadQueue.h"
+
+#include <algorithm>
+#include <future>
 #include <utility>
 
-CubeTexture::CubeTexture(std::vector<std::string> face_paths)
-    : renderer_id_(0), face_paths_(std::move(face_paths))
+CubeTexture::CubeTexture(std::vector<std::string> face_paths, const bool mipmaps)
+    : renderer_id_(0), width_(0), height_(0), mipmaps_(mipmaps), face_paths_(std::move(face_paths))
 {
     GLCall(glGenTextures(1, &renderer_id_));
-    GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, renderer_id_));
 
-    stbi_set_flip_vertically_on_load(1);
+    MipSettings mip_settings;
+    mip_settings.enabled = mipmaps_;
 
-    int width, height, nr_channels;
-    for (size_t i = 0, count = face_paths_.size(); i < count; i++)
-    {
-        auto *data = stbi_load(face_paths_[i].c_str(), &width, &height, &nr_channels, 0);
-        if (data)
-        {
-            GLenum format = GL_RGBA;
-            if (nr_channels == 1)
-                format = GL_RED;
-            else if (nr_channels == 3)
-                format = GL_RGB;
-            else if (nr_channels == 4)
-                format = GL_RGBA;
-
-            GLCall(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format,
-                         width, height, 0, format, GL_UNSIGNED_BYTE, data));
-        }
-        else
-        {
-            std::cout << "[ERROR]CubeTexture: failed to load texture at path " << face_paths_[i] << std::endl;
-        }
+    // 工作线程只负责解码与生成 mip，上传仍在当前（上下文）线程
+    auto& thread_pool = ThreadPool::get_instance();
+    std::vector<std::future<TextureImage>> futures;
+    futures.reserve(face_paths_.size());
+    for (const auto& face_path : face_paths_)
+        futures.push_back(thread_pool.submit([face_path, mip_settings]() { return TextureImage(face_path, mip_settings); }));
 
-        stbi_image_free(data);
-    }
+    // 等待期间继续处理上传队列，线程池可能正被异步加载的模型占用
+    auto& upload_queue = UploadQueue::get_instance();
+    std::vector<TextureImage> images;
+    images.reserve(futures.size());
+    for (auto& future : futures)
+        images.push_back(upload_queue.wait(future));
 
-    GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLState::bind_texture(GL_TEXTURE_CUBE_MAP, renderer_id_);
+    upload(images);
+
+    GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, mipmaps_ ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
     GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
     GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
 
-    GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+    GLState::bind_texture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 CubeTexture::~CubeTexture()
 {
     GLCall(glDeleteTextures(1, &renderer_id_));
+    GLState::forget_texture(renderer_id_);
 }
 
 void CubeTexture::bind(const unsigned int slot) const
 {
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, renderer_id_));
+    GLState::bind_texture(slot, GL_TEXTURE_CUBE_MAP, renderer_id_);
 }
 
 void CubeTexture::unbind() const
 {
-    GLCall(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+    GLState::bind_texture(GL_TEXTURE_CUBE_MAP, 0);
+}
+
+void CubeTexture::upload(const std::vector<TextureImage>& images)
+{
+    if (images.empty())
+        return;
+
+    // 六个面的尺寸与格式必须一致，才能一次分配全部存储
+    const auto& first = images.front();
+    auto level_count = 0;
+    for (size_t i = 0, count = images.size(); i < count; i++)
+    {
+        const auto& image = images[i];
+        if (!image.is_valid())
+        {
+            std::cout << "[ERROR]CubeTexture: failed to load texture at path " << face_paths_[i] << std::endl;
+            return;
+        }
+
+        if (image.get_width() != first.get_width() || image.get_height() != first.get_height()
+            || image.is_compressed() != first.is_compressed() || image.get_bpp() != first.get_bpp()
+            || (image.is_compressed() && image.get_compressed().format != first.get_compressed().format))
+        {
+            std::cout << "[ERROR]CubeTexture: face size or format mismatch at path " << face_paths_[i] << std::endl;
+            return;
+        }
+
+        const auto face_levels = image.is_compressed()
+            ? static_cast<int>(image.get_compressed().levels.size())
+            : static_cast<int>(image.get_mip_chain().levels.size()) + 1;
+        level_count = i == 0 ? face_levels : std::min(level_count, face_levels);
+    }
+    if (!mipmaps_)
+        level_count = 1;
+
+    width_  = first.get_width();
+    height_ = first.get_height();
+
+    // 压缩格式不受支持时解压为 RGBA8
+    const auto compressed = first.is_compressed();
+    const auto compressed_format = compressed ? first.get_compressed().format : COMPRESSED_FORMAT_NONE;
+    const auto upload_compressed = compressed && Texture::is_format_supported(compressed_format);
+    if (compressed && !upload_compressed)
+    {
+        std::cout << "[WARNING] CubeTexture: " << get_format_name(compressed_format)
+                  << " is not supported by the driver, decompressing" << std::endl;
+    }
+
+    GLenum format = GL_RGBA, internal_format = GL_RGBA8;
+    if (upload_compressed)
+        internal_format = get_gl_internal_format(compressed_format);
+    else if (!compressed && first.get_bpp() == 1)
+        format = GL_RED, internal_format = GL_R8;
+    else if (!compressed && first.get_bpp() == 2)
+        format = GL_RG, internal_format = GL_RG8;
+    else if (!compressed && first.get_bpp() == 3)
+        format = GL_RGB, internal_format = GL_RGB8;
+
+    // 不可变存储：所有面与级别一次分配
+    const auto immutable = GLEW_ARB_texture_storage != 0;
+    if (immutable)
+        GLCall(glTexStorage2D(GL_TEXTURE_CUBE_MAP, level_count, internal_format, width_, height_));
+
+    if (upload_compressed)
+        Texture::apply_format_swizzle(GL_TEXTURE_CUBE_MAP, compressed_format);
+
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+    std::vector<unsigned char> rgba;
+    for (size_t face = 0, count = images.size(); face < count; face++)
+    {
+        const auto target = static_cast<GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face);
+        const auto& image = images[face];
+        for (auto level = 0; level < level_count; level++)
+        {
+            GLsizei level_width, level_height;
+            const unsigned char *data;
+            if (compressed)
+            {
+                const auto& info = image.get_compressed().levels[level];
+                level_width  = static_cast<GLsizei>(info.width);
+                level_height = static_cast<GLsizei>(info.height);
+                if (upload_compressed)
+                {
+                    const auto size = static_cast<GLsizei>(info.size);
+                    if (immutable)
+                        GLCall(glCompressedTexSubImage2D(target, level, 0, 0, level_width, level_height, internal_format, size, image.get_compressed().get_level_data(level)));
+                    else
+                        GLCall(glCompressedTexImage2D(target, level, internal_format, level_width, level_height, 0, size, image.get_compressed().get_level_data(level)));
+                    continue;
+                }
+
+                if (!decompress_level(image.get_compressed(), level, rgba))
+                {
+                    std::cout << "[ERROR]CubeTexture: unsupported compressed format at path " << face_paths_[face] << std::endl;
+                    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+                    return;
+                }
+                data = rgba.data();
+            }
+            else if (level == 0)
+            {
+                level_width  = width_;
+                level_height = height_;
+                data = image.get_pixels();
+            }
+            else
+            {
+                const auto& info = image.get_mip_chain().levels[level - 1];
+                level_width  = static_cast<GLsizei>(info.width);
+                level_height = static_cast<GLsizei>(info.height);
+                data = image.get_mip_chain().get_level_data(level - 1);
+            }
+
+            if (immutable)
+                GLCall(glTexSubImage2D(target, level, 0, 0, level_width, level_height, format, GL_UNSIGNED_BYTE, data));
+            else
+                GLCall(glTexImage2D(target, level, static_cast<GLint>(internal_format), level_width, level_height, 0, format, GL_UNSIGNED_BYTE, data));
+        }
+    }
+
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BASE_LEVEL, 0));
+    GLCall(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, level_count - 1));
 }
@@ -3,19 +3,28 @@
 #include <vector>
 
 #include "Renderer.h"
+#include "Texture.h"
 
 class CubeTexture
 {
 private:
     unsigned int renderer_id_;
+    int width_, height_;
+    bool mipmaps_;
 
     std::vector<std::string> face_paths_;
 
 public:
-    CubeTexture(std::vector<std::string> face_paths);
+    // 六个面在线程池中并行解码，mipmaps 为真时同时生成各面的 mip 链
+    CubeTexture(std::vector<std::string> face_paths, bool mipmaps = false);
     ~CubeTexture();
 
     void bind(const unsigned int slot = 0) const;
     void unbind() const;
-};
 
+    inline int get_width() const { return width_; }
+    inline int get_height() const { return height_; }
+
+private:
+    void upload(const std::vector<TextureImage>& images);
+};
@@ -0,0 +1,249 @@
+#include "DrawBatch.h"
+#include "IndexBuffer.h"
+#include "Mesh.h"
+#include "Renderer.h"
+#include "StreamBuffer.h"
+#include "VertexArray.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <tuple>
+
+DrawBatch::DrawBatch(StreamBuffer *stream)
+    : stream_(stream),
+      instance_buffer_(stream != nullptr ? new InstanceBuffer(*stream) : new InstanceBuffer(0)),
+      indirect_buffer_(0), indirect_capacity_(0), stats_()
+{
+    if (is_indirect_supported() && stream_ == nullptr)
+        GLCall(glGenBuffers(1, &indirect_buffer_));
+}
+
+DrawBatch::~DrawBatch()
+{
+    if (indirect_buffer_ != 0)
+        GLCall(glDeleteBuffers(1, &indirect_buffer_));
+}
+
+bool DrawBatch::is_indirect_supported()
+{
+    // 逐绘制数据依赖 base instance，缺少时即使有多重间接绘制也走退回路径
+    return GLEW_ARB_multi_draw_indirect && (GLEW_ARB_base_instance || GLEW_VERSION_4_2);
+}
+
+unsigned int DrawBatch::add_instance(const glm::mat4& model, const glm::vec4& color)
+{
+    instances_.push_back({ model, color });
+    return static_cast<unsigned int>(instances_.size() - 1);
+}
+
+void DrawBatch::add(Mesh& mesh, const unsigned int instance, const unsigned int index_count, const unsigned int index_offset)
+{
+    const auto vertex_array = mesh.get_vertex_array();
+    const auto index_buffer = mesh.get_index_buffer();
+    if (vertex_array == nullptr || index_count == 0)
+        return;
+
+    // 分组键：顶点数组、索引类型、图元类型、各纹理单元上的纹理
+    std::vector<uintptr_t> key = {
+        reinterpret_cast<uintptr_t>(vertex_array),
+        index_buffer->get_type(),
+        index_buffer->get_mode(),
+        index_buffer->has_primitive_restart() ? 1u : 0u,
+        mesh.get_vertex_format() == VERTEX_FORMAT_PACKED ? reinterpret_cast<uintptr_t>(&mesh) : 0u,
+    };
+    for (const auto& texture_data : mesh.get_texture_datas())
+    {
+        key.push_back(reinterpret_cast<uintptr_t>(texture_data.texture.get()));
+        key.push_back(std::hash<std::string>()(texture_data.type));
+    }
+
+    const auto result = group_indices_.emplace(std::move(key), groups_.size());
+    if (result.second)
+        groups_.push_back({ vertex_array, index_buffer, &mesh, {} });
+
+    // 缓冲堆的偏移按 4 字节对齐，总能整除索引宽度
+    const auto first_index = index_buffer->get_offset() / IndexBuffer::get_type_size(index_buffer->get_type()) + index_offset;
+    groups_[result.first->second].commands.push_back({ index_count, 1, first_index, mesh.get_base_vertex(), instance });
+}
+
+void DrawBatch::flush(const Renderer& renderer, Shader& shader)
+{
+    stats_ = DrawBatchStats();
+    if (groups_.empty())
+    {
+        clear();
+        return;
+    }
+
+    instance_buffer_->set_data(instances_);
+
+    // 流缓冲本帧空间不足时实例数据没有写入，绘制会把其他区间的数据当作模型矩阵
+    if (instance_buffer_->get_count() != instances_.size())
+    {
+        for (const auto& group : groups_)
+            stats_.dropped_count += static_cast<unsigned int>(group.commands.size());
+        stats_.group_count = static_cast<unsigned int>(groups_.size());
+        clear();
+        return;
+    }
+
+    if (is_indirect_supported())
+        flush_indirect(renderer, shader);
+    else
+        flush_fallback(renderer, shader);
+
+    clear();
+}
+
+void DrawBatch::clear()
+{
+    instances_.clear();
+    groups_.clear();
+    group_indices_.clear();
+}
+
+void DrawBatch::flush_indirect(const Renderer& renderer, Shader& shader)
+{
+    // 全部组的命令连续写入一个间接缓冲
+    size_t command_count = 0;
+    for (const auto& group : groups_)
+        command_count += group.commands.size();
+
+    const auto size = static_cast<unsigned int>(command_count * sizeof(DrawElementsIndirectCommand));
+    size_t offset = 0;
+    if (stream_ != nullptr)
+    {
+        const auto allocation = stream_->allocate(size);
+        if (!allocation.is_valid())
+        {
+            stats_.dropped_count = static_cast<unsigned int>(command_count);
+            stats_.group_count = static_cast<unsigned int>(groups_.size());
+            return;
+        }
+
+        for (const auto& group : groups_)
+        {
+            const auto group_size = group.commands.size() * sizeof(DrawElementsIndirectCommand);
+            std::memcpy(allocation.data + offset, group.commands.data(), group_size);
+            offset += group_size;
+        }
+        stream_->commit(allocation);
+
+        GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, allocation.buffer));
+        offset = allocation.offset;
+    }
+    else
+    {
+        GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer_));
+        if (size > indirect_capacity_)
+            indirect_capacity_ = glm::max(size, indirect_capacity_ + indirect_capacity_ / 2);
+        // 孤立旧存储，上一帧的绘制可能还在读取
+        GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, indirect_capacity_, nullptr, GL_STREAM_DRAW));
+
+        for (const auto& group : groups_)
+        {
+            const auto group_size = group.commands.size() * sizeof(DrawElementsIndirectCommand);
+            GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset, group_size, group.commands.data()));
+            offset += group_size;
+        }
+        offset = 0;
+    }
+
+    shader.bind();
+    for (const auto& group : groups_)
+    {
+        if (!group.vertex_array->has_instance_buffer(*instance_buffer_))
+            group.vertex_array->set_instance_buffer(*instance_buffer_);
+
+        group.material->apply_uniforms(shader);
+        group.vertex_array->bind();
+        renderer.multi_draw_elements_indirect(*group.index_buffer, offset, static_cast<unsigned int>(group.commands.size()));
+
+        offset += group.commands.size() * sizeof(DrawElementsIndirectCommand);
+        stats_.draw_count += static_cast<unsigned int>(group.commands.size());
+        stats_.api_calls++;
+    }
+    stats_.group_count = static_cast<unsigned int>(groups_.size());
+
+    GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+}
+
+void DrawBatch::flush_fallback(const Renderer& renderer, Shader& shader)
+{
+    shader.bind();
+    for (auto& group : groups_)
+    {
+        group.material->apply_uniforms(shader);
+
+        const auto index_size = IndexBuffer::get_type_size(group.index_buffer->get_type());
+        const auto get_offset = [index_size](const DrawElementsIndirectCommand& command)
+        {
+            return reinterpret_cast<const void*>(static_cast<size_t>(command.first_index) * index_size);
+        };
+
+        // 同一网格的命令排在一起并按逐绘制数据升序，数据下标连续的合为一次实例化绘制
+        auto& commands = group.commands;
+        std::sort(commands.begin(), commands.end(), [](const DrawElementsIndirectCommand& a, const DrawElementsIndirectCommand& b)
+        {
+            return std::tie(a.first_index, a.count, a.base_vertex, a.base_instance)
+                 < std::tie(b.first_index, b.count, b.base_vertex, b.base_instance);
+        });
+
+        single_commands_.clear();
+        for (size_t begin = 0, end = 0; begin < commands.size(); begin = end)
+        {
+            const auto& first = commands[begin];
+            for (end = begin + 1; end < commands.size(); end++)
+            {
+                const auto& command = commands[end];
+                if (command.first_index != first.first_index || command.count != first.count
+                    || command.base_vertex != first.base_vertex || command.base_instance != first.base_instance + (end - begin))
+                    break;
+            }
+
+            if (end - begin == 1)
+            {
+                single_commands_.push_back(first);
+                continue;
+            }
+
+            if (!group.vertex_array->has_instance_buffer(*instance_buffer_, first.base_instance))
+                group.vertex_array->set_instance_buffer(*instance_buffer_, first.base_instance);
+
+            group.vertex_array->bind();
+            renderer.draw_elements_instanced(*group.index_buffer, static_cast<int>(first.count), get_offset(first),
+                                             first.base_vertex, static_cast<unsigned int>(end - begin));
+            stats_.api_calls++;
+        }
+
+        // 剩余命令没有 base instance 可用，把实例属性指针移到各自的逐绘制数据上，同一数据的命令一起提交
+        std::stable_sort(single_commands_.begin(), single_commands_.end(), [](const DrawElementsIndirectCommand& a, const DrawElementsIndirectCommand& b)
+        {
+            return a.base_instance < b.base_instance;
+        });
+        for (size_t begin = 0, end = 0; begin < single_commands_.size(); begin = end)
+        {
+            const auto instance = single_commands_[begin].base_instance;
+            counts_.clear();
+            offsets_.clear();
+            base_vertices_.clear();
+            for (end = begin; end < single_commands_.size() && single_commands_[end].base_instance == instance; end++)
+            {
+                counts_.push_back(static_cast<int>(single_commands_[end].count));
+                offsets_.push_back(get_offset(single_commands_[end]));
+                base_vertices_.push_back(single_commands_[end].base_vertex);
+            }
+
+            if (!group.vertex_array->has_instance_buffer(*instance_buffer_, instance))
+                group.vertex_array->set_instance_buffer(*instance_buffer_, instance);
+
+            group.vertex_array->bind();
+            renderer.multi_draw_elements(*group.index_buffer, counts_.data(), offsets_.data(), base_vertices_.data(),
+                                         static_cast<unsigned int>(counts_.size()));
+            stats_.api_calls++;
+        }
+        stats_.draw_count += static_cast<unsigned int>(commands.size());
+    }
+    stats_.group_count = static_cast<unsigned int>(groups_.size());
+}
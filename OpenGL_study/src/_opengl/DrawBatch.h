@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "InstanceBuffer.h"
+#include "MOS_glm.h"
+
+class IndexBuffer;
+class Mesh;
+class Renderer;
+class Shader;
+class StreamBuffer;
+class VertexArray;
+
+/**
+ * 与 glMultiDrawElementsIndirect 约定的命令格式
+ */
+struct DrawElementsIndirectCommand
+{
+    uint32_t count;
+    uint32_t instance_count;
+    uint32_t first_index;       // 以索引个数计
+    int32_t  base_vertex;
+    uint32_t base_instance;     // 逐绘制数据下标
+};
+
+/**
+ * 每次 flush 的统计
+ */
+struct DrawBatchStats
+{
+    unsigned int  draw_count;       // 网格绘制数
+    unsigned int  group_count;      // 材质组数
+    unsigned int  api_calls;        // 发出的绘制调用数
+    unsigned int  dropped_count;    // 流缓冲本帧空间不足而未绘制的网格数
+};
+
+/**
+ * 多重绘制合批
+ *
+ * 网格按顶点数组、索引类型与材质纹理分组，每组生成一个 DrawElementsIndirectCommand 数组，
+ * 有 ARB_multi_draw_indirect 与 ARB_base_instance 时一组只需一次 glMultiDrawElementsIndirect；
+ * 否则退回路径：同一网格在连续逐绘制数据上的命令合为一次 glDrawElementsInstancedBaseVertex，
+ * 其余命令按逐绘制数据以 glMultiDrawElementsBaseVertex 合并提交。
+ * 逐绘制数据（模型矩阵与颜色）存放在 InstanceBuffer 中，以 base instance 为下标读取，
+ * 着色器需定义 INSTANCED 并包含 res/shaders/instance.glsl。
+ * 压缩顶点格式的网格各有位置解码参数，不与其他网格合并。
+ * 传入 StreamBuffer 时逐绘制数据与间接命令写入其本帧区段，不再重新分配缓冲
+ */
+class DrawBatch
+{
+private:
+    struct Group
+    {
+        VertexArray       *vertex_array;
+        const IndexBuffer *index_buffer;    // 提供索引类型、图元类型与重启标记
+        Mesh              *material;        // 由第一个网格绑定材质
+        std::vector<DrawElementsIndirectCommand> commands;
+    };
+
+    std::vector<InstanceData> instances_;
+    std::vector<Group>        groups_;
+    std::map<std::vector<uintptr_t>, size_t> group_indices_;
+
+    StreamBuffer  *stream_;
+    std::unique_ptr<InstanceBuffer> instance_buffer_;
+    unsigned int   indirect_buffer_;
+    unsigned int   indirect_capacity_;     // 字节
+    DrawBatchStats stats_;
+
+    // 退回路径的参数缓冲
+    std::vector<int>         counts_;
+    std::vector<const void*> offsets_;
+    std::vector<int>         base_vertices_;
+    std::vector<DrawElementsIndirectCommand> single_commands_;
+
+public:
+    explicit DrawBatch(StreamBuffer *stream = nullptr);
+    ~DrawBatch();
+
+    DrawBatch(const DrawBatch&) = delete;
+    DrawBatch& operator=(const DrawBatch&) = delete;
+
+    // 追加一条逐绘制数据，返回下标
+    unsigned int add_instance(const glm::mat4& model, const glm::vec4& color = glm::vec4(1.0f));
+    // 追加网格的一段索引，index_offset 相对网格自身的索引起点
+    void add(Mesh& mesh, unsigned int instance, unsigned int index_count, unsigned int index_offset);
+
+    // 上传并提交全部命令后清空
+    void flush(const Renderer& renderer, Shader& shader);
+    void clear();
+
+    inline const DrawBatchStats& get_stats() const { return stats_; }
+
+    static bool is_indirect_supported();
+
+private:
+    void flush_indirect(const Renderer& renderer, Shader& shader);
+    void flush_fallback(const Renderer& renderer, Shader& shader);
+};
@@ -1,4 +1,5 @@
 #include "FrameBuffer.h"
+#include "GLState.h"
 
 FrameBuffer::FrameBuffer()
     : renderer_id_(0),
@@ -38,7 +39,7 @@ void FrameBuffer::add_texture_attachment(const FB_ATTACHMENT_TYPE& type,
     
     unsigned int texture;
     GLCall(glGenTextures(1, &texture));
-    GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+    GLState::bind_texture(GL_TEXTURE_2D, texture);
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
     
@@ -93,7 +94,7 @@ void FrameBuffer::add_texture_attachment(const FB_ATTACHMENT_TYPE& type,
     }
     
     ASSERT(check());
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    GLState::bind_texture(GL_TEXTURE_2D, 0);
     unbind();
 }
 
@@ -173,29 +174,29 @@ bool FrameBuffer::check() const
 void FrameBuffer::bind_texture(const FB_ATTACHMENT_TYPE& type,
                                const unsigned int& offset)
 {
-    GLCall(glActiveTexture(GL_TEXTURE0 + offset));
+    GLState::active_texture(offset);
     switch (type) {
         case FB_ATTACHMENT_TYPE::Color:
         {
-            GLCall(glBindTexture(GL_TEXTURE_2D, attach_color_textures_[offset]));
+            GLState::bind_texture(GL_TEXTURE_2D, attach_color_textures_[offset]);
             break;
         }
             
         case FB_ATTACHMENT_TYPE::Depth:
         {
-            GLCall(glBindTexture(GL_TEXTURE_2D, attach_depth_texture_));
+            GLState::bind_texture(GL_TEXTURE_2D, attach_depth_texture_);
             break;
         }
             
         case FB_ATTACHMENT_TYPE::Stencil:
         {
-            GLCall(glBindTexture(GL_TEXTURE_2D, attach_stencil_texture_));
+            GLState::bind_texture(GL_TEXTURE_2D, attach_stencil_texture_);
             break;
         }
             
         case FB_ATTACHMENT_TYPE::Depth_Stencil:
         {
-            GLCall(glBindTexture(GL_TEXTURE_2D, attach_depth_stencil_texture_));
+            GLState::bind_texture(GL_TEXTURE_2D, attach_depth_stencil_texture_);
             break;
         }
     }
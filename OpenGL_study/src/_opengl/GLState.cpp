@@ -0,0 +1,255 @@
+#include "GLState.h"
+
+#include <algorithm>
+
+namespace
+{
+    const int64_t UNKNOWN = -1;
+
+    // 只跟踪常用的两种纹理目标，其余直接下发
+    bool is_tracked_target(const GLenum target)
+    {
+        return target == GL_TEXTURE_2D || target == GL_TEXTURE_CUBE_MAP;
+    }
+}
+
+GLState::GLState()
+    : tracking_(true), stats_()
+{
+}
+
+GLState& GLState::get_instance()
+{
+    static GLState instance;
+    static auto initialized = false;
+    if (!initialized)
+    {
+        initialized = true;
+        invalidate();
+    }
+    return instance;
+}
+
+bool GLState::assign(int64_t& shadow, const int64_t value)
+{
+    if (shadow == value)
+        return false;
+
+    shadow = value;
+    return true;
+}
+
+bool GLState::record(const bool changed)
+{
+    stats_.requested++;
+    if (tracking_ && !changed)
+        return false;
+
+    stats_.issued++;
+    return true;
+}
+
+void GLState::use_program(const unsigned int program)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.program_, program)))
+        GLCall(glUseProgram(program));
+}
+
+void GLState::bind_vertex_array(const unsigned int vertex_array)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.vertex_array_, vertex_array)))
+        GLCall(glBindVertexArray(vertex_array));
+}
+
+void GLState::active_texture(const unsigned int unit)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.active_texture_, unit)))
+        GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+}
+
+void GLState::bind_texture(const GLenum target, const unsigned int texture)
+{
+    auto& instance = get_instance();
+    const auto unit = instance.active_texture_;
+    auto changed = true;
+    if (is_tracked_target(target) && unit >= 0 && unit < GL_STATE_MAX_TEXTURE_UNITS)
+        changed = assign(target == GL_TEXTURE_2D ? instance.textures_2d_[unit] : instance.textures_cube_[unit], texture);
+
+    if (instance.record(changed))
+        GLCall(glBindTexture(target, texture));
+}
+
+void GLState::bind_texture(const unsigned int unit, const GLenum target, const unsigned int texture)
+{
+    auto& instance = get_instance();
+
+    // 该单元已绑定同一纹理时连激活纹理单元也省掉
+    if (instance.tracking_ && unit < GL_STATE_MAX_TEXTURE_UNITS && is_tracked_target(target))
+    {
+        const auto shadow = target == GL_TEXTURE_2D ? instance.textures_2d_[unit] : instance.textures_cube_[unit];
+        if (shadow == texture)
+        {
+            instance.record(false);
+            return;
+        }
+    }
+
+    active_texture(unit);
+    bind_texture(target, texture);
+}
+
+void GLState::set_enabled(const GLenum capability, const bool enabled)
+{
+    auto& instance = get_instance();
+    auto& shadow = instance.capabilities_.emplace(capability, UNKNOWN).first->second;
+    if (!instance.record(assign(shadow, enabled ? 1 : 0)))
+        return;
+
+    if (enabled)
+        GLCall(glEnable(capability));
+    else
+        GLCall(glDisable(capability));
+}
+
+void GLState::depth_func(const GLenum func)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.depth_func_, func)))
+        GLCall(glDepthFunc(func));
+}
+
+void GLState::depth_mask(const bool write)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.depth_mask_, write ? 1 : 0)))
+        GLCall(glDepthMask(write ? GL_TRUE : GL_FALSE));
+}
+
+void GLState::stencil_func(const GLenum func, const int ref, const unsigned int mask)
+{
+    auto& instance = get_instance();
+    auto changed = assign(instance.stencil_func_, func);
+    changed = assign(instance.stencil_ref_, ref) || changed;
+    changed = assign(instance.stencil_read_mask_, mask) || changed;
+    if (instance.record(changed))
+        GLCall(glStencilFunc(func, ref, mask));
+}
+
+void GLState::stencil_op(const GLenum stencil_fail, const GLenum depth_fail, const GLenum depth_pass)
+{
+    auto& instance = get_instance();
+    auto changed = assign(instance.stencil_fail_, stencil_fail);
+    changed = assign(instance.stencil_depth_fail_, depth_fail) || changed;
+    changed = assign(instance.stencil_depth_pass_, depth_pass) || changed;
+    if (instance.record(changed))
+        GLCall(glStencilOp(stencil_fail, depth_fail, depth_pass));
+}
+
+void GLState::stencil_mask(const unsigned int mask)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.stencil_write_mask_, mask)))
+        GLCall(glStencilMask(mask));
+}
+
+void GLState::blend_func(const GLenum src, const GLenum dst)
+{
+    auto& instance = get_instance();
+    auto changed = assign(instance.blend_src_, src);
+    changed = assign(instance.blend_dst_, dst) || changed;
+    if (instance.record(changed))
+        GLCall(glBlendFunc(src, dst));
+}
+
+void GLState::cull_face(const GLenum face)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.cull_face_, face)))
+        GLCall(glCullFace(face));
+}
+
+void GLState::front_face(const GLenum mode)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.front_face_, mode)))
+        GLCall(glFrontFace(mode));
+}
+
+void GLState::primitive_restart_index(const unsigned int index)
+{
+    auto& instance = get_instance();
+    if (instance.record(assign(instance.restart_index_, index)))
+        GLCall(glPrimitiveRestartIndex(index));
+}
+
+void GLState::forget_program(const unsigned int program)
+{
+    // 删除正在使用的程序后名字可能被复用，影子副本不能再认为它已绑定
+    auto& instance = get_instance();
+    if (instance.program_ == program)
+        instance.program_ = UNKNOWN;
+}
+
+void GLState::forget_vertex_array(const unsigned int vertex_array)
+{
+    // 删除当前顶点数组时驱动回到 0
+    auto& instance = get_instance();
+    if (instance.vertex_array_ == vertex_array)
+        instance.vertex_array_ = 0;
+}
+
+void GLState::forget_texture(const unsigned int texture)
+{
+    // 删除的纹理会从所有单元解绑
+    auto& instance = get_instance();
+    for (unsigned int i = 0; i < GL_STATE_MAX_TEXTURE_UNITS; i++)
+    {
+        if (instance.textures_2d_[i] == texture)
+            instance.textures_2d_[i] = 0;
+        if (instance.textures_cube_[i] == texture)
+            instance.textures_cube_[i] = 0;
+    }
+}
+
+void GLState::invalidate()
+{
+    auto& instance = get_instance();
+    instance.program_ = instance.vertex_array_ = instance.active_texture_ = UNKNOWN;
+    std::fill(std::begin(instance.textures_2d_), std::end(instance.textures_2d_), UNKNOWN);
+    std::fill(std::begin(instance.textures_cube_), std::end(instance.textures_cube_), UNKNOWN);
+    instance.capabilities_.clear();
+
+    instance.depth_func_ = instance.depth_mask_ = UNKNOWN;
+    instance.stencil_func_ = instance.stencil_ref_ = instance.stencil_read_mask_ = UNKNOWN;
+    instance.stencil_fail_ = instance.stencil_depth_fail_ = instance.stencil_depth_pass_ = UNKNOWN;
+    instance.stencil_write_mask_ = UNKNOWN;
+    instance.blend_src_ = instance.blend_dst_ = UNKNOWN;
+    instance.cull_face_ = instance.front_face_ = UNKNOWN;
+    instance.restart_index_ = UNKNOWN;
+}
+
+void GLState::set_tracking(const bool tracking)
+{
+    auto& instance = get_instance();
+    instance.tracking_ = tracking;
+    if (!tracking)
+        invalidate();
+}
+
+bool GLState::is_tracking()
+{
+    return get_instance().tracking_;
+}
+
+const GLStateStats& GLState::get_stats()
+{
+    return get_instance().stats_;
+}
+
+void GLState::reset_stats()
+{
+    get_instance().stats_ = GLStateStats();
+}
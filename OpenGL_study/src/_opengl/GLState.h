@@ -0,0 +1,92 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Common.h"
+
+const unsigned int GL_STATE_MAX_TEXTURE_UNITS = 32;
+
+/**
+ * 状态调用统计：requested 为经过跟踪器的调用，issued 为实际发给驱动的调用
+ */
+struct GLStateStats
+{
+    unsigned int  requested;
+    unsigned int  issued;
+};
+
+/**
+ * OpenGL 状态影子副本
+ *
+ * 程序、顶点数组、纹理绑定与各项开关都经由这里设置，与影子副本一致时跳过调用；
+ * 未知状态（初始或 invalidate 之后）总是下发。
+ * 绕过跟踪器直接调用 GL 后须 invalidate；删除对象时须 forget_*，避免名字复用后误判。
+ * 只能在 OpenGL 上下文线程使用
+ */
+class GLState
+{
+private:
+    bool         tracking_;
+    GLStateStats stats_;
+
+    // 影子副本，-1 表示未知；统一用 64 位以容纳无符号掩码
+    int64_t      program_;
+    int64_t      vertex_array_;
+    int64_t      active_texture_;
+    int64_t      textures_2d_[GL_STATE_MAX_TEXTURE_UNITS];
+    int64_t      textures_cube_[GL_STATE_MAX_TEXTURE_UNITS];
+    std::unordered_map<GLenum, int64_t> capabilities_;
+
+    int64_t      depth_func_;
+    int64_t      depth_mask_;
+    int64_t      stencil_func_, stencil_ref_, stencil_read_mask_;
+    int64_t      stencil_fail_, stencil_depth_fail_, stencil_depth_pass_;
+    int64_t      stencil_write_mask_;
+    int64_t      blend_src_, blend_dst_;
+    int64_t      cull_face_;
+    int64_t      front_face_;
+    int64_t      restart_index_;
+
+public:
+    static void use_program(unsigned int program);
+    static void bind_vertex_array(unsigned int vertex_array);
+    static void active_texture(unsigned int unit);
+    // 绑定到当前激活的纹理单元
+    static void bind_texture(GLenum target, unsigned int texture);
+    static void bind_texture(unsigned int unit, GLenum target, unsigned int texture);
+
+    static void set_enabled(GLenum capability, bool enabled);
+    static void depth_func(GLenum func);
+    static void depth_mask(bool write);
+    static void stencil_func(GLenum func, int ref, unsigned int mask);
+    static void stencil_op(GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass);
+    static void stencil_mask(unsigned int mask);
+    static void blend_func(GLenum src, GLenum dst);
+    static void cull_face(GLenum face);
+    static void front_face(GLenum mode);
+    static void primitive_restart_index(unsigned int index);
+
+    static void forget_program(unsigned int program);
+    static void forget_vertex_array(unsigned int vertex_array);
+    static void forget_texture(unsigned int texture);
+    // 影子副本全部置为未知
+    static void invalidate();
+
+    // 关闭时所有调用都下发，用于对比
+    static void set_tracking(bool tracking);
+    static bool is_tracking();
+
+    static const GLStateStats& get_stats();
+    static void reset_stats();
+
+private:
+    GLState();
+
+    static GLState& get_instance();
+    // 写入影子副本，返回是否与原值不同
+    static bool assign(int64_t& shadow, int64_t value);
+    // 记录一次请求，返回是否需要下发
+    bool record(bool changed);
+};
@@ -1,21 +1,70 @@
 #include "IndexBuffer.h"
+#include "BufferHeap.h"
+#include "GLState.h"
 
-IndexBuffer::IndexBuffer(const unsigned int index[], const unsigned& count)
-    : renderer_id_(0), count_(count)
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    template <typename T>
+    void narrow_indices(const unsigned int index[], const unsigned int count, unsigned char *output)
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            const auto value = static_cast<T>(index[i]);    // 重启标记截断后恰好是 T 的最大值
+            std::memcpy(output + i * sizeof(T), &value, sizeof(T));
+        }
+    }
+
+    bool contains_restart(const unsigned int index[], const unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (index[i] == PRIMITIVE_RESTART_INDEX)
+                return true;
+        }
+        return false;
+    }
+}
+
+IndexBuffer::IndexBuffer(const unsigned int index[], const unsigned& count,
+                         const unsigned int usage, const unsigned int mode)
+    : renderer_id_(0), count_(count), type_(select_type(index, count)),
+      mode_(mode), primitive_restart_(contains_restart(index, count)),
+      heap_(nullptr), heap_handle_(BUFFER_HEAP_INVALID)
 {
     GLCall(glGenBuffers(1, &renderer_id_));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer_id_));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), index, GL_STATIC_DRAW));
+    // 顶点数组在绘制后保持绑定，先解绑以免改写它的索引缓冲
+    GLState::bind_vertex_array(0);
+    upload(index, count, usage);
+}
+
+IndexBuffer::IndexBuffer(const unsigned int index[], const unsigned int& count, BufferHeap& heap, const unsigned int mode)
+    : renderer_id_(0), count_(count), type_(select_type(index, count)),
+      mode_(mode), primitive_restart_(contains_restart(index, count)),
+      heap_(&heap), heap_handle_(BUFFER_HEAP_INVALID)
+{
+    // 按 4 字节对齐，不同宽度的索引可以放在同一页中
+    const auto data = narrow(index, count);
+    heap_handle_ = heap.allocate(data.data(), static_cast<unsigned int>(data.size()), 4);
+    if (heap_handle_ != BUFFER_HEAP_INVALID)
+        renderer_id_ = heap.get_buffer(heap_handle_);
 }
 
 IndexBuffer::IndexBuffer(const IndexBuffer& other)
-    : renderer_id_(other.renderer_id_), count_(other.count_)
+    : renderer_id_(other.renderer_id_), count_(other.count_), type_(other.type_),
+      mode_(other.mode_), primitive_restart_(other.primitive_restart_),
+      heap_(other.heap_), heap_handle_(other.heap_handle_)
 {
 }
 
 IndexBuffer::~IndexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &renderer_id_));
+    // 缓冲堆的页由缓冲堆释放
+    if (heap_ == nullptr)
+        GLCall(glDeleteBuffers(1, &renderer_id_));
+    GLState::bind_vertex_array(0);
     unbind();
     renderer_id_= 0;
 }
@@ -29,3 +78,87 @@ void IndexBuffer::unbind() const
 {
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
+
+void IndexBuffer::set_data(const unsigned int index[], const unsigned int count, const unsigned int usage)
+{
+    if (heap_ != nullptr)
+    {
+        std::cout << "[ERROR] IndexBuffer: set_data is not supported for heap allocated buffers" << std::endl;
+        return;
+    }
+
+    if (get_type_size(select_type(index, count)) > get_type_size(type_))
+    {
+        std::cout << "[ERROR] IndexBuffer: index out of range of the buffer's index type" << std::endl;
+        return;
+    }
+
+    count_ = count;
+    upload(index, count, usage);
+}
+
+void IndexBuffer::release()
+{
+    if (heap_ != nullptr && heap_handle_ != BUFFER_HEAP_INVALID)
+        heap_->free(heap_handle_);
+    heap_handle_ = BUFFER_HEAP_INVALID;
+}
+
+unsigned int IndexBuffer::get_offset() const
+{
+    return heap_ != nullptr && heap_handle_ != BUFFER_HEAP_INVALID ? heap_->get_offset(heap_handle_) : 0;
+}
+
+unsigned int IndexBuffer::get_type_size(const unsigned int type)
+{
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:  return 1;
+    case GL_UNSIGNED_SHORT: return 2;
+    case GL_UNSIGNED_INT:   return 4;
+    }
+
+    std::cout << "[ERROR] IndexBuffer: unknown index type 0x" << std::hex << type << std::dec << std::endl;
+    return 0;
+}
+
+unsigned int IndexBuffer::select_type(const unsigned int index[], const unsigned int count)
+{
+    unsigned int max_index = 0;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (index[i] != PRIMITIVE_RESTART_INDEX && index[i] > max_index)
+            max_index = index[i];
+    }
+
+    if (max_index < 0xFF)
+        return GL_UNSIGNED_BYTE;
+    if (max_index < 0xFFFF)
+        return GL_UNSIGNED_SHORT;
+    return GL_UNSIGNED_INT;
+}
+
+void IndexBuffer::upload(const unsigned int index[], const unsigned int count, const unsigned int usage)
+{
+    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer_id_));
+    if (type_ == GL_UNSIGNED_INT)
+    {
+        GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), index, usage));
+        return;
+    }
+
+    const auto data = narrow(index, count);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size(), data.data(), usage));
+}
+
+std::vector<unsigned char> IndexBuffer::narrow(const unsigned int index[], const unsigned int count) const
+{
+    std::vector<unsigned char> data(count * get_type_size(type_));
+    if (type_ == GL_UNSIGNED_BYTE)
+        narrow_indices<uint8_t>(index, count, data.data());
+    else if (type_ == GL_UNSIGNED_SHORT)
+        narrow_indices<uint16_t>(index, count, data.data());
+    else
+        std::memcpy(data.data(), index, data.size());
+    return data;
+}
@@ -1,21 +1,66 @@
 #pragma once
 
+#include <vector>
+
 #include "Renderer.h"
 
+class BufferHeap;
+
+// 输入索引中的图元重启标记，上传时换成所选索引类型的最大值
+const unsigned int PRIMITIVE_RESTART_INDEX = 0xFFFFFFFF;
+
+/**
+ * 索引缓冲，按最大索引自动选择 8/16/32 位存储，并记录类型供 Renderer 绘制
+ */
 class IndexBuffer
 {
 private:
     unsigned int renderer_id_;
     unsigned int count_;
+    unsigned int type_;                 // GL_UNSIGNED_BYTE / GL_UNSIGNED_SHORT / GL_UNSIGNED_INT
+    unsigned int mode_;                 // 图元类型，如 GL_TRIANGLES、GL_TRIANGLE_STRIP
+    bool         primitive_restart_;    // 索引中含有重启标记
+
+    BufferHeap  *heap_;                 // 从缓冲堆分配时非空，renderer_id_ 为所在页
+    unsigned int heap_handle_;
 
 public:
-    IndexBuffer(const unsigned int index[], const unsigned int& count);
+    IndexBuffer(const unsigned int index[], const unsigned int& count,
+                unsigned int usage = GL_STATIC_DRAW, unsigned int mode = GL_TRIANGLES);
+    // 从缓冲堆中分配，绘制时加上 get_offset()
+    IndexBuffer(const unsigned int index[], const unsigned int& count, BufferHeap& heap, unsigned int mode = GL_TRIANGLES);
     IndexBuffer(const IndexBuffer& other);
     ~IndexBuffer();
 
     void bind() const;
     void unbind() const;
 
+    // 重新上传全部索引（旧数据被整块丢弃），调用前需先绑定使用它的 VertexArray
+    // 索引类型与重启标记以构造时为准，VertexArray 中的副本仍然有效，索引不能超出类型范围
+    void set_data(const unsigned int index[], unsigned int count, unsigned int usage = GL_STREAM_DRAW);
+
+    // 归还缓冲堆中的区间，析构时不会自动归还（副本共享同一区间）
+    void release();
+
+    // 在缓冲中的字节偏移，碎片整理后会变化，需在绘制时查询
+    unsigned int get_offset() const;
+    inline bool is_heap_allocated() const { return heap_ != nullptr; }
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
+
     inline int get_count() const { return count_; }
-};
+    inline unsigned int get_type() const { return type_; }
+    inline unsigned int get_mode() const { return mode_; }
+    inline unsigned int get_size() const { return count_ * get_type_size(type_); }
+    inline bool has_primitive_restart() const { return primitive_restart_; }
+    // 所选类型下的重启索引值
+    inline unsigned int get_restart_index() const { return type_ == GL_UNSIGNED_BYTE ? 0xFF : type_ == GL_UNSIGNED_SHORT ? 0xFFFF : 0xFFFFFFFF; }
+
+    static unsigned int get_type_size(unsigned int type);
+    // 能容纳这些索引（重启标记除外）的最窄类型，类型最大值保留给重启标记
+    static unsigned int select_type(const unsigned int index[], unsigned int count);
 
+private:
+    void upload(const unsigned int index[], unsigned int count, unsigned int usage);
+    // 按 type_ 收窄后的索引数据
+    std::vector<unsigned char> narrow(const unsigned int index[], unsigned int count) const;
+};
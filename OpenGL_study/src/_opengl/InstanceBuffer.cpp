@@ -0,0 +1,90 @@
+#include "InstanceBuffer.h"
+#include "StreamBuffer.h"
+
+namespace
+{
+    uint64_t next_serial()
+    {
+        static uint64_t serial = 0;
+        return ++serial;
+    }
+}
+
+InstanceBuffer::InstanceBuffer(const unsigned int capacity)
+    : renderer_id_(0), offset_(0), stream_(nullptr), count_(0), capacity_(capacity), serial_(next_serial())
+{
+    GLCall(glGenBuffers(1, &renderer_id_));
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, renderer_id_));
+    GLCall(glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW));
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+InstanceBuffer::InstanceBuffer(const InstanceData *data, const unsigned int count)
+    : InstanceBuffer(0)
+{
+    set_data(data, count);
+}
+
+InstanceBuffer::InstanceBuffer(StreamBuffer& stream)
+    : renderer_id_(stream.get_renderer_id()), offset_(0), stream_(&stream), count_(0), capacity_(0), serial_(next_serial())
+{
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+    if (stream_ == nullptr)
+        GLCall(glDeleteBuffers(1, &renderer_id_));
+    renderer_id_ = 0;
+}
+
+void InstanceBuffer::bind() const
+{
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, renderer_id_));
+}
+
+void InstanceBuffer::unbind() const
+{
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void InstanceBuffer::set_data(const InstanceData *data, const unsigned int count)
+{
+    if (stream_ != nullptr)
+    {
+        // 每次写入新的区间，上一份数据留给已提交的绘制
+        const auto allocation = stream_->write(data, count * static_cast<unsigned int>(sizeof(InstanceData)));
+        offset_ = allocation.offset;
+        count_ = allocation.is_valid() ? count : 0;
+        capacity_ = count_;
+        return;
+    }
+
+    bind();
+
+    if (count > capacity_)
+    {
+        // 按 1.5 倍增长，逐帧增减实例时不会反复分配
+        capacity_ = glm::max(count, capacity_ + capacity_ / 2);
+        GLCall(glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW));
+    }
+    else if (count_ > 0)
+    {
+        // 孤立旧存储，上一帧的实例绘制可能还在读取
+        GLCall(glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW));
+    }
+
+    if (count > 0)
+        GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), data));
+    count_ = count;
+
+    unbind();
+}
+
+VertexBufferLayout InstanceBuffer::get_layout()
+{
+    VertexBufferLayout layout;
+    for (auto column = 0; column < 4; column++)
+        layout.push<float>(4, 1);   // 模型矩阵
+    layout.push<float>(4, 1);       // 颜色
+    return layout;
+}
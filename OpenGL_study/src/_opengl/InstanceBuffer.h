@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexBufferLayout.h"
+#include "MOS_glm.h"
+
+class VertexBufferLayout;
+class StreamBuffer;
+
+// 逐实例属性的起始位置，模型矩阵占 8 ~ 11，颜色占 12，网格顶点属性须在此之前
+const unsigned int INSTANCE_ATTRIBUTE_LOCATION = 8;
+
+/**
+ * 逐实例数据，着色器中声明为
+ *     layout(location = 8)  in mat4 a_InstanceModel;
+ *     layout(location = 12) in vec4 a_InstanceColor;
+ * 见 res/shaders/instance.glsl
+ */
+struct InstanceData
+{
+    glm::mat4 model;
+    glm::vec4 color;
+};
+
+/**
+ * 逐实例属性流，每帧可整体重写，容量不足时重新分配；
+ * 由 StreamBuffer 分配时数据写入环形缓冲的本帧区段，只在本帧有效
+ */
+class InstanceBuffer
+{
+private:
+    unsigned int renderer_id_;
+    unsigned int offset_;       // 第一个实例在缓冲中的字节偏移
+    StreamBuffer *stream_;
+    unsigned int count_;
+    unsigned int capacity_;
+    uint64_t     serial_;       // 全局唯一编号，VertexArray 据此判断是否已挂接（GL 名字会被复用）
+
+public:
+    explicit InstanceBuffer(unsigned int capacity = 0);
+    InstanceBuffer(const InstanceData *data, unsigned int count);
+    explicit InstanceBuffer(StreamBuffer& stream);
+    ~InstanceBuffer();
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    void bind() const;
+    void unbind() const;
+
+    // 重写全部实例，旧存储交给驱动回收，不等待仍在使用它的绘制
+    void set_data(const InstanceData *data, unsigned int count);
+    inline void set_data(const std::vector<InstanceData>& data) { set_data(data.data(), static_cast<unsigned int>(data.size())); }
+
+    inline unsigned int get_count() const { return count_; }
+    inline unsigned int get_capacity() const { return capacity_; }
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
+    inline unsigned int get_offset() const { return offset_; }
+    inline uint64_t get_serial() const { return serial_; }
+
+    // 各属性 divisor 为 1，mat4 拆成四列 vec4
+    static VertexBufferLayout get_layout();
+};
@@ -0,0 +1,37 @@
+#include "PipelineState.h"
+
+#include "GLState.h"
+#include "Shader.h"
+
+PipelineState::PipelineState(const PipelineStateDesc& desc)
+    : desc_(desc)
+{
+}
+
+void PipelineState::bind() const
+{
+    if (desc_.shader)
+        desc_.shader->bind();
+
+    GLState::set_enabled(GL_DEPTH_TEST, desc_.depth.test_enabled);
+    GLState::depth_mask(desc_.depth.write_enabled);
+    GLState::depth_func(desc_.depth.func);
+
+    // 模板写掩码在关闭模板测试时仍影响清除，因此总是设置
+    GLState::set_enabled(GL_STENCIL_TEST, desc_.stencil.test_enabled);
+    GLState::stencil_mask(desc_.stencil.write_mask);
+    if (desc_.stencil.test_enabled)
+    {
+        GLState::stencil_func(desc_.stencil.func, desc_.stencil.ref, desc_.stencil.read_mask);
+        GLState::stencil_op(desc_.stencil.stencil_fail, desc_.stencil.depth_fail, desc_.stencil.depth_pass);
+    }
+
+    GLState::set_enabled(GL_BLEND, desc_.blend.enabled);
+    if (desc_.blend.enabled)
+        GLState::blend_func(desc_.blend.src, desc_.blend.dst);
+
+    GLState::set_enabled(GL_CULL_FACE, desc_.raster.cull_enabled);
+    if (desc_.raster.cull_enabled)
+        GLState::cull_face(desc_.raster.cull_face);
+    GLState::front_face(desc_.raster.front_face);
+}
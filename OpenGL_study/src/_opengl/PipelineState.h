@@ -0,0 +1,71 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "Common.h"
+
+class Shader;
+
+// 默认值与 Window 初始化时一致
+struct DepthState
+{
+    bool         test_enabled  = true;
+    bool         write_enabled = true;
+    GLenum       func          = GL_LESS;
+};
+
+struct StencilState
+{
+    // Window 默认开启模板测试，ALWAYS 与 KEEP 下不影响结果
+    bool         test_enabled  = true;
+    GLenum       func          = GL_ALWAYS;
+    int          ref           = 0;
+    unsigned int read_mask     = 0xff;
+    unsigned int write_mask    = 0xff;
+    GLenum       stencil_fail  = GL_KEEP;
+    GLenum       depth_fail    = GL_KEEP;
+    GLenum       depth_pass    = GL_KEEP;
+};
+
+struct BlendState
+{
+    bool         enabled       = true;
+    GLenum       src           = GL_SRC_ALPHA;
+    GLenum       dst           = GL_ONE_MINUS_SRC_ALPHA;
+};
+
+struct RasterState
+{
+    bool         cull_enabled  = false;
+    GLenum       cull_face     = GL_BACK;
+    GLenum       front_face    = GL_CCW;
+};
+
+struct PipelineStateDesc
+{
+    // 为空时不切换程序
+    const Shader* shader = nullptr;
+    DepthState    depth;
+    StencilState  stencil;
+    BlendState    blend;
+    RasterState   raster;
+};
+
+/**
+ * 管线状态对象
+ *
+ * 创建后不可修改，绑定时经由 GLState 逐项设置，与当前状态相同的项不会发出 GL 调用。
+ * 一次绘制所需的深度、模板、混合、剔除与程序状态集中描述，取代散落的 glEnable/glDisable 切换
+ */
+class PipelineState
+{
+private:
+    const PipelineStateDesc desc_;
+
+public:
+    explicit PipelineState(const PipelineStateDesc& desc);
+
+    void bind() const;
+
+    inline const PipelineStateDesc& get_desc() const { return desc_; }
+};
@@ -0,0 +1,208 @@
+#include "ProgramCache.h"
+#include "MeshCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    const char* get_gl_string(const GLenum name)
+    {
+        const GLubyte *value = nullptr;
+        GLCall(value = glGetString(name));
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    // 驱动标识参与哈希，换显卡或更新驱动后旧缓存自然失效
+    uint64_t get_driver_hash()
+    {
+        static uint64_t driver_hash = 0;
+        if (driver_hash == 0)
+        {
+            const std::string driver = std::string(get_gl_string(GL_VENDOR)) + "|"
+                                     + get_gl_string(GL_RENDERER) + "|"
+                                     + get_gl_string(GL_VERSION);
+            driver_hash = MeshCache::hash_bytes(driver.data(), driver.size());
+        }
+        return driver_hash;
+    }
+
+    double elapsed_ms(const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+ProgramCache::ProgramCache()
+    : enabled_(true), stats_()
+{
+}
+
+ProgramCache& ProgramCache::get_instance()
+{
+    static ProgramCache instance;
+    return instance;
+}
+
+bool ProgramCache::is_supported()
+{
+    static auto supported = -1;
+    if (supported < 0)
+    {
+        GLint format_count = 0;
+        if (GLEW_ARB_get_program_binary)
+            GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count));
+        supported = format_count > 0 ? 1 : 0;
+    }
+    return supported == 1;
+}
+
+void ProgramCache::set_enabled(const bool enabled)
+{
+    get_instance().enabled_ = enabled;
+}
+
+bool ProgramCache::is_enabled()
+{
+    return get_instance().enabled_ && is_supported();
+}
+
+uint64_t ProgramCache::make_key(const std::string& vertex_source,
+                                const std::string& fragment_source,
+                                const std::string& geometry_source,
+                                const std::string& defines)
+{
+    // 各段长度一并参与哈希，避免段落边界移动产生相同的拼接结果
+    const std::string* parts[] = { &vertex_source, &fragment_source, &geometry_source, &defines };
+    auto key = get_driver_hash();
+    for (const auto part : parts)
+    {
+        const uint64_t size = part->size();
+        key = MeshCache::hash_bytes(&size, sizeof(size), key);
+        key = MeshCache::hash_bytes(part->data(), part->size(), key);
+    }
+    return key;
+}
+
+std::string ProgramCache::get_cache_path(const std::string& shader_path, const std::string& defines)
+{
+    if (defines.empty())
+        return shader_path + ".progbin";
+
+    std::ostringstream stream;
+    stream << shader_path << "." << std::hex << MeshCache::hash_bytes(defines.data(), defines.size()) << ".progbin";
+    return stream.str();
+}
+
+unsigned int ProgramCache::load(const std::string& cache_path, const uint64_t key)
+{
+    if (!is_enabled())
+        return 0;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    std::ifstream stream(cache_path, std::ios::binary);
+    if (!stream)
+        return 0;
+
+    ProgramCacheHeader header {};
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC)) != 0
+        || header.version != PROGRAM_CACHE_VERSION
+        || header.key != key
+        || header.binary_size == 0)
+        return 0;
+
+    std::vector<char> binary(header.binary_size);
+    if (!stream.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+        return 0;
+
+    unsigned int program = 0;
+    GLCall(program = glCreateProgram());
+    // 驱动拒绝二进制时会置 GL_INVALID_ENUM，这里不经过 GLCall 以免误报
+    glProgramBinary(program, header.binary_format, binary.data(), static_cast<GLsizei>(binary.size()));
+    while (glGetError() != GL_NO_ERROR) {}
+
+    int result = GL_FALSE;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
+    auto& stats = get_instance().stats_;
+    if (result == GL_FALSE)
+    {
+        std::cout << "[WARNING] ProgramCache: driver rejected cached binary " << cache_path << ", recompiling" << std::endl;
+        GLCall(glDeleteProgram(program));
+        stats.rejected++;
+        return 0;
+    }
+
+    const auto load_ms = elapsed_ms(start);
+    stats.hits++;
+    stats.load_ms += load_ms;
+    stats.saved_ms += header.compile_ms - load_ms;
+    return program;
+}
+
+bool ProgramCache::store(const std::string& cache_path, const uint64_t key, const unsigned int program, const double compile_ms)
+{
+    auto& stats = get_instance().stats_;
+    stats.misses++;
+    stats.compile_ms += compile_ms;
+
+    if (!is_enabled() || program == 0)
+        return false;
+
+    GLint length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return false;
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum binary_format = 0;
+    GLCall(glGetProgramBinary(program, length, &length, &binary_format, binary.data()));
+
+    ProgramCacheHeader header {};
+    std::memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC));
+    header.version       = PROGRAM_CACHE_VERSION;
+    header.key           = key;
+    header.binary_format = binary_format;
+    header.binary_size   = static_cast<uint32_t>(length);
+    header.compile_ms    = compile_ms;
+
+    // 先写临时文件再替换，避免中途失败留下半个缓存
+    const auto temp_path = cache_path + ".tmp";
+    std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+        return false;
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(binary.data(), length);
+    stream.close();
+    if (!stream)
+    {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    std::remove(cache_path.c_str());
+    if (std::rename(temp_path.c_str(), cache_path.c_str()) != 0)
+    {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+const ProgramCacheStats& ProgramCache::get_stats()
+{
+    return get_instance().stats_;
+}
+
+void ProgramCache::reset_stats()
+{
+    get_instance().stats_ = ProgramCacheStats();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Renderer.h"
+
+const char         PROGRAM_CACHE_MAGIC[4] = { 'P', 'R', 'G', 'B' };
+const unsigned int PROGRAM_CACHE_VERSION  = 1;
+
+/**
+ * 程序二进制缓存文件头，其后紧跟 binary_size 字节的驱动二进制
+ */
+struct ProgramCacheHeader
+{
+    char          magic[4];         // 文件标识 "PRGB"
+    uint32_t      version;          // 缓存格式版本
+    uint64_t      key;              // 源码、宏定义与驱动字符串的哈希
+    uint32_t      binary_format;    // glGetProgramBinary 返回的格式
+    uint32_t      binary_size;      // 二进制大小
+    double        compile_ms;       // 生成该二进制时的编译链接耗时，用于统计节省时间
+};
+
+/**
+ * 程序缓存统计
+ */
+struct ProgramCacheStats
+{
+    unsigned int  hits;             // 直接由二进制创建的程序
+    unsigned int  misses;           // 从源码编译的程序
+    unsigned int  rejected;         // 驱动拒绝的二进制（格式不匹配等），已回退编译
+    double        load_ms;          // 命中时加载二进制的总耗时
+    double        compile_ms;       // 未命中时编译链接的总耗时
+    double        saved_ms;         // 命中程序原编译耗时减去加载耗时
+};
+
+/**
+ * 着色器程序的磁盘二进制缓存
+ *
+ * 以各阶段源码、宏定义与驱动 vendor/renderer/version 字符串的哈希为键，
+ * 保存 glGetProgramBinary 的结果，下次启动直接 glProgramBinary 跳过编译与链接；
+ * 驱动更新或格式不匹配时链接失败，调用方回退到源码编译并覆盖缓存。
+ * 只能在 OpenGL 上下文线程使用
+ */
+class ProgramCache
+{
+private:
+    bool              enabled_;
+    ProgramCacheStats stats_;
+
+public:
+    // 驱动支持 ARB_get_program_binary 且至少提供一种二进制格式
+    static bool is_supported();
+    static void set_enabled(bool enabled);
+    static bool is_enabled();
+
+    static uint64_t make_key(const std::string& vertex_source,
+                             const std::string& fragment_source,
+                             const std::string& geometry_source,
+                             const std::string& defines = std::string());
+    static std::string get_cache_path(const std::string& shader_path, const std::string& defines = std::string());
+
+    // 命中时返回已链接的程序，否则返回 0
+    static unsigned int load(const std::string& cache_path, uint64_t key);
+    // 程序须在链接前设置 GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    static bool store(const std::string& cache_path, uint64_t key, unsigned int program, double compile_ms);
+
+    static const ProgramCacheStats& get_stats();
+    static void reset_stats();
+
+private:
+    ProgramCache();
+
+    static ProgramCache& get_instance();
+};
@@ -0,0 +1,239 @@
+#include "RenderQueue.h"
+#include "Renderer.h"
+
+#include <algorithm>
+
+namespace
+{
+    const unsigned int SHADER_BITS   = 10;
+    const unsigned int MATERIAL_BITS = 14;
+    const unsigned int VAO_BITS      = 8;
+    const unsigned int DEPTH_BITS    = 24;
+    const unsigned int LAYER_BITS    = 6;
+
+    uint64_t mask(const unsigned int bits)
+    {
+        return (1ULL << bits) - 1;
+    }
+
+    // 超出位宽的编号回绕，只会让不同状态相邻，不影响正确性
+    uint32_t get_dense_id(std::unordered_map<uint64_t, uint32_t>& ids, const uint64_t key)
+    {
+        const auto it = ids.find(key);
+        if (it != ids.end())
+            return it->second;
+
+        const auto id = static_cast<uint32_t>(ids.size());
+        ids.emplace(key, id);
+        return id;
+    }
+
+    uint64_t hash_combine(const uint64_t seed, const uint64_t value)
+    {
+        return (seed ^ value) * 1099511628211ULL;
+    }
+}
+
+RenderQueue::RenderQueue()
+    : view_(1.0f), near_(0.1f), far_(1000.0f), stats_()
+{
+}
+
+void RenderQueue::set_view(const glm::mat4& view, const float near, const float far)
+{
+    view_ = view;
+    near_ = near;
+    far_  = far > near ? far : near + 1.0f;
+}
+
+void RenderQueue::submit(const VertexArray& va, Shader& shader, const glm::mat4& model,
+                         const std::initializer_list<const Texture*> textures,
+                         const RenderPass pass, const unsigned int layer)
+{
+    const auto index_buffer = va.get_index_buffer();
+
+    RenderCommand command {};
+    command.vertex_array = &va;
+    command.index_buffer = index_buffer;
+    command.shader       = &shader;
+    command.index_count  = index_buffer->get_count();
+    command.model        = model;
+
+    uint64_t material_key = 14695981039346656037ULL;
+    for (const auto texture : textures)
+    {
+        if (command.texture_count == RENDER_QUEUE_MAX_TEXTURES)
+            break;
+        command.textures[command.texture_count++] = texture;
+        material_key = hash_combine(material_key, reinterpret_cast<uintptr_t>(texture));
+    }
+
+    push(command, glm::vec3(model[3]), pass, layer, material_key);
+}
+
+void RenderQueue::submit(const VertexArray& va, const IndexBuffer& index_buffer, Shader& shader,
+                         const unsigned int index_count, const unsigned int index_offset, const int base_vertex,
+                         Mesh& mesh, const glm::mat4& model,
+                         const RenderPass pass, const unsigned int layer)
+{
+    RenderCommand command {};
+    command.vertex_array = &va;
+    command.index_buffer = &index_buffer;
+    command.shader       = &shader;
+    command.index_count  = index_count;
+    command.index_offset = index_offset;
+    command.base_vertex  = base_vertex;
+    command.mesh         = &mesh;
+    command.model        = model;
+
+    // 同一组纹理的网格共用材质；压缩顶点格式还有逐网格的解码参数
+    auto material_key = hash_combine(14695981039346656037ULL, mesh.get_vertex_format() == VERTEX_FORMAT_PACKED
+                                                               ? reinterpret_cast<uintptr_t>(&mesh) : 0);
+    for (const auto& texture_data : mesh.get_texture_datas())
+        material_key = hash_combine(material_key, reinterpret_cast<uintptr_t>(texture_data.texture.get()));
+
+    const auto origin = glm::vec3(model * glm::vec4(mesh.get_bounds_center(), 1.0f));
+    push(command, origin, pass, layer, material_key);
+}
+
+void RenderQueue::push(RenderCommand& command, const glm::vec3& origin,
+                       const RenderPass pass, const unsigned int layer, const uint64_t material_key)
+{
+    command.material_id = get_dense_id(material_ids_, material_key);
+
+    const uint64_t shader_id = get_dense_id(shader_ids_, reinterpret_cast<uintptr_t>(command.shader)) & mask(SHADER_BITS);
+    const uint64_t material_id = command.material_id & mask(MATERIAL_BITS);
+    const uint64_t vao_id = get_dense_id(vertex_array_ids_, reinterpret_cast<uintptr_t>(command.vertex_array)) & mask(VAO_BITS);
+
+    // 观察空间看向 -z
+    const auto view_depth = -(view_ * glm::vec4(origin, 1.0f)).z;
+    const auto normalized = glm::clamp((view_depth - near_) / (far_ - near_), 0.0f, 1.0f);
+    auto depth = static_cast<uint64_t>(normalized * static_cast<float>(mask(DEPTH_BITS)));
+
+    auto key = static_cast<uint64_t>(pass & 3) << 62 | (static_cast<uint64_t>(layer) & mask(LAYER_BITS)) << 56;
+    if (pass == RENDER_PASS_TRANSPARENT)
+    {
+        depth = mask(DEPTH_BITS) - depth;
+        key |= depth << 32 | shader_id << 22 | material_id << 8 | vao_id;
+    }
+    else
+    {
+        key |= shader_id << 46 | material_id << 32 | vao_id << 24 | depth;
+    }
+    command.key = key;
+
+    commands_.push_back(command);
+}
+
+void RenderQueue::sort()
+{
+    const auto count = commands_.size();
+    sort_keys_.resize(count);
+    sort_indices_.resize(count);
+    sort_keys_temp_.resize(count);
+    sort_indices_temp_.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        sort_keys_[i] = commands_[i].key;
+        sort_indices_[i] = static_cast<uint32_t>(i);
+    }
+
+    // LSD 基数排序，每趟 8 位，整趟落在同一个桶时跳过；稳定，相同键保持提交顺序
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; i++)
+            histogram[(sort_keys_[i] >> shift) & 0xFF]++;
+
+        if (count == 0 || histogram[(sort_keys_[0] >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            const auto bucket_count = bucket;
+            bucket = offset;
+            offset += bucket_count;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const auto position = histogram[(sort_keys_[i] >> shift) & 0xFF]++;
+            sort_keys_temp_[position] = sort_keys_[i];
+            sort_indices_temp_[position] = sort_indices_[i];
+        }
+        sort_keys_.swap(sort_keys_temp_);
+        sort_indices_.swap(sort_indices_temp_);
+    }
+}
+
+void RenderQueue::flush(const Renderer& renderer)
+{
+    sort();
+
+    stats_ = RenderQueueStats();
+    const Shader *current_shader = nullptr;
+    const VertexArray *current_vertex_array = nullptr;
+    auto current_material = ~0u;
+    UniformHandle<glm::mat4> model_handle;
+    for (const auto index : sort_indices_)
+    {
+        auto& command = commands_[index];
+
+        if (command.shader != current_shader)
+        {
+            command.shader->bind();
+            current_shader = command.shader;
+            current_material = ~0u;
+            stats_.shader_changes++;
+
+            // 命令按着色器排序，每次切换解析一次 u_Model；编译中的着色器没有反射信息，按名字设置
+            model_handle = command.shader->is_ready()
+                         ? command.shader->get_uniform<glm::mat4>("u_Model", false)
+                         : UniformHandle<glm::mat4>();
+        }
+
+        if (command.material_id != current_material)
+        {
+            if (command.mesh != nullptr)
+                command.mesh->apply_uniforms(*command.shader);
+            else
+            {
+                for (unsigned int i = 0; i < command.texture_count; i++)
+                    command.textures[i]->bind(i);
+            }
+            current_material = command.material_id;
+            stats_.material_changes++;
+        }
+
+        if (model_handle.is_valid())
+            command.shader->set(model_handle, command.model);
+        else if (!command.shader->is_ready())
+            command.shader->set_mat4f("u_Model", command.model);
+
+        if (command.vertex_array != current_vertex_array)
+        {
+            command.vertex_array->bind();
+            current_vertex_array = command.vertex_array;
+            stats_.vertex_array_changes++;
+        }
+
+        renderer.draw_elements(*command.index_buffer, command.index_count, command.index_offset, command.base_vertex);
+        stats_.draw_count++;
+    }
+
+    if (current_vertex_array != nullptr)
+        current_vertex_array->unbind();
+    if (current_shader != nullptr)
+        current_shader->unbind();
+
+    clear();
+}
+
+void RenderQueue::clear()
+{
+    commands_.clear();
+    shader_ids_.clear();
+    material_ids_.clear();
+    vertex_array_ids_.clear();
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+#include "MOS_glm.h"
+
+class IndexBuffer;
+class Mesh;
+class Renderer;
+class Shader;
+class Texture;
+class VertexArray;
+
+const unsigned int RENDER_QUEUE_MAX_TEXTURES = 4;
+
+/**
+ * 渲染阶段，决定排序键最高位，阶段之间严格按顺序提交
+ */
+enum RenderPass
+{
+    RENDER_PASS_OPAQUE      = 0,    // 由近到远，利于 early-Z
+    RENDER_PASS_MASKED      = 1,
+    RENDER_PASS_TRANSPARENT = 2,    // 由远到近，深度优先于状态
+    RENDER_PASS_OVERLAY     = 3,
+};
+
+/**
+ * 一次排队的绘制，提交时的状态（模型矩阵、纹理）随命令保存
+ */
+struct RenderCommand
+{
+    uint64_t            key;
+    const VertexArray  *vertex_array;
+    const IndexBuffer  *index_buffer;
+    Shader             *shader;
+    unsigned int        index_count;
+    unsigned int        index_offset;
+    int                 base_vertex;
+
+    Mesh               *mesh;           // 非空时由网格绑定材质纹理
+    const Texture      *textures[RENDER_QUEUE_MAX_TEXTURES];    // mesh 为空时依次绑定到 0..n
+    unsigned int        texture_count;
+    uint32_t            material_id;
+
+    glm::mat4           model;          // 写入 u_Model
+};
+
+/**
+ * 每帧提交的状态切换统计
+ */
+struct RenderQueueStats
+{
+    unsigned int  draw_count;
+    unsigned int  shader_changes;
+    unsigned int  material_changes;
+    unsigned int  vertex_array_changes;
+};
+
+/**
+ * 按 64 位排序键提交的渲染队列
+ *
+ * 排序键从高到低：pass(2) | layer(6) | shader(10) | material(14) | vao(8) | depth(24)，
+ * 透明阶段把 depth 取反并提到 shader 之前，保证由远到近；
+ * 着色器、材质与顶点数组在队列内映射为稠密编号，每帧基数排序后顺序提交，
+ * 相同状态只切换一次
+ */
+class RenderQueue
+{
+private:
+    std::vector<RenderCommand> commands_;
+    std::vector<uint64_t>      sort_keys_;      // 基数排序的键与下标缓冲
+    std::vector<uint32_t>      sort_indices_;
+    std::vector<uint64_t>      sort_keys_temp_;
+    std::vector<uint32_t>      sort_indices_temp_;
+
+    std::unordered_map<uint64_t, uint32_t> shader_ids_;
+    std::unordered_map<uint64_t, uint32_t> material_ids_;
+    std::unordered_map<uint64_t, uint32_t> vertex_array_ids_;
+
+    glm::mat4 view_;
+    float     near_, far_;
+
+    RenderQueueStats stats_;
+
+public:
+    RenderQueue();
+
+    // 深度按观察空间 z 在 [near, far] 内量化
+    void set_view(const glm::mat4& view, float near, float far);
+
+    void submit(const VertexArray& va, Shader& shader, const glm::mat4& model,
+                std::initializer_list<const Texture*> textures = {},
+                RenderPass pass = RENDER_PASS_OPAQUE, unsigned int layer = 0);
+    // 缓冲堆中的子区间，材质由网格绑定
+    void submit(const VertexArray& va, const IndexBuffer& index_buffer, Shader& shader,
+                unsigned int index_count, unsigned int index_offset, int base_vertex,
+                Mesh& mesh, const glm::mat4& model,
+                RenderPass pass = RENDER_PASS_OPAQUE, unsigned int layer = 0);
+
+    // 排序并提交全部命令，之后清空队列
+    void flush(const Renderer& renderer);
+    void clear();
+
+    inline size_t get_command_count() const { return commands_.size(); }
+    // 上一次 flush 的统计
+    inline const RenderQueueStats& get_stats() const { return stats_; }
+
+private:
+    void push(RenderCommand& command, const glm::vec3& origin, RenderPass pass, unsigned int layer, uint64_t material_key);
+    void sort();
+};
@@ -1,4 +1,6 @@
 #include "Renderer.h"
+#include "GLState.h"
+#include "InstanceBuffer.h"
 
 Renderer::Renderer()
     : clear_color_(glm::vec4(0.0f))
@@ -13,15 +15,113 @@ void Renderer::clear() const
 }
 
 void Renderer::draw(const VertexArray& va, const Shader& shader) const
+{
+    draw(va, shader, va.get_index_buffer()->get_count(), 0);
+}
+
+void Renderer::draw(const VertexArray& va, const Shader& shader,
+                    const unsigned int index_count, const unsigned int index_offset) const
+{
+    draw(va, *va.get_index_buffer(), shader, index_count, index_offset, 0);
+}
+
+void Renderer::draw(const VertexArray& va, const IndexBuffer& index_buffer, const Shader& shader,
+                    const unsigned int index_count, const unsigned int index_offset, const int base_vertex) const
 {
     shader.bind();
     va.bind();
 
-    GLCall(glDrawElements(GL_TRIANGLES, 
-                          va.get_index_buffer()->get_count(), 
-                          GL_UNSIGNED_INT, nullptr));
-    shader.unbind();
-    va.unbind();
+    // 绘制后不再解绑，下一次绑定相同对象时由 GLState 跳过
+    draw_elements(index_buffer, index_count, index_offset, base_vertex);
+}
+
+void Renderer::draw_instanced(VertexArray& va, const Shader& shader,
+                              const InstanceBuffer& instance_buffer, const unsigned int instance_count) const
+{
+    const auto& index_buffer = *va.get_index_buffer();
+    draw_instanced(va, index_buffer, shader, instance_buffer, instance_count, index_buffer.get_count(), 0, 0);
+}
+
+void Renderer::draw_instanced(VertexArray& va, const IndexBuffer& index_buffer, const Shader& shader,
+                              const InstanceBuffer& instance_buffer, const unsigned int instance_count,
+                              const unsigned int index_count, const unsigned int index_offset, const int base_vertex) const
+{
+    if (instance_count > instance_buffer.get_count())
+    {
+        std::cout << "[ERROR] Renderer: draw_instanced requested " << instance_count
+                  << " instances, instance buffer holds " << instance_buffer.get_count() << std::endl;
+        return;
+    }
+
+    if (!va.has_instance_buffer(instance_buffer))
+        va.set_instance_buffer(instance_buffer);
+
+    shader.bind();
+    va.bind();
+
+    draw_elements(index_buffer, index_count, index_offset, base_vertex, instance_count);
+}
+
+void Renderer::draw_elements(const IndexBuffer& index_buffer, const unsigned int index_count,
+                             const unsigned int index_offset, const int base_vertex,
+                             const unsigned int instance_count) const
+{
+    if (instance_count == 0)
+        return;
+
+    const auto type = index_buffer.get_type();
+    const auto offset = index_buffer.get_offset() + index_offset * IndexBuffer::get_type_size(type);
+
+    apply_primitive_restart(index_buffer);
+
+    const auto indices = reinterpret_cast<void*>(static_cast<size_t>(offset));
+    if (instance_count > 1)
+        GLCall(glDrawElementsInstancedBaseVertex(index_buffer.get_mode(), index_count, type, indices,
+                                                 instance_count, base_vertex));
+    else if (base_vertex != 0)
+        GLCall(glDrawElementsBaseVertex(index_buffer.get_mode(), index_count, type, indices, base_vertex));
+    else
+        GLCall(glDrawElements(index_buffer.get_mode(), index_count, type, indices));
+}
+
+void Renderer::multi_draw_elements_indirect(const IndexBuffer& index_buffer, const size_t indirect_offset,
+                                            const unsigned int draw_count) const
+{
+    if (draw_count == 0)
+        return;
+
+    apply_primitive_restart(index_buffer);
+    GLCall(glMultiDrawElementsIndirect(index_buffer.get_mode(), index_buffer.get_type(),
+                                       reinterpret_cast<const void*>(indirect_offset), draw_count, 0));
+}
+
+void Renderer::draw_elements_instanced(const IndexBuffer& index_buffer, const int count, const void *offset,
+                                       const int base_vertex, const unsigned int instance_count) const
+{
+    if (count == 0 || instance_count == 0)
+        return;
+
+    apply_primitive_restart(index_buffer);
+    GLCall(glDrawElementsInstancedBaseVertex(index_buffer.get_mode(), count, index_buffer.get_type(), offset,
+                                             instance_count, base_vertex));
+}
+
+void Renderer::multi_draw_elements(const IndexBuffer& index_buffer, const int *counts, const void *const *offsets,
+                                   const int *base_vertices, const unsigned int draw_count) const
+{
+    if (draw_count == 0)
+        return;
+
+    apply_primitive_restart(index_buffer);
+    GLCall(glMultiDrawElementsBaseVertex(index_buffer.get_mode(), const_cast<int*>(counts), index_buffer.get_type(),
+                                         const_cast<void**>(offsets), draw_count, const_cast<int*>(base_vertices)));
+}
+
+void Renderer::apply_primitive_restart(const IndexBuffer& index_buffer) const
+{
+    GLState::set_enabled(GL_PRIMITIVE_RESTART, index_buffer.has_primitive_restart());
+    if (index_buffer.has_primitive_restart())
+        GLState::primitive_restart_index(index_buffer.get_restart_index());
 }
 
 void Renderer::draw(Mesh& mesh, Shader& shader) const
@@ -34,6 +134,17 @@ void Renderer::draw(Model& model, Shader& shader) const
     model.draw(*this, shader);
 }
 
+void Renderer::draw(Model& model, Shader& shader, const Camera& camera, const glm::mat4& model_mat) const
+{
+    model.draw(*this, shader, camera, model_mat);
+}
+
+void Renderer::draw(Model& model, Shader& shader, const Camera& camera,
+                    const glm::mat4& proj_mat, const glm::mat4& model_mat) const
+{
+    model.draw(*this, shader, camera, proj_mat, model_mat);
+}
+
 void Renderer::set_clear_color(const glm::vec4 color)
 {
     if (color != clear_color_)
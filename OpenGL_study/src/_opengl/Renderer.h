@@ -16,6 +16,8 @@ class IndexBuffer;
 class Shader;
 class Mesh;
 class Model;
+class Camera;
+class InstanceBuffer;
 
 class Renderer
 {
@@ -28,8 +30,37 @@ public:
 
     void clear() const;
     void draw(const VertexArray& va, const Shader& shader) const;
+    // 只绘制索引缓冲中的一段，偏移以索引个数计，索引类型与图元类型取自索引缓冲
+    void draw(const VertexArray& va, const Shader& shader, unsigned int index_count, unsigned int index_offset) const;
+    // 使用指定的索引缓冲（须已绑定在 va 上的同一缓冲对象中），顶点下标加上 base_vertex，用于缓冲堆中的子区间
+    void draw(const VertexArray& va, const IndexBuffer& index_buffer, const Shader& shader,
+              unsigned int index_count, unsigned int index_offset, int base_vertex) const;
+    // 绘制 instance_count 个实例，逐实例属性来自 instance_buffer，未挂接到 va 时先挂接
+    void draw_instanced(VertexArray& va, const Shader& shader,
+                        const InstanceBuffer& instance_buffer, unsigned int instance_count) const;
+    void draw_instanced(VertexArray& va, const IndexBuffer& index_buffer, const Shader& shader,
+                        const InstanceBuffer& instance_buffer, unsigned int instance_count,
+                        unsigned int index_count, unsigned int index_offset, int base_vertex) const;
+    // 只发出绘制调用，着色器与顶点数组须已绑定，供渲染队列在状态不变时连续提交
+    void draw_elements(const IndexBuffer& index_buffer, unsigned int index_count,
+                       unsigned int index_offset, int base_vertex, unsigned int instance_count = 1) const;
+    // 一次提交多段绘制，着色器与顶点数组须已绑定；索引类型、图元类型与图元重启取自 index_buffer
+    // indirect_offset 为 GL_DRAW_INDIRECT_BUFFER 中 DrawElementsIndirectCommand 数组的字节偏移
+    void multi_draw_elements_indirect(const IndexBuffer& index_buffer, size_t indirect_offset, unsigned int draw_count) const;
+    // offset 为索引缓冲中的字节偏移（含缓冲堆偏移），着色器与顶点数组须已绑定
+    void draw_elements_instanced(const IndexBuffer& index_buffer, int count, const void *offset,
+                                 int base_vertex, unsigned int instance_count) const;
+    // offsets 为索引缓冲中的字节偏移
+    void multi_draw_elements(const IndexBuffer& index_buffer, const int *counts, const void *const *offsets,
+                             const int *base_vertices, unsigned int draw_count) const;
     void draw(Mesh& mesh, Shader& shader) const;
     void draw(Model& model, Shader& shader) const;
+    void draw(Model& model, Shader& shader, const Camera& camera, const glm::mat4& model_mat) const;
+    void draw(Model& model, Shader& shader, const Camera& camera,
+              const glm::mat4& proj_mat, const glm::mat4& model_mat) const;
 
     void set_clear_color(glm::vec4 color = glm::vec4(0.0f));
+
+private:
+    void apply_primitive_restart(const IndexBuffer& index_buffer) const;
 };
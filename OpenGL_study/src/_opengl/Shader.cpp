@@ -1,81 +1,465 @@
 #include "Shader.h"
- #include <utility>
+#include "AssetPack.h"
+#include "GLState.h"
+#include "ProgramCache.h"
+#include "ShaderLibrary.h"
+#include "UniformBlocks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+    const size_t MAX_INCLUDE_DEPTH = 16;
+
+    UniformStats uniform_stats = { 0, 0 };
+    bool uniform_tracking = true;
+
+    // glUniform1i 可设置 int、bool 与各类采样器
+    bool is_uniform_type_compatible(const unsigned int actual, const unsigned int expected)
+    {
+        if (actual == expected)
+            return true;
+        if (expected != GL_INT)
+            return false;
 
-Shader::Shader(std::string filepath)
-    : filepath_(std::move(filepath)),
-      vertex_shader_id_(-1),
-      fragment_shader_id_(-1),
-      geometry_shader_id_(-1)
+        switch (actual)
+        {
+        case GL_BOOL:
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool read_text(const std::string& path, std::string& text)
+    {
+        // 资源包中的文件直接从映射内存拷贝
+        const auto asset = AssetPack::read(path);
+        if (asset.is_valid())
+        {
+            text.assign(reinterpret_cast<const char*>(asset.data), asset.size);
+            return true;
+        }
+
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream)
+            return false;
+        text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    std::string get_directory(const std::string& path)
+    {
+        const auto pos = path.find_last_of("/\\");
+        return pos == std::string::npos ? std::string() : path.substr(0, pos + 1);
+    }
+
+    std::string trim(const std::string& text)
+    {
+        const auto begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+            return std::string();
+        const auto end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    // 展开 #include "path"，先相对当前文件查找，再相对工作目录
+    void expand_includes(const std::string& path, const std::string& text,
+                         std::vector<std::string>& include_stack, std::string& output)
+    {
+        for (size_t begin = 0, size = text.size(); begin < size;)
+        {
+            auto end = text.find('\n', begin);
+            if (end == std::string::npos)
+                end = size;
+            const auto line = text.substr(begin, end - begin);
+            begin = end + 1;
+
+            const auto trimmed = trim(line);
+            if (trimmed.compare(0, 8, "#include") != 0)
+            {
+                output += line;
+                output += "\n";
+                continue;
+            }
+
+            const auto open = trimmed.find_first_of("\"<", 8);
+            const auto close = open == std::string::npos ? open : trimmed.find_first_of("\">", open + 1);
+            if (close == std::string::npos)
+            {
+                std::cout << "[ERROR] Shader: malformed include in " << path << ": " << trimmed << std::endl;
+                continue;
+            }
+
+            const auto name = trimmed.substr(open + 1, close - open - 1);
+            auto include_path = get_directory(path) + name;
+            std::string include_text;
+            if (!read_text(include_path, include_text))
+            {
+                include_path = name;
+                if (!read_text(include_path, include_text))
+                {
+                    std::cout << "[ERROR] Shader: can not open include " << name << " in " << path << std::endl;
+                    continue;
+                }
+            }
+
+            if (include_stack.size() >= MAX_INCLUDE_DEPTH
+                || std::find(include_stack.begin(), include_stack.end(), include_path) != include_stack.end())
+            {
+                std::cout << "[ERROR] Shader: recursive include " << include_path << " in " << path << std::endl;
+                continue;
+            }
+
+            include_stack.push_back(include_path);
+            expand_includes(include_path, include_text, include_stack, output);
+            include_stack.pop_back();
+        }
+    }
+}
+
+Shader::Shader(std::string filepath, ShaderDefines defines, const bool async)
+    : renderer_id_(0),
+      vertex_shader_id_(0),
+      fragment_shader_id_(0),
+      geometry_shader_id_(0),
+      filepath_(std::move(filepath)),
+      defines_(std::move(defines)),
+      status_(ShaderStatus::compiling),
+      cache_key_(0)
 {
     // 解析 shader 文件
     const auto shader_src = parse_shader();
 
-    // 创建 shader program
-    renderer_id_ = create_shader(shader_src.vertex_source, 
-                                 shader_src.fragment_source,
-                                 shader_src.geometry_source);
+    // 优先从程序二进制缓存创建，未命中时编译并写回缓存
+    const auto define_block = make_define_block(defines_);
+    cache_key_ = ProgramCache::make_key(shader_src.vertex_source,
+                                        shader_src.fragment_source,
+                                        shader_src.geometry_source,
+                                        define_block);
+    cache_path_ = ProgramCache::get_cache_path(filepath_, define_block);
+    renderer_id_ = ProgramCache::load(cache_path_, cache_key_);
+    if (renderer_id_ != 0)
+    {
+        status_ = ShaderStatus::ready;
+        reflect_uniforms();
+        UniformBlocks::bind_program(renderer_id_, filepath_);
+    }
+    else
+    {
+        // 只提交编译与链接，状态查询推迟到 finish_program，驱动可在自己的线程里并行编译
+        compile_start_ = std::chrono::high_resolution_clock::now();
+        renderer_id_ = create_shader(shader_src.vertex_source, 
+                                     shader_src.fragment_source,
+                                     shader_src.geometry_source);
+        if (async)
+            fallback_ = ShaderLibrary::get(SHADER_FALLBACK_PATH);
+        else
+            finish_program();
+    }
 
     // 使用 shader program
-    GLCall(glUseProgram(renderer_id_));
+    if (status_ == ShaderStatus::ready)
+        GLState::use_program(renderer_id_);
 }
 
 Shader::~Shader()
 {
+    for (const auto id : { vertex_shader_id_, fragment_shader_id_, geometry_shader_id_ })
+    {
+        if (id != 0)
+            GLCall(glDeleteShader(id));
+    }
+    GLState::forget_program(renderer_id_);
     GLCall(glDeleteProgram(renderer_id_));
 }
 
+bool Shader::is_parallel_compile_supported()
+{
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+bool Shader::poll()
+{
+    if (status_ != ShaderStatus::compiling)
+        return true;
+
+    // 不支持扩展时无法非阻塞查询，直接等待结果
+    if (is_parallel_compile_supported())
+    {
+        auto completed = GL_FALSE;
+        GLCall(glGetProgramiv(renderer_id_, GL_COMPLETION_STATUS_KHR, &completed));
+        if (completed == GL_FALSE)
+            return false;
+    }
+
+    finish_program();
+    return true;
+}
+
+void Shader::wait()
+{
+    if (status_ == ShaderStatus::compiling)
+        finish_program();
+}
+
 void Shader::set_vec4f(const std::string& name, const float v0, const float v1, 
                                                 const float v2, const float v3)
 {
-    bind();
-    GLCall(glUniform4f(get_uniform_location(name), v0, v1, v2, v3));
+    if (status_ != ShaderStatus::ready)
+    {
+        const float values[] = { v0, v1, v2, v3 };
+        set_pending(name, PendingUniform::VEC4, values, 4);
+        return;
+    }
+
+    set(UniformHandle<glm::vec4>(get_uniform_location(name)), glm::vec4(v0, v1, v2, v3));
 }
 
 void Shader::set_int(const std::string& name, const int value)
 {
-    bind();
-    GLCall(glUniform1i(get_uniform_location(name), value));
+    if (status_ != ShaderStatus::ready)
+    {
+        set_pending(name, PendingUniform::INT, nullptr, 0, value);
+        return;
+    }
+
+    set(UniformHandle<int>(get_uniform_location(name)), value);
 }
 
 void Shader::set_float(const std::string& name, const float value)
 {
-    bind();
-    GLCall(glUniform1f(get_uniform_location(name), value));
+    if (status_ != ShaderStatus::ready)
+    {
+        set_pending(name, PendingUniform::FLOAT, &value, 1);
+        return;
+    }
+
+    set(UniformHandle<float>(get_uniform_location(name)), value);
 }
 
 void Shader::set_mat4f(const std::string& name, const glm::mat4 mat4)
 {
-    bind();
-    GLCall(glUniformMatrix4fv(get_uniform_location(name), 1, GL_FALSE, &mat4[0][0]));
+    if (status_ != ShaderStatus::ready)
+    {
+        set_pending(name, PendingUniform::MAT4, &mat4[0][0], 16);
+        return;
+    }
+
+    set(UniformHandle<glm::mat4>(get_uniform_location(name)), mat4);
 }
 
 int Shader::get_uniform_location(const std::string& name)
 {
-    if (uniform_cache_.find(name) != uniform_cache_.end())
-        return uniform_cache_[name];
+    const auto it = uniforms_.find(name);
+    if (it != uniforms_.end())
+        return it->second.location;
+
+    // 未知名字只提示一次
+    std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+    uniforms_[name] = { -1, 0, 0 };
+    return -1;
+}
+
+int Shader::resolve_uniform(const std::string& name, const unsigned int type, const bool required)
+{
+    wait();
+
+    const auto it = uniforms_.find(name);
+    if (it == uniforms_.end() || it->second.location == -1)
+    {
+        if (required && status_ == ShaderStatus::ready)
+            std::cout << "[ERROR] Shader: uniform '" << name << "' not found in " << filepath_ << std::endl;
+        return -1;
+    }
+
+    if (!is_uniform_type_compatible(it->second.type, type))
+    {
+        std::cout << "[ERROR] Shader: uniform '" << name << "' in " << filepath_ << " has GL type 0x"
+                  << std::hex << it->second.type << ", handle expects 0x" << type << std::dec << std::endl;
+        return -1;
+    }
+    return it->second.location;
+}
+
+void Shader::reflect_uniforms()
+{
+    // 新程序的 uniform 值与旧副本无关
+    uniforms_.clear();
+    uniform_shadows_.clear();
+
+    auto count = 0;
+    auto max_length = 0;
+    GLCall(glGetProgramiv(renderer_id_, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(renderer_id_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length));
+
+    std::vector<char> buffer(std::max(max_length, 1));
+    for (auto i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint   size = 0;
+        GLenum  type = 0;
+        GLCall(glGetActiveUniform(renderer_id_, i, static_cast<GLsizei>(buffer.size()), &length, &size, &type, buffer.data()));
+        std::string name(buffer.data(), length);
+
+        // uniform 块的成员没有位置，由 UniformBlocks 管理
+        auto location = -1;
+        GLCall(location = glGetUniformLocation(renderer_id_, name.c_str()));
+        if (location == -1)
+            continue;
+
+        uniforms_[name] = { location, type, size };
+
+        // 数组报告为 "name[0]"，同时登记基名与其余元素
+        const auto suffix = name.size() > 3 ? name.size() - 3 : std::string::npos;
+        if (suffix == std::string::npos || name.compare(suffix, 3, "[0]") != 0)
+            continue;
+
+        const auto base = name.substr(0, suffix);
+        uniforms_[base] = { location, type, size };
+        for (auto element = 1; element < size; element++)
+        {
+            const auto element_name = base + "[" + std::to_string(element) + "]";
+            GLCall(location = glGetUniformLocation(renderer_id_, element_name.c_str()));
+            if (location != -1)
+                uniforms_[element_name] = { location, type, 1 };
+        }
+    }
+
+    auto max_location = -1;
+    for (const auto& entry : uniforms_)
+        max_location = std::max(max_location, entry.second.location);
+    uniform_shadows_.resize(max_location + 1);
+}
+
+bool Shader::update_shadow(const int location, const void *value, const size_t size)
+{
+    if (location < 0)
+        return false;
+
+    if (static_cast<size_t>(location) >= uniform_shadows_.size())
+        uniform_shadows_.resize(location + 1);
+
+    // 关闭跟踪时仍更新副本，重新开启后不会用到过期的值
+    auto& shadow = uniform_shadows_[location];
+    const auto changed = !shadow.valid || std::memcmp(shadow.data, value, size) != 0;
+    shadow.valid = true;
+    std::memcpy(shadow.data, value, size);
+
+    if (!changed && uniform_tracking)
+    {
+        uniform_stats.elided++;
+        return false;
+    }
+    uniform_stats.issued++;
+    return true;
+}
+
+void Shader::set_uniform_tracking(const bool tracking)
+{
+    uniform_tracking = tracking;
+}
+
+bool Shader::is_uniform_tracking()
+{
+    return uniform_tracking;
+}
+
+const UniformStats& Shader::get_uniform_stats()
+{
+    return uniform_stats;
+}
 
-    auto location = -1;
-    GLCall(location = glGetUniformLocation(renderer_id_, name.c_str()));
-    if (location == -1)
-        std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+void Shader::reset_uniform_stats()
+{
+    uniform_stats = { 0, 0 };
+}
 
+void Shader::set(const UniformHandle<int> handle, const int value)
+{
+    if (!update_shadow(handle.location_, &value, sizeof(value)))
+        return;
 
-    uniform_cache_[name] = location;
-    return location;
-}   
+    bind();
+    GLCall(glUniform1i(handle.location_, value));
+}
+
+void Shader::set(const UniformHandle<float> handle, const float value)
+{
+    if (!update_shadow(handle.location_, &value, sizeof(value)))
+        return;
+
+    bind();
+    GLCall(glUniform1f(handle.location_, value));
+}
+
+void Shader::set(const UniformHandle<glm::vec3> handle, const glm::vec3& value)
+{
+    if (!update_shadow(handle.location_, &value, sizeof(value)))
+        return;
+
+    bind();
+    GLCall(glUniform3f(handle.location_, value.x, value.y, value.z));
+}
+
+void Shader::set(const UniformHandle<glm::vec4> handle, const glm::vec4& value)
+{
+    if (!update_shadow(handle.location_, &value, sizeof(value)))
+        return;
+
+    bind();
+    GLCall(glUniform4f(handle.location_, value.x, value.y, value.z, value.w));
+}
+
+void Shader::set(const UniformHandle<glm::mat4> handle, const glm::mat4& value)
+{
+    if (!update_shadow(handle.location_, &value, sizeof(value)))
+        return;
+
+    bind();
+    GLCall(glUniformMatrix4fv(handle.location_, 1, GL_FALSE, &value[0][0]));
+}
 
 void Shader::bind() const
 {
-    GLCall(glUseProgram(renderer_id_));
+    if (status_ == ShaderStatus::compiling)
+    {
+        bind_fallback();
+        return;
+    }
+
+    GLState::use_program(renderer_id_);
 }
 
 void Shader::unbind() const
 {
-    GLCall(glUseProgram(0));
+    GLState::use_program(0);
 }
 
-void Shader::uniform_block_bind(const std::string& name, const unsigned int bind_point) const
+void Shader::uniform_block_bind(const std::string& name, const unsigned int bind_point)
 {
+    if (status_ != ShaderStatus::ready)
+    {
+        if (status_ == ShaderStatus::compiling)
+            pending_block_bindings_.emplace_back(name, bind_point);
+        return;
+    }
+
     auto uniform_index = 0;
     GLCall(uniform_index = glGetUniformBlockIndex(renderer_id_, name.c_str()));
     GLCall(glUniformBlockBinding(renderer_id_, uniform_index, bind_point));
@@ -83,26 +467,130 @@ void Shader::uniform_block_bind(const std::string& name, const unsigned int bind
 
 void Shader::set_vec3f(const std::string& name, const float v0, const float v1, const float v2)
 {
-    bind();
-    GLCall(glUniform3f(get_uniform_location(name), v0, v1, v2));
+    if (status_ != ShaderStatus::ready)
+    {
+        const float values[] = { v0, v1, v2 };
+        set_pending(name, PendingUniform::VEC3, values, 3);
+        return;
+    }
+
+    set(UniformHandle<glm::vec3>(get_uniform_location(name)), glm::vec3(v0, v1, v2));
 }
 
 void Shader::set_vec3f(const std::string& name, const glm::vec3 value)
 {
-    bind();
-    GLCall(glUniform3f(get_uniform_location(name), value.x, value.y, value.z));
+    set_vec3f(name, value.x, value.y, value.z);
 }
 
 void Shader::set_vec4f(const std::string& name, const glm::vec4 value)
 {
-    bind();
-    GLCall(glUniform4f(get_uniform_location(name), value.x, value.y, value.z, value.w));
+    set_vec4f(name, value.x, value.y, value.z, value.w);
+}
+
+void Shader::set_pending(const std::string& name, const PendingUniform::Type type,
+                         const float *values, const int count, const int int_value)
+{
+    // 编译失败的程序直接丢弃
+    if (status_ != ShaderStatus::compiling)
+        return;
+
+    auto& pending = pending_uniforms_[name];
+    pending.type = type;
+    pending.int_value = int_value;
+    std::copy(values, values + count, pending.values);
+}
+
+void Shader::bind_fallback() const
+{
+    if (!fallback_)
+    {
+        GLState::use_program(0);
+        return;
+    }
+
+    // 用编译期间记录的变换绘制纯色几何体
+    const auto get_matrix = [this](const char *name)
+    {
+        const auto it = pending_uniforms_.find(name);
+        if (it == pending_uniforms_.end() || it->second.type != PendingUniform::MAT4)
+            return glm::mat4(1.0f);
+        return glm::make_mat4(it->second.values);
+    };
+
+    auto mvp = get_matrix("u_MVP");
+    if (pending_uniforms_.find("u_MVP") == pending_uniforms_.end())
+        mvp = get_matrix("u_Proj") * get_matrix("u_View") * get_matrix("u_Model");
+
+    fallback_->set_mat4f("u_MVP", mvp);
+    fallback_->set_vec4f("u_Color", 0.5f, 0.5f, 0.5f, 1.0f);
+    fallback_->bind();
+}
+
+std::string Shader::make_define_block(const ShaderDefines& defines)
+{
+    std::vector<std::string> lines;
+    for (const auto& define : defines)
+    {
+        auto text = trim(define);
+        const auto equal = text.find('=');
+        if (equal != std::string::npos)
+            text = trim(text.substr(0, equal)) + " " + trim(text.substr(equal + 1));
+        if (!text.empty())
+            lines.push_back("#define " + text + "\n");
+    }
+
+    // 顺序无关，排序去重后相同宏组合得到相同的块
+    std::sort(lines.begin(), lines.end());
+    lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+
+    std::string block;
+    for (const auto& line : lines)
+        block += line;
+    return block;
 }
 
 ShaderProgramSource Shader::parse_shader() const
 {
-    std::ifstream stream(filepath_);
+    std::string text;
+    if (!read_text(filepath_, text))
+    {
+        std::cout << "[ERROR] Shader: can not open " << filepath_ << std::endl;
+        return {};
+    }
+
+    std::vector<std::string> include_stack { filepath_ };
+    std::string expanded;
+    expand_includes(filepath_, text, include_stack, expanded);
+
+    auto source = parse_shader_source(expanded.data(), expanded.size());
+    const auto define_block = make_define_block(defines_);
+    if (!define_block.empty())
+    {
+        source.vertex_source   = inject_defines(source.vertex_source, define_block);
+        source.fragment_source = inject_defines(source.fragment_source, define_block);
+        source.geometry_source = inject_defines(source.geometry_source, define_block);
+    }
+    return source;
+}
+
+std::string Shader::inject_defines(const std::string& source, const std::string& define_block)
+{
+    if (source.empty())
+        return source;
+
+    // #version 必须是第一条语句，宏定义紧随其后
+    const auto version = source.find("#version");
+    if (version == std::string::npos)
+        return define_block + source;
+
+    const auto line_end = source.find('\n', version);
+    if (line_end == std::string::npos)
+        return source + "\n" + define_block;
+    return source.substr(0, line_end + 1) + define_block + source.substr(line_end + 1);
+}
 
+ShaderProgramSource Shader::parse_shader_source(const char *source, const size_t size)
+{
     enum class ShaderType
     {
         none     = -1,
@@ -111,11 +599,21 @@ ShaderProgramSource Shader::parse_shader() const
         geometry =  2,
     };
 
-    std::string line;
-    std::stringstream ss[3];
+    std::string ss[3];
     auto type = ShaderType::none;
-    while (getline(stream, line))
+    for (size_t begin = 0; begin < size;)
     {
+        auto end = begin;
+        while (end < size && source[end] != '\n')
+            end++;
+
+        // 兼容 Windows 换行
+        auto line_end = end;
+        if (line_end > begin && source[line_end - 1] == '\r')
+            line_end--;
+        const std::string line(source + begin, line_end - begin);
+        begin = end + 1;
+
         if (line.find("#shader") != std::string::npos)
         {
             if (line.find("vertex") != std::string::npos)
@@ -127,13 +625,14 @@ ShaderProgramSource Shader::parse_shader() const
             else
                 std::cout << "parse shader error: syntax error" << std::endl;
         }
-        else
+        else if (type != ShaderType::none)
         {
-            ss[static_cast<int>(type)] << line << "\n";
+            ss[static_cast<int>(type)] += line;
+            ss[static_cast<int>(type)] += "\n";
         }
     }
 
-    return { ss[0].str(), ss[1].str(), ss[2].str() };
+    return { ss[0], ss[1], ss[2] };
 }
 
 unsigned Shader::compile_shader(const unsigned type, const std::string& source) const
@@ -143,7 +642,11 @@ unsigned Shader::compile_shader(const unsigned type, const std::string& source)
     auto src = source.c_str();
     GLCall(glShaderSource(id, 1, &src ,nullptr));
     GLCall(glCompileShader(id));
+    return id;
+}
 
+bool Shader::check_shader(const unsigned id, const unsigned type) const
+{
     int result;
     GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
     if (result == GL_FALSE)
@@ -167,11 +670,10 @@ unsigned Shader::compile_shader(const unsigned type, const std::string& source)
                   << " [" << filepath_ << "]"
                   << std::endl;
         std::cout << message << std::endl;
-        glDeleteShader(id);
-        return 0;
+        return false;
     }
 
-    return id;
+    return true;
 }
 
 unsigned Shader::create_shader(const std::string& vertex_shader, 
@@ -198,32 +700,95 @@ unsigned Shader::create_shader(const std::string& vertex_shader,
         GLCall(glAttachShader(program, geometry_shader_id_));
     }
 
+    if (ProgramCache::is_enabled())
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+
+    // 不在此查询编译与链接状态，查询会让驱动同步等待
     GLCall(glLinkProgram(program));
+    return program;
+}
 
-    int result;
-    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &result));
-    if (result == GL_FALSE)
+void Shader::finish_program()
+{
+    auto success = true;
+    const unsigned int stages[][2] = {
+        { vertex_shader_id_,   GL_VERTEX_SHADER   },
+        { fragment_shader_id_, GL_FRAGMENT_SHADER },
+        { geometry_shader_id_, GL_GEOMETRY_SHADER },
+    };
+    for (const auto& stage : stages)
+    {
+        if (stage[0] != 0 && !check_shader(stage[0], stage[1]))
+            success = false;
+    }
+
+    int result = GL_FALSE;
+    if (success)
+        GLCall(glGetProgramiv(renderer_id_, GL_LINK_STATUS, &result));
+    if (success && result == GL_FALSE)
     {
         int length;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        glGetProgramiv(renderer_id_, GL_INFO_LOG_LENGTH, &length);
         char* message = static_cast<char*>(alloca(length * sizeof(char)));
-        glGetProgramInfoLog(program, length, &length, message);
+        glGetProgramInfoLog(renderer_id_, length, &length, message);
         std::cout << "Failed to link program!" << std::endl;
         std::cout << message << std::endl;
-        glDeleteProgram(program);
-        return 0;
+        success = false;
+    }
+
+    for (auto id : { &vertex_shader_id_, &fragment_shader_id_, &geometry_shader_id_ })
+    {
+        if (*id != 0)
+            GLCall(glDeleteShader(*id));
+        *id = 0;
     }
+    fallback_.reset();
 
-    GLCall(glValidateProgram(program));
+    if (!success)
+    {
+        GLState::forget_program(renderer_id_);
+        GLCall(glDeleteProgram(renderer_id_));
+        renderer_id_ = 0;
+        status_ = ShaderStatus::failed;
+        pending_uniforms_.clear();
+        pending_block_bindings_.clear();
+        return;
+    }
 
-    if (vertex_shader_id_ != -1)
-        GLCall(glDeleteShader(vertex_shader_id_));
+    GLCall(glValidateProgram(renderer_id_));
+    status_ = ShaderStatus::ready;
+    reflect_uniforms();
+    UniformBlocks::bind_program(renderer_id_, filepath_);
 
-    if (fragment_shader_id_ != -1)
-        GLCall(glDeleteShader(fragment_shader_id_));
+    const auto compile_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - compile_start_).count();
+    ProgramCache::store(cache_path_, cache_key_, renderer_id_, compile_ms);
 
-    if (geometry_shader_id_ != -1)
-        GLCall(glDeleteShader(geometry_shader_id_));
+    // 重放编译期间设置的 uniform 与块绑定
+    for (const auto& entry : pending_uniforms_)
+    {
+        const auto& pending = entry.second;
+        switch (pending.type)
+        {
+        case PendingUniform::INT:
+            set_int(entry.first, pending.int_value);
+            break;
+        case PendingUniform::FLOAT:
+            set_float(entry.first, pending.values[0]);
+            break;
+        case PendingUniform::VEC3:
+            set_vec3f(entry.first, pending.values[0], pending.values[1], pending.values[2]);
+            break;
+        case PendingUniform::VEC4:
+            set_vec4f(entry.first, pending.values[0], pending.values[1], pending.values[2], pending.values[3]);
+            break;
+        case PendingUniform::MAT4:
+            set_mat4f(entry.first, glm::make_mat4(pending.values));
+            break;
+        }
+    }
+    pending_uniforms_.clear();
 
-    return program;
+    for (const auto& binding : pending_block_bindings_)
+        uniform_block_bind(binding.first, binding.second);
+    pending_block_bindings_.clear();
 }
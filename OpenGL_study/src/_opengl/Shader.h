@@ -1,14 +1,43 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include "Renderer.h"
 #include "MOS_glm.h"
+#include "UniformHandle.h"
+
+/**
+ * 注入的宏定义，每项为 "NAME"、"NAME VALUE" 或 "NAME=VALUE"
+ */
+typedef std::vector<std::string> ShaderDefines;
+
+// 异步编译未完成时代替绘制的着色器
+const char SHADER_FALLBACK_PATH[] = "res/shaders/basic.shader";
+
+enum class ShaderStatus
+{
+    compiling,
+    ready,
+    failed,
+};
+
+/**
+ * uniform 写入统计，与 CPU 副本相同的写入被省略
+ */
+struct UniformStats
+{
+    unsigned int issued;
+    unsigned int elided;
+};
 
 struct ShaderProgramSource
 {
@@ -20,22 +49,73 @@ struct ShaderProgramSource
 class Shader
 {
 private:
+    /**
+     * 编译期间设置的 uniform，链接完成后重放
+     */
+    struct PendingUniform
+    {
+        enum Type { INT, FLOAT, VEC3, VEC4, MAT4 } type;
+        int   int_value;
+        float values[16];
+    };
+
+    /**
+     * 按位置保存的 uniform 当前值，按字节比较
+     */
+    struct UniformShadow
+    {
+        bool          valid;
+        unsigned char data[sizeof(glm::mat4)];
+    };
+
     unsigned int renderer_id_;
     unsigned int vertex_shader_id_;
     unsigned int fragment_shader_id_;
     unsigned int geometry_shader_id_;
 
     std::string filepath_;
-    std::unordered_map<std::string, int> uniform_cache_;
+    ShaderDefines defines_;
+    std::unordered_map<std::string, UniformInfo> uniforms_;
+    std::vector<UniformShadow> uniform_shadows_;
+
+    ShaderStatus status_;
+    std::string  cache_path_;
+    uint64_t     cache_key_;
+    std::chrono::high_resolution_clock::time_point compile_start_;
+    std::shared_ptr<Shader> fallback_;
+    std::unordered_map<std::string, PendingUniform> pending_uniforms_;
+    std::vector<std::pair<std::string, unsigned int>> pending_block_bindings_;
 
 public:
-    Shader(std::string  filepath);
+    // defines 注入到每个阶段的 #version 之后，同一文件的不同宏组合即不同变体；
+    // async 为真时只提交编译与链接，由 poll() 非阻塞地检查完成状态，期间以默认着色器绘制
+    Shader(std::string filepath, ShaderDefines defines = ShaderDefines(), bool async = false);
     ~Shader();
 
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
+    inline const std::string& get_filepath() const { return filepath_; }
+    inline const ShaderDefines& get_defines() const { return defines_; }
+    inline ShaderStatus get_status() const { return status_; }
+    inline bool is_ready() const { return status_ == ShaderStatus::ready; }
+
+    // 编译中时查询驱动是否完成（不阻塞），完成后检查结果；返回是否已不在编译中
+    bool poll();
+    // 阻塞直到编译结束
+    void wait();
+
+    // 驱动支持 KHR/ARB_parallel_shader_compile，可非阻塞查询完成状态
+    static bool is_parallel_compile_supported();
+
+    // 规范化并排序后的 #define 块，变体键与源码注入共用
+    static std::string make_define_block(const ShaderDefines& defines);
+
     void bind() const;
     void unbind() const;
 
-    void uniform_block_bind(const std::string& name, const unsigned int bind_point = 0) const;
+    void uniform_block_bind(const std::string& name, const unsigned int bind_point = 0);
 
     void set_int(const std::string& name, int value);
     void set_float(const std::string& name, float value);
@@ -45,13 +125,45 @@ public:
     void set_vec4f(const std::string& name, glm::vec4 value);
     void set_mat4f(const std::string& name, const glm::mat4 mat4);
 
+    // 按名字解析一次，名字不存在或类型不符时在此报错并返回无效句柄；
+    // 编译中的着色器会先等待编译完成。required 为假时名字不存在不报错，用于可选的 uniform
+    template <typename T>
+    UniformHandle<T> get_uniform(const std::string& name, bool required = true)
+    {
+        return UniformHandle<T>(resolve_uniform(name, UniformType<T>::value, required));
+    }
+
+    void set(UniformHandle<int> handle, int value);
+    void set(UniformHandle<float> handle, float value);
+    void set(UniformHandle<glm::vec3> handle, const glm::vec3& value);
+    void set(UniformHandle<glm::vec4> handle, const glm::vec4& value);
+    void set(UniformHandle<glm::mat4> handle, const glm::mat4& value);
+
+    inline const std::unordered_map<std::string, UniformInfo>& get_uniforms() const { return uniforms_; }
+
+    // 关闭后每次写入都提交，用于对比；统计为全部着色器之和
+    static void set_uniform_tracking(bool tracking);
+    static bool is_uniform_tracking();
+    static const UniformStats& get_uniform_stats();
+    static void reset_uniform_stats();
+
 private:
     unsigned int compile_shader(unsigned int type, const std::string& source) const;
+    bool check_shader(unsigned int id, unsigned int type) const;
+    void finish_program();
+    void bind_fallback() const;
+    void set_pending(const std::string& name, PendingUniform::Type type, const float *values, int count, int int_value = 0);
     
     ShaderProgramSource parse_shader() const;
+    static ShaderProgramSource parse_shader_source(const char *source, size_t size);
+    static std::string inject_defines(const std::string& source, const std::string& define_block);
     unsigned int create_shader(const std::string& vertex_shader, 
                                const std::string& fragment_shader,
                                const std::string& geometry_shader);
     
-    int get_uniform_location(const std::string& name);
+    void reflect_uniforms();
+    // 写入 CPU 副本，返回是否需要提交到驱动
+    bool update_shadow(int location, const void *value, size_t size);
+    int  resolve_uniform(const std::string& name, unsigned int type, bool required);
+    int  get_uniform_location(const std::string& name);
 };
@@ -0,0 +1,136 @@
+#include "ShaderLibrary.h"
+#include "TextureCache.h"
+
+ShaderLibrary::ShaderLibrary()
+    : compiler_threads_set_(false)
+{
+}
+
+ShaderLibrary& ShaderLibrary::get_instance()
+{
+    static ShaderLibrary instance;
+    return instance;
+}
+
+std::shared_ptr<Shader> ShaderLibrary::get(const std::string& filepath, const ShaderDefines& defines)
+{
+    auto shader = find(filepath, defines);
+    if (shader)
+    {
+        // 同步使用者需要可用的程序
+        shader->wait();
+        return shader;
+    }
+
+    return add(filepath, defines, false);
+}
+
+std::shared_ptr<Shader> ShaderLibrary::get_async(const std::string& filepath, const ShaderDefines& defines)
+{
+    auto shader = find(filepath, defines);
+    if (shader)
+        return shader;
+
+    auto& instance = get_instance();
+    if (!instance.compiler_threads_set_)
+    {
+        // 0xFFFFFFFF 表示由驱动决定编译线程数
+        if (GLEW_KHR_parallel_shader_compile)
+            GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+        else if (GLEW_ARB_parallel_shader_compile)
+            GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+        instance.compiler_threads_set_ = true;
+    }
+
+    shader = add(filepath, defines, true);
+    if (shader->get_status() == ShaderStatus::compiling)
+        instance.compiling_.push_back(shader);
+    return shader;
+}
+
+std::vector<std::shared_ptr<Shader>> ShaderLibrary::get_batch(const std::vector<ShaderVariant>& variants)
+{
+    std::vector<std::shared_ptr<Shader>> shaders;
+    shaders.reserve(variants.size());
+    for (const auto& variant : variants)
+        shaders.push_back(get_async(variant.filepath, variant.defines));
+    return shaders;
+}
+
+size_t ShaderLibrary::poll()
+{
+    auto& compiling = get_instance().compiling_;
+    for (auto it = compiling.begin(); it != compiling.end();)
+    {
+        const auto shader = it->lock();
+        if (!shader || shader->poll())
+            it = compiling.erase(it);
+        else
+            ++it;
+    }
+    return compiling.size();
+}
+
+void ShaderLibrary::wait()
+{
+    auto& compiling = get_instance().compiling_;
+    for (const auto& entry : compiling)
+    {
+        const auto shader = entry.lock();
+        if (shader)
+            shader->wait();
+    }
+    compiling.clear();
+}
+
+std::shared_ptr<Shader> ShaderLibrary::add(const std::string& filepath, const ShaderDefines& defines, const bool async)
+{
+    auto& instance = get_instance();
+
+    // 先构造再登记：异步构造时会经由 get() 取默认着色器，重入注册表
+    const auto shader = std::make_shared<Shader>(filepath, defines, async);
+    instance.shaders_[make_key(filepath, defines)] = shader;
+
+    for (auto it = instance.shaders_.begin(); it != instance.shaders_.end();)
+    {
+        if (it->second.expired())
+            it = instance.shaders_.erase(it);
+        else
+            ++it;
+    }
+
+    return shader;
+}
+
+std::shared_ptr<Shader> ShaderLibrary::find(const std::string& filepath, const ShaderDefines& defines)
+{
+    auto& instance = get_instance();
+
+    const auto it = instance.shaders_.find(make_key(filepath, defines));
+    if (it == instance.shaders_.end())
+        return nullptr;
+
+    auto shader = it->second.lock();
+    if (!shader)
+        instance.shaders_.erase(it);
+
+    return shader;
+}
+
+size_t ShaderLibrary::get_shader_count()
+{
+    auto& instance = get_instance();
+
+    size_t count = 0;
+    for (const auto& entry : instance.shaders_)
+    {
+        if (!entry.second.expired())
+            count++;
+    }
+    return count;
+}
+
+std::string ShaderLibrary::make_key(const std::string& filepath, const ShaderDefines& defines)
+{
+    return TextureCache::canonical_path(filepath) + "|" + Shader::make_define_block(defines);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+
+/**
+ * 着色器变体描述，批量提交时使用
+ */
+struct ShaderVariant
+{
+    std::string   filepath;
+    ShaderDefines defines;
+};
+
+/**
+ * 进程内共享的着色器变体注册表
+ *
+ * 以规范化路径与排序后的宏定义为键，同一 (文件, 宏组合) 只编译一次，
+ * 各处拿到同一个程序；最后一个使用者释放后程序删除。
+ * 异步接口一次提交整批变体，驱动支持 KHR_parallel_shader_compile 时由其编译线程并行处理，
+ * 每帧 poll() 非阻塞地收取完成的程序，未完成的变体以默认着色器绘制。
+ * 只能在 OpenGL 上下文线程使用
+ */
+class ShaderLibrary
+{
+private:
+    std::unordered_map<std::string, std::weak_ptr<Shader>> shaders_;
+    std::vector<std::weak_ptr<Shader>> compiling_;
+    bool compiler_threads_set_;
+
+public:
+    // 查找或编译变体
+    static std::shared_ptr<Shader> get(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
+    // 查找或提交异步编译，返回的变体可能仍在编译中
+    static std::shared_ptr<Shader> get_async(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
+    // 一次提交一批变体，再统一等待，编译时间由驱动的编译线程数而非着色器数量决定
+    static std::vector<std::shared_ptr<Shader>> get_batch(const std::vector<ShaderVariant>& variants);
+    // 只查找，不编译
+    static std::shared_ptr<Shader> find(const std::string& filepath, const ShaderDefines& defines = ShaderDefines());
+
+    // 非阻塞地检查编译中的变体，返回仍未完成的数量
+    static size_t poll();
+    // 阻塞直到所有变体编译结束
+    static void wait();
+
+    // 当前仍存活的变体数量
+    static size_t get_shader_count();
+
+private:
+    ShaderLibrary();
+    static ShaderLibrary& get_instance();
+
+    static std::shared_ptr<Shader> add(const std::string& filepath, const ShaderDefines& defines, bool async);
+    static std::string make_key(const std::string& filepath, const ShaderDefines& defines);
+};
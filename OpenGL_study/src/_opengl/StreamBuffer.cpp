@@ -0,0 +1,200 @@
+#include "StreamBuffer.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const GLbitfield PERSISTENT_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // 区段起点按 256 字节对齐，满足常见的 uniform 偏移对齐要求
+    const unsigned int FRAME_ALIGNMENT = 256;
+
+    unsigned int align_up(const unsigned int value, const unsigned int alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+StreamBuffer::StreamBuffer(const unsigned int frame_size, const bool allow_persistent)
+    : renderer_id_(0), frame_size_(align_up(frame_size, FRAME_ALIGNMENT)),
+      persistent_(allow_persistent && is_persistent_supported()),
+      mapped_(nullptr), frame_(0), head_(0), mapping_(false), fences_(), stats_()
+{
+    GLCall(glGenBuffers(1, &renderer_id_));
+
+    // 映射与分配都用 GL_COPY_WRITE_BUFFER，不影响顶点数组与其他绑定点
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id_));
+    if (persistent_)
+    {
+        const auto size = static_cast<GLsizeiptr>(frame_size_) * STREAM_BUFFER_FRAMES;
+        GLCall(glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, PERSISTENT_FLAGS));
+        GLCall(mapped_ = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, PERSISTENT_FLAGS)));
+        if (mapped_ == nullptr)
+        {
+            std::cout << "[WARNING] StreamBuffer: persistent mapping failed, falling back to orphaning" << std::endl;
+            persistent_ = false;
+
+            // 不可变存储无法再分配，换一个缓冲对象
+            GLCall(glDeleteBuffers(1, &renderer_id_));
+            GLCall(glGenBuffers(1, &renderer_id_));
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id_));
+        }
+    }
+
+    if (!persistent_)
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, frame_size_, nullptr, GL_STREAM_DRAW));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (auto& fence : fences_)
+    {
+        if (fence != nullptr)
+            GLCall(glDeleteSync(fence));
+        fence = nullptr;
+    }
+
+    if (mapped_ != nullptr || mapping_)
+    {
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id_));
+        GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+    }
+    GLCall(glDeleteBuffers(1, &renderer_id_));
+}
+
+bool StreamBuffer::is_persistent_supported()
+{
+    return GLEW_ARB_buffer_storage != 0;
+}
+
+unsigned int StreamBuffer::get_uniform_alignment()
+{
+    static GLint alignment = 0;
+    if (alignment == 0)
+        GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    return alignment > 0 ? static_cast<unsigned int>(alignment) : 1u;
+}
+
+StreamAllocation StreamBuffer::allocate(const unsigned int size, const unsigned int alignment)
+{
+    if (mapping_)
+    {
+        std::cout << "[ERROR] StreamBuffer: allocate called before the previous allocation was committed" << std::endl;
+        return {};
+    }
+
+    const auto offset = align_up(head_, alignment);
+    if (offset + size > frame_size_)
+    {
+        std::cout << "[ERROR] StreamBuffer: frame budget of " << frame_size_ << " bytes exceeded" << std::endl;
+        return {};
+    }
+    head_ = offset + size;
+
+    stats_.allocations++;
+    stats_.bytes += size;
+
+    if (persistent_)
+    {
+        const auto buffer_offset = frame_ * frame_size_ + offset;
+        return { renderer_id_, buffer_offset, size, mapped_ + buffer_offset };
+    }
+
+    // 本帧开始时已孤立旧存储，区间内不会有在途的读取
+    unsigned char *data = nullptr;
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id_));
+    GLCall(data = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+                                                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+    mapping_ = data != nullptr;
+    return { renderer_id_, offset, size, data };
+}
+
+void StreamBuffer::commit(const StreamAllocation& allocation)
+{
+    // 持久映射是一致的，写入对之后的绘制直接可见
+    if (persistent_ || !mapping_ || !allocation.is_valid())
+        return;
+
+    unmap();
+}
+
+void StreamBuffer::unmap()
+{
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id_));
+    GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+    mapping_ = false;
+}
+
+StreamAllocation StreamBuffer::write(const void *data, const unsigned int size, const unsigned int alignment)
+{
+    const auto allocation = allocate(size, alignment);
+    if (allocation.is_valid())
+    {
+        std::memcpy(allocation.data, data, size);
+        commit(allocation);
+    }
+    return allocation;
+}
+
+void StreamBuffer::bind_range(const GLenum target, const unsigned int index, const StreamAllocation& allocation) const
+{
+    GLCall(glBindBufferRange(target, index, allocation.buffer, allocation.offset, allocation.size));
+}
+
+void StreamBuffer::end_frame()
+{
+    if (mapping_)
+    {
+        std::cout << "[WARNING] StreamBuffer: end_frame with an uncommitted allocation" << std::endl;
+        unmap();
+    }
+
+    if (persistent_)
+    {
+        GLCall(fences_[frame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        frame_ = (frame_ + 1) % STREAM_BUFFER_FRAMES;
+    }
+    begin_frame();
+}
+
+void StreamBuffer::begin_frame()
+{
+    head_ = 0;
+
+    if (!persistent_)
+    {
+        // 孤立旧存储，驱动为在途的绘制保留原内容
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, renderer_id_));
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, frame_size_, nullptr, GL_STREAM_DRAW));
+        GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+        return;
+    }
+
+    auto& fence = fences_[frame_];
+    if (fence == nullptr)
+        return;
+
+    // 通常已经完成，只有 CPU 领先 GPU 超过 STREAM_BUFFER_FRAMES 帧时才会等待
+    GLenum result;
+    GLCall(result = glClientWaitSync(fence, 0, 0));
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        do
+        {
+            GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        stats_.fence_waits++;
+        stats_.wait_ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    GLCall(glDeleteSync(fence));
+    fence = nullptr;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "Common.h"
+
+// 同时在途的帧数，写入第 N 帧的区段前等待第 N - 3 帧的栅栏
+const unsigned int STREAM_BUFFER_FRAMES = 3;
+
+/**
+ * 流式缓冲中的一段，data 在 commit 之前可写
+ */
+struct StreamAllocation
+{
+    unsigned int   buffer;
+    unsigned int   offset;      // 在缓冲中的字节偏移
+    unsigned int   size;
+    unsigned char *data;
+
+    inline bool is_valid() const { return data != nullptr; }
+};
+
+struct StreamBufferStats
+{
+    unsigned int  allocations;
+    unsigned int  bytes;
+    unsigned int  fence_waits;  // 等待 GPU 读完旧区段的次数
+    double        wait_ms;
+};
+
+/**
+ * 每帧动态数据的环形缓冲
+ *
+ * 有 ARB_buffer_storage 时整个缓冲持久映射，分为 STREAM_BUFFER_FRAMES 个区段轮流写入，
+ * 每帧结束插入栅栏，回到某区段前只在 GPU 尚未读完时等待，写入就是 memcpy；
+ * 否则退回单区段：每帧开始孤立旧存储，分配时以 UNSYNCHRONIZED 映射子区间，commit 时解除映射。
+ * 分配得到的偏移配合 glBindBufferRange、属性指针或间接绘制偏移使用，只在本帧有效
+ */
+class StreamBuffer
+{
+private:
+    unsigned int   renderer_id_;
+    unsigned int   frame_size_;     // 每个区段的字节数
+    bool           persistent_;
+    unsigned char *mapped_;         // 持久映射的起始地址
+    unsigned int   frame_;          // 当前区段
+    unsigned int   head_;           // 当前区段中已分配的字节数
+    bool           mapping_;        // 退回路径中有未 commit 的映射
+    GLsync         fences_[STREAM_BUFFER_FRAMES];
+    StreamBufferStats stats_;
+
+public:
+    explicit StreamBuffer(unsigned int frame_size, bool allow_persistent = true);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // 超出本帧区段时返回无效分配；退回路径下同一时刻只能有一段未 commit
+    StreamAllocation allocate(unsigned int size, unsigned int alignment = 4);
+    void commit(const StreamAllocation& allocation);
+    // allocate + memcpy + commit
+    StreamAllocation write(const void *data, unsigned int size, unsigned int alignment = 4);
+
+    void bind_range(GLenum target, unsigned int index, const StreamAllocation& allocation) const;
+
+    // 本帧的绘制全部提交后调用，切换到下一区段
+    void end_frame();
+
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
+    inline unsigned int get_frame_size() const { return frame_size_; }
+    inline unsigned int get_used_size() const { return head_; }
+    inline bool is_persistent() const { return persistent_; }
+    inline const StreamBufferStats& get_stats() const { return stats_; }
+    inline void reset_stats() { stats_ = StreamBufferStats(); }
+
+    static bool is_persistent_supported();
+    // glBindBufferRange 绑定 uniform 块时偏移须按此对齐
+    static unsigned int get_uniform_alignment();
+
+private:
+    void begin_frame();
+    void unmap();
+};
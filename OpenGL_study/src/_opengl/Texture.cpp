@@ -1,71 +1,330 @@
 #include "Texture.h"
+#include "AssetPack.h"
+#include "GLState.h"
+#include "TextureContainer.h"
+
+#include <mutex>
+#include <utility>
+
+TextureImage::TextureImage()
+    : pixels_(nullptr), width_(0), height_(0), bpp_(0)
+{
+}
+
+TextureImage::TextureImage(const std::string& filepath, const MipSettings& mip_settings)
+    : pixels_(nullptr), width_(0), height_(0), bpp_(0), filepath_(filepath)
+{
+    // OpenGL 原点在左下角，PNG 原点在左上角，因此要翻转图片
+    // stb_image 的翻转开关是全局变量，只在第一次解码前设置一次，避免工作线程间竞争
+    static std::once_flag flip_flag;
+    std::call_once(flip_flag, []() { stbi_set_flip_vertically_on_load(1); });
+
+    // 已挂载资源包时直接从映射内存解码，否则读文件
+    const auto asset = AssetPack::read(filepath);
+
+    // 预压缩纹理由 texture_cooker 生成，烘焙时已经翻转过
+    if (is_texture_container_path(filepath))
+    {
+        const auto loaded = asset.is_valid()
+            ? load_texture_container(asset.data, asset.size, filepath, compressed_)
+            : load_texture_container(filepath, compressed_);
+        if (loaded)
+        {
+            width_  = static_cast<int>(compressed_.levels.front().width);
+            height_ = static_cast<int>(compressed_.levels.front().height);
+        }
+        return;
+    }
+
+    if (asset.is_valid())
+        pixels_ = stbi_load_from_memory(asset.data, static_cast<int>(asset.size), &width_, &height_, &bpp_, 0);
+    else
+        pixels_ = stbi_load(filepath.c_str(), &width_, &height_, &bpp_, 0);
+    if (pixels_ != nullptr)
+        mip_chain_ = generate_mip_chain(pixels_, width_, height_, bpp_, mip_settings);
+}
+
+TextureImage::~TextureImage()
+{
+    stbi_image_free(pixels_);
+}
+
+TextureImage::TextureImage(TextureImage&& other) noexcept
+    : pixels_(other.pixels_), width_(other.width_), height_(other.height_),
+      bpp_(other.bpp_), filepath_(std::move(other.filepath_)),
+      compressed_(std::move(other.compressed_)), mip_chain_(std::move(other.mip_chain_))
+{
+    other.pixels_ = nullptr;
+}
+
+TextureImage& TextureImage::operator=(TextureImage&& other) noexcept
+{
+    if (this != &other)
+    {
+        stbi_image_free(pixels_);
+        pixels_   = other.pixels_;
+        width_    = other.width_;
+        height_   = other.height_;
+        bpp_      = other.bpp_;
+        filepath_ = std::move(other.filepath_);
+        compressed_ = std::move(other.compressed_);
+        mip_chain_  = std::move(other.mip_chain_);
+        other.pixels_ = nullptr;
+    }
+    return *this;
+}
 
 Texture::Texture(const std::string& filepath, const bool is_model)
     : renderer_id_(0), width_(0), height_(0),
-      bpp_(0), filepath_(filepath), img_buffer_(nullptr),
+      bpp_(0), filepath_(filepath), memory_size_(0),
       is_model_(is_model)
 {
     GLCall(glGenTextures(1, &renderer_id_));
 
-    // OpenGL 原点在左下角，PNG 原点在左上角，因此要翻转图片
-    stbi_set_flip_vertically_on_load(1);
     // load image
-    img_buffer_ = stbi_load(filepath.c_str(), &width_, &height_, &bpp_, 0);
+    const TextureImage image(filepath);
+    upload(image);
+}
+
+Texture::Texture(const TextureImage& image, const bool is_model)
+    : renderer_id_(0), width_(0), height_(0),
+      bpp_(0), filepath_(image.get_filepath()), memory_size_(0),
+      is_model_(is_model)
+{
+    GLCall(glGenTextures(1, &renderer_id_));
+    upload(image);
+}
+
+Texture::Texture(const unsigned char *pixels, const int width, const int height, const int bpp, const bool is_model)
+    : renderer_id_(0), width_(0), height_(0),
+      bpp_(0), memory_size_(0), is_model_(is_model)
+{
+    GLCall(glGenTextures(1, &renderer_id_));
+    upload(pixels, width, height, bpp, generate_mip_chain(pixels, width, height, bpp));
+}
+
+Texture::Texture(const CompressedImage& image, const bool is_model)
+    : renderer_id_(0), width_(0), height_(0),
+      bpp_(0), memory_size_(0), is_model_(is_model)
+{
+    GLCall(glGenTextures(1, &renderer_id_));
+    if (image.is_valid())
+        upload_compressed(image);
+    else
+        std::cout << "[ERROR] Texture: invalid compressed image" << std::endl;
+}
+
+Texture::~Texture()
+{
+    GLCall(glDeleteTextures(1, &renderer_id_));
+    GLState::forget_texture(renderer_id_);
+}
+
+void Texture::bind(const unsigned int slot) const
+{
+    GLState::bind_texture(slot, GL_TEXTURE_2D, renderer_id_);
+}
 
-    if (img_buffer_)
+void Texture::unbind() const
+{
+    GLState::bind_texture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::apply_format_swizzle(const unsigned int target, const CompressedFormat format)
+{
+    // BC4 只有 R 通道，灰度图需把 R 复制到 G、B，否则采样为红色
+    if (format == COMPRESSED_FORMAT_BC4)
+    {
+        GLCall(glTexParameteri(target, GL_TEXTURE_SWIZZLE_G, GL_RED));
+        GLCall(glTexParameteri(target, GL_TEXTURE_SWIZZLE_B, GL_RED));
+    }
+}
+
+bool Texture::is_format_supported(const CompressedFormat format)
+{
+    switch (format)
     {
-        GLenum format = GL_RGBA;
+    case COMPRESSED_FORMAT_BC1:
+    case COMPRESSED_FORMAT_BC3:
+        return GLEW_EXT_texture_compression_s3tc != 0;
+    case COMPRESSED_FORMAT_BC4:
+    case COMPRESSED_FORMAT_BC5:
+        return true;    // RGTC 自 OpenGL 3.0 起为核心功能
+    case COMPRESSED_FORMAT_BC7:
+        return GLEW_ARB_texture_compression_bptc != 0;
+    case COMPRESSED_FORMAT_ETC2_RGB:
+    case COMPRESSED_FORMAT_ETC2_RGBA:
+        return GLEW_ARB_ES3_compatibility != 0;
+    default:
+        return false;
+    }
+}
+
+void Texture::upload(const TextureImage& image)
+{
+    if (image.is_compressed())
+        upload_compressed(image.get_compressed());
+    else
+        upload(image.get_pixels(), image.get_width(), image.get_height(), image.get_bpp(), image.get_mip_chain());
+}
+
+void Texture::upload(const unsigned char *pixels, const int width, const int height, const int bpp, const MipChain& mip_chain)
+{
+    if (pixels != nullptr)
+    {
+        width_  = width;
+        height_ = height;
+        bpp_    = bpp;
+
+        GLenum format = GL_RGBA, internal_format = GL_RGBA8;
         if (bpp_ == 1)
-            format = GL_RED;
+            format = GL_RED, internal_format = GL_R8;
+        else if (bpp_ == 2)
+            format = GL_RG, internal_format = GL_RG8;
         else if (bpp_ == 3)
-            format = GL_RGB;
-        else if (bpp_ == 4)
-            format = GL_RGBA;
-
-        GLCall(glBindTexture(GL_TEXTURE_2D, renderer_id_));
-        GLCall(glTexImage2D(GL_TEXTURE_2D,   0, format,
-                            width_, height_, 0, format,
-                            GL_UNSIGNED_BYTE, img_buffer_));
-        
-        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
-
-        if (is_model)
+            format = GL_RGB, internal_format = GL_RGB8;
+
+        // mip 链已在解码线程生成，这里只做拷贝，不再调用 glGenerateMipmap
+        const auto level_count = static_cast<int>(mip_chain.levels.size()) + 1;
+
+        GLState::bind_texture(GL_TEXTURE_2D, renderer_id_);
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+        const auto immutable = allocate_storage(internal_format, level_count);
+        if (immutable)
         {
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+            GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, format, GL_UNSIGNED_BYTE, pixels));
         }
         else
         {
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+            GLCall(glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internal_format), width_, height_, 0, format, GL_UNSIGNED_BYTE, pixels));
+        }
+        memory_size_ = static_cast<size_t>(width_) * height_ * bpp_;
+
+        for (size_t i = 0, count = mip_chain.levels.size(); i < count; i++)
+        {
+            const auto& level = mip_chain.levels[i];
+            const auto level_width = static_cast<GLsizei>(level.width);
+            const auto level_height = static_cast<GLsizei>(level.height);
+            if (immutable)
+            {
+                GLCall(glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(i + 1), 0, 0, level_width, level_height,
+                                       format, GL_UNSIGNED_BYTE, mip_chain.get_level_data(i)));
+            }
+            else
+            {
+                GLCall(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i + 1), static_cast<GLint>(internal_format), level_width, level_height,
+                                    0, format, GL_UNSIGNED_BYTE, mip_chain.get_level_data(i)));
+            }
+            memory_size_ += static_cast<size_t>(level.width) * level.height * bpp_;
         }
 
-        GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level_count - 1));
+        apply_sampler_parameters(level_count > 1);
+
+        GLState::bind_texture(GL_TEXTURE_2D, 0);
     }
     else
     {
         std::cout << "[ERROR] Texture failed to load at path: " << filepath_ << std::endl;
     }
-
-    stbi_image_free(img_buffer_);
 }
 
-Texture::~Texture()
+void Texture::upload_compressed(const CompressedImage& image)
 {
-    GLCall(glDeleteTextures(1, &renderer_id_));
+    const auto& base = image.levels.front();
+    width_  = static_cast<int>(base.width);
+    height_ = static_cast<int>(base.height);
+    bpp_    = 4;
+
+    const auto level_count = static_cast<int>(image.levels.size());
+
+    GLState::bind_texture(GL_TEXTURE_2D, renderer_id_);
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+    if (is_format_supported(image.format))
+    {
+        const auto internal_format = get_gl_internal_format(image.format);
+        const auto immutable = allocate_storage(internal_format, level_count);
+        memory_size_ = 0;
+        for (auto level = 0; level < level_count; level++)
+        {
+            const auto& info = image.levels[level];
+            const auto level_width = static_cast<GLsizei>(info.width);
+            const auto level_height = static_cast<GLsizei>(info.height);
+            if (immutable)
+            {
+                GLCall(glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, level_width, level_height, internal_format,
+                                                 static_cast<GLsizei>(info.size), image.get_level_data(level)));
+            }
+            else
+            {
+                GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, internal_format, level_width, level_height, 0,
+                                              static_cast<GLsizei>(info.size), image.get_level_data(level)));
+            }
+            memory_size_ += info.size;
+        }
+        apply_format_swizzle(GL_TEXTURE_2D, image.format);
+    }
+    else
+    {
+        // 驱动不支持时解压为 RGBA8，保留文件中的 mip 级别
+        std::cout << "[WARNING] Texture: " << get_format_name(image.format)
+                  << " is not supported by the driver, decompressing " << filepath_ << std::endl;
+
+        std::vector<unsigned char> rgba;
+        memory_size_ = 0;
+        for (auto level = 0; level < level_count; level++)
+        {
+            if (!decompress_level(image, level, rgba))
+            {
+                std::cout << "[ERROR] Texture: no decoder for " << get_format_name(image.format) << " at path: " << filepath_ << std::endl;
+                GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+                GLState::bind_texture(GL_TEXTURE_2D, 0);
+                return;
+            }
+
+            const auto& info = image.levels[level];
+            GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8,
+                                static_cast<GLsizei>(info.width), static_cast<GLsizei>(info.height), 0,
+                                GL_RGBA, GL_UNSIGNED_BYTE, rgba.data()));
+            memory_size_ += rgba.size();
+        }
+    }
+
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level_count - 1));
+    apply_sampler_parameters(level_count > 1);
+
+    GLState::bind_texture(GL_TEXTURE_2D, 0);
 }
 
-void Texture::bind(const unsigned int slot) const
+bool Texture::allocate_storage(const unsigned int internal_format, const int level_count) const
 {
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_2D, renderer_id_));
+    // 不可变存储一次分配全部级别，驱动无需在首次绘制时检查 mip 完整性
+    if (!GLEW_ARB_texture_storage)
+        return false;
+
+    GLCall(glTexStorage2D(GL_TEXTURE_2D, level_count, internal_format, width_, height_));
+    return true;
 }
 
-void Texture::unbind() const
+void Texture::apply_sampler_parameters(const bool has_mipmaps) const
 {
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    if (is_model_)
+    {
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, has_mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+    }
+    else
+    {
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    }
 }
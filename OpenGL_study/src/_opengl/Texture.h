@@ -4,6 +4,45 @@
 
 #include "Common.h"
 #include "MOS_stb_image.h"
+#include "MipGenerator.h"
+#include "TextureCompression.h"
+
+/**
+ * 解码后的图片数据，不依赖 OpenGL 上下文，可在工作线程中构造
+ * .dds / .ktx 路径读取为预压缩数据（含全部 mip 级别），其余格式由 stb_image 解码，
+ * 并在构造线程中按 mip_settings 生成 mip 链
+ */
+class TextureImage
+{
+private:
+    unsigned char* pixels_;
+    int width_, height_;
+    int bpp_;
+    std::string filepath_;
+
+    CompressedImage compressed_;
+    MipChain        mip_chain_;
+
+public:
+    TextureImage();
+    explicit TextureImage(const std::string& filepath, const MipSettings& mip_settings = MipSettings());
+    ~TextureImage();
+
+    TextureImage(const TextureImage&) = delete;
+    TextureImage& operator=(const TextureImage&) = delete;
+    TextureImage(TextureImage&& other) noexcept;
+    TextureImage& operator=(TextureImage&& other) noexcept;
+
+    inline bool is_valid() const { return pixels_ != nullptr || compressed_.is_valid(); }
+    inline bool is_compressed() const { return compressed_.is_valid(); }
+    inline const CompressedImage& get_compressed() const { return compressed_; }
+    inline const MipChain& get_mip_chain() const { return mip_chain_; }
+    inline const unsigned char* get_pixels() const { return pixels_; }
+    inline int get_width() const { return width_; }
+    inline int get_height() const { return height_; }
+    inline int get_bpp() const { return bpp_; }
+    inline const std::string& get_filepath() const { return filepath_; }
+};
 
 class Texture
 {
@@ -12,18 +51,39 @@ private:
     int width_, height_;
     int bpp_;
     std::string filepath_;
-    unsigned char* img_buffer_;
-    
+    size_t memory_size_;
+
     bool is_model_;
 
 public:
     Texture(const std::string& filepath, const bool is_model = false);
+    // 上传已解码的图片，必须在 OpenGL 上下文线程调用
+    Texture(const TextureImage& image, const bool is_model = false);
+    // 直接上传内存中的像素，用于占位纹理等程序生成的图片
+    Texture(const unsigned char *pixels, int width, int height, int bpp, const bool is_model = false);
+    // 直接上传内存中的压缩数据
+    Texture(const CompressedImage& image, const bool is_model = false);
     ~Texture();
-   
+
     void bind(unsigned int slot = 0) const;
     void unbind() const;
 
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
     inline int get_width() const { return width_; }
     inline int get_height() const { return height_; }
-};
+    // 估算的显存占用（含 mip 级别）
+    inline size_t get_memory_size() const { return memory_size_; }
+
+    // 当前驱动能否直接采样该压缩格式
+    static bool is_format_supported(CompressedFormat format);
+    // 直接采样压缩格式时设置通道重排，使结果与 decompress_level 一致；需先绑定到 target
+    static void apply_format_swizzle(unsigned int target, CompressedFormat format);
 
+private:
+    void upload(const TextureImage& image);
+    void upload(const unsigned char *pixels, int width, int height, int bpp, const MipChain& mip_chain);
+    void upload_compressed(const CompressedImage& image);
+    // 支持 ARB_texture_storage 时分配不可变存储并返回 true，需先绑定纹理
+    bool allocate_storage(unsigned int internal_format, int level_count) const;
+    void apply_sampler_parameters(bool has_mipmaps) const;
+};
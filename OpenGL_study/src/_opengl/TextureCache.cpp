@@ -0,0 +1,128 @@
+#include "TextureCache.h"
+#include "AssetPack.h"
+
+TextureCache& TextureCache::get_instance()
+{
+    static TextureCache instance;
+    return instance;
+}
+
+std::shared_ptr<Texture> TextureCache::get(const std::string& filepath, const bool is_model)
+{
+    auto texture = find(filepath, is_model);
+    if (texture)
+        return texture;
+
+    // 加载过程不持锁，同一路径并发加载时以先登记者为准
+    return add(TextureImage(filepath), is_model);
+}
+
+std::shared_ptr<Texture> TextureCache::find(const std::string& filepath, const bool is_model)
+{
+    auto& instance = get_instance();
+    const auto key = make_key(filepath, is_model);
+
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+    const auto it = instance.textures_.find(key);
+    if (it == instance.textures_.end())
+        return nullptr;
+
+    auto texture = it->second.lock();
+    if (!texture)
+        instance.textures_.erase(it);
+
+    return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::add(const TextureImage& image, const bool is_model)
+{
+    auto& instance = get_instance();
+    const auto key = make_key(image.get_filepath(), is_model);
+
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+    auto& entry = instance.textures_[key];
+    auto texture = entry.lock();
+    if (!texture)
+    {
+        texture = std::make_shared<Texture>(image, is_model);
+        entry = texture;
+        purge_expired(instance.textures_);
+    }
+
+    return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::get_placeholder()
+{
+    auto& instance = get_instance();
+
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+    auto& entry = instance.textures_["<placeholder>"];
+    auto texture = entry.lock();
+    if (!texture)
+    {
+        const unsigned char pixels[] = { 255, 255, 255, 255 };
+        texture = std::make_shared<Texture>(pixels, 1, 1, 4, true);
+        entry = texture;
+    }
+
+    return texture;
+}
+
+std::shared_ptr<CubeTexture> TextureCache::get_cube(const std::vector<std::string>& face_paths, const bool mipmaps)
+{
+    auto& instance = get_instance();
+
+    std::string key;
+    for (const auto& face_path : face_paths)
+        key += canonical_path(face_path) + "|";
+    key += mipmaps ? "mipmaps" : "default";
+
+    {
+        std::lock_guard<std::mutex> lock(instance.mutex_);
+        const auto it = instance.cube_textures_.find(key);
+        if (it != instance.cube_textures_.end())
+        {
+            auto cube_texture = it->second.lock();
+            if (cube_texture)
+                return cube_texture;
+        }
+    }
+
+    // 加载过程不持锁：CubeTexture 构造时会执行上传队列中的任务，其中可能调用 add
+    auto loaded = std::make_shared<CubeTexture>(face_paths, mipmaps);
+
+    // 同一组面并发加载时以先登记者为准
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+    auto& entry = instance.cube_textures_[key];
+    auto cube_texture = entry.lock();
+    if (!cube_texture)
+    {
+        cube_texture = loaded;
+        entry = cube_texture;
+        purge_expired(instance.cube_textures_);
+    }
+
+    return cube_texture;
+}
+
+size_t TextureCache::get_texture_count()
+{
+    auto& instance = get_instance();
+
+    std::lock_guard<std::mutex> lock(instance.mutex_);
+    purge_expired(instance.textures_);
+    purge_expired(instance.cube_textures_);
+    return instance.textures_.size() + instance.cube_textures_.size();
+}
+
+std::string TextureCache::canonical_path(const std::string& filepath)
+{
+    // 与资源包使用同一套规范化规则
+    return AssetPack::normalize_path(filepath);
+}
+
+std::string TextureCache::make_key(const std::string& filepath, const bool is_model)
+{
+    return canonical_path(filepath) + (is_model ? "|model" : "|default");
+}
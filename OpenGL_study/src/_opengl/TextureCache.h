@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+#include "CubeTexture.h"
+
+/**
+ * 进程内共享的纹理注册表
+ *
+ * 以规范化路径与采样选项为键，返回引用计数的纹理；
+ * 最后一个使用者释放后纹理析构，显存随之释放。
+ * 注意：纹理的最后一个引用必须在 OpenGL 上下文线程释放
+ */
+class TextureCache
+{
+private:
+    std::unordered_map<std::string, std::weak_ptr<Texture>>     textures_;
+    std::unordered_map<std::string, std::weak_ptr<CubeTexture>> cube_textures_;
+    std::mutex mutex_;
+
+public:
+    // 查找或加载二维纹理
+    static std::shared_ptr<Texture> get(const std::string& filepath, bool is_model = false);
+    // 只查找，不加载
+    static std::shared_ptr<Texture> find(const std::string& filepath, bool is_model = false);
+    // 用已解码的图片创建纹理并登记，已存在时直接返回已有纹理
+    static std::shared_ptr<Texture> add(const TextureImage& image, bool is_model = false);
+
+    // 1x1 白色占位纹理，异步加载的模型在真实纹理就绪前使用
+    static std::shared_ptr<Texture> get_placeholder();
+
+    // 查找或加载立方体贴图，以六个面的路径与是否生成 mip 为键
+    static std::shared_ptr<CubeTexture> get_cube(const std::vector<std::string>& face_paths, bool mipmaps = false);
+
+    // 当前仍存活的纹理数量
+    static size_t get_texture_count();
+
+    // 统一分隔符并折叠 "." 与 ".." 路径段
+    static std::string canonical_path(const std::string& filepath);
+
+private:
+    TextureCache() = default;
+    static TextureCache& get_instance();
+
+    static std::string make_key(const std::string& filepath, bool is_model);
+
+    template <typename T>
+    static void purge_expired(std::unordered_map<std::string, std::weak_ptr<T>>& map)
+    {
+        for (auto it = map.begin(); it != map.end();)
+        {
+            if (it->second.expired())
+                it = map.erase(it);
+            else
+                ++it;
+        }
+    }
+};
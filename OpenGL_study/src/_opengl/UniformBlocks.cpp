@@ -0,0 +1,142 @@
+#include "UniformBlocks.h"
+#include "UniformBuffer.h"
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct BlockMember
+    {
+        const char *name;
+        size_t      offset;
+    };
+
+    struct BlockLayout
+    {
+        const char  *name;
+        unsigned int binding;
+        size_t       size;
+        std::vector<BlockMember> members;
+    };
+
+    // 每个结构体校验首尾成员，数组额外校验第二个元素以确认步长
+    const std::vector<BlockLayout>& get_block_layouts()
+    {
+        static const std::vector<BlockLayout> layouts = {
+            { "FrameBlock", FRAME_BLOCK_BINDING, sizeof(FrameUniforms), {
+                { "u_Proj",    offsetof(FrameUniforms, proj) },
+                { "u_View",    offsetof(FrameUniforms, view) },
+                { "u_ViewPos", offsetof(FrameUniforms, view_pos) },
+                { "u_Time",    offsetof(FrameUniforms, time) },
+            } },
+            { "LightingBlock", LIGHTING_BLOCK_BINDING, sizeof(LightingUniforms), {
+                { "u_DirLight.direction",          offsetof(LightingUniforms, dir_light) + offsetof(DirLightUniforms, direction) },
+                { "u_DirLight.specular",           offsetof(LightingUniforms, dir_light) + offsetof(DirLightUniforms, specular) },
+                { "u_SpotLight.position",          offsetof(LightingUniforms, spot_light) + offsetof(SpotLightUniforms, position) },
+                { "u_SpotLight.specular",          offsetof(LightingUniforms, spot_light) + offsetof(SpotLightUniforms, specular) },
+                { "u_SpotLight.cut_off",           offsetof(LightingUniforms, spot_light) + offsetof(SpotLightUniforms, cut_off) },
+                { "u_SpotLight.outer_cut_off",     offsetof(LightingUniforms, spot_light) + offsetof(SpotLightUniforms, outer_cut_off) },
+                { "u_PointLights[0].position",     offsetof(LightingUniforms, point_lights) + offsetof(PointLightUniforms, position) },
+                { "u_PointLights[0].constant",     offsetof(LightingUniforms, point_lights) + offsetof(PointLightUniforms, constant) },
+                { "u_PointLights[0].quadratic",    offsetof(LightingUniforms, point_lights) + offsetof(PointLightUniforms, quadratic) },
+                { "u_PointLights[1].position",     offsetof(LightingUniforms, point_lights) + sizeof(PointLightUniforms) },
+                { "u_DistanceRate",                offsetof(LightingUniforms, distance_rate) },
+            } },
+            { "MaterialBlock", MATERIAL_BLOCK_BINDING, sizeof(MaterialUniforms), {
+                { "u_Shininess", offsetof(MaterialUniforms, shininess) },
+            } },
+        };
+        return layouts;
+    }
+
+    bool validate_block(const unsigned int program, const unsigned int block_index,
+                        const BlockLayout& layout, const std::string& name)
+    {
+        auto valid = true;
+
+        // 驱动报告的大小可能不含末尾填充，只要不超过 C++ 结构体即可
+        GLint data_size = 0;
+        GLCall(glGetActiveUniformBlockiv(program, block_index, GL_UNIFORM_BLOCK_DATA_SIZE, &data_size));
+        if (static_cast<size_t>(data_size) > layout.size)
+        {
+            std::cout << "[ERROR] UniformBlocks: " << layout.name << " in " << name << " is " << data_size
+                      << " bytes, C++ struct is " << layout.size << " bytes" << std::endl;
+            valid = false;
+        }
+
+        // std140 块的成员全部为活动 uniform，查不到说明着色器中的定义与约定不符
+        for (const auto& member : layout.members)
+        {
+            GLuint index = GL_INVALID_INDEX;
+            GLCall(glGetUniformIndices(program, 1, &member.name, &index));
+            if (index == GL_INVALID_INDEX)
+            {
+                std::cout << "[ERROR] UniformBlocks: " << layout.name << " in " << name
+                          << " has no member " << member.name << std::endl;
+                valid = false;
+                continue;
+            }
+
+            GLint offset = -1;
+            GLCall(glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_OFFSET, &offset));
+            if (static_cast<size_t>(offset) != member.offset)
+            {
+                std::cout << "[ERROR] UniformBlocks: " << layout.name << "." << member.name << " in " << name
+                          << " is at offset " << offset << ", C++ struct expects " << member.offset << std::endl;
+                valid = false;
+            }
+        }
+        return valid;
+    }
+}
+
+UniformBlocks::UniformBlocks()
+    : frame_buffer_(new UniformBuffer(sizeof(FrameUniforms), FRAME_BLOCK_BINDING)),
+      lighting_buffer_(new UniformBuffer(sizeof(LightingUniforms), LIGHTING_BLOCK_BINDING)),
+      material_buffer_(new UniformBuffer(sizeof(MaterialUniforms), MATERIAL_BLOCK_BINDING))
+{
+}
+
+UniformBlocks::~UniformBlocks() = default;
+
+UniformBlocks& UniformBlocks::get_instance()
+{
+    static UniformBlocks instance;
+    return instance;
+}
+
+void UniformBlocks::set_frame(const FrameUniforms& frame)
+{
+    get_instance().frame_buffer_->put_data(sizeof(frame), &frame);
+}
+
+void UniformBlocks::set_lighting(const LightingUniforms& lighting)
+{
+    get_instance().lighting_buffer_->put_data(sizeof(lighting), &lighting);
+}
+
+void UniformBlocks::set_material(const MaterialUniforms& material)
+{
+    get_instance().material_buffer_->put_data(sizeof(material), &material);
+}
+
+bool UniformBlocks::bind_program(const unsigned int program, const std::string& name)
+{
+    // 首次使用时创建缓冲并绑定到各绑定点，程序绑定前数据为零
+    get_instance();
+
+    auto valid = true;
+    for (const auto& layout : get_block_layouts())
+    {
+        GLuint block_index = GL_INVALID_INDEX;
+        GLCall(block_index = glGetUniformBlockIndex(program, layout.name));
+        if (block_index == GL_INVALID_INDEX)
+            continue;
+
+        GLCall(glUniformBlockBinding(program, block_index, layout.binding));
+        valid = validate_block(program, block_index, layout, name) && valid;
+    }
+    return valid;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "MOS_glm.h"
+
+class UniformBuffer;
+
+// 引擎 uniform 块的绑定点，避开测试程序自行使用的低编号
+const unsigned int FRAME_BLOCK_BINDING    = 8;
+const unsigned int LIGHTING_BLOCK_BINDING = 9;
+const unsigned int MATERIAL_BLOCK_BINDING = 10;
+
+// 与 res/shaders/lighting.glsl 中的 MAX_POINT_LIGHTS 一致
+const unsigned int MAX_POINT_LIGHTS = 8;
+
+/**
+ * 以下结构体按 std140 排列，与 res/shaders 中的块定义逐字段对应：
+ * vec3 占 12 字节、按 16 字节对齐，其后的 float 可填入剩余 4 字节；结构体与数组元素按 16 字节对齐
+ */
+
+// FrameBlock，见 res/shaders/frame.glsl
+struct FrameUniforms
+{
+    glm::mat4 proj;
+    glm::mat4 view;
+    glm::vec3 view_pos;
+    float     time;
+};
+
+struct DirLightUniforms
+{
+    glm::vec3 direction;
+    float     padding0;
+    glm::vec3 ambient;
+    float     padding1;
+    glm::vec3 diffuse;
+    float     padding2;
+    glm::vec3 specular;
+    float     padding3;
+};
+
+struct PointLightUniforms
+{
+    glm::vec3 position;
+    float     padding0;
+    glm::vec3 ambient;
+    float     padding1;
+    glm::vec3 diffuse;
+    float     padding2;
+    glm::vec3 specular;
+    float     constant;
+    float     linear;
+    float     quadratic;
+    float     padding3[2];
+};
+
+struct SpotLightUniforms
+{
+    glm::vec3 position;
+    float     padding0;
+    glm::vec3 direction;
+    float     padding1;
+    glm::vec3 ambient;
+    float     padding2;
+    glm::vec3 diffuse;
+    float     padding3;
+    glm::vec3 specular;
+    float     cut_off;
+    float     outer_cut_off;
+    float     padding4[3];
+};
+
+// LightingBlock，见 res/shaders/lighting.glsl
+struct LightingUniforms
+{
+    DirLightUniforms   dir_light;
+    SpotLightUniforms  spot_light;
+    PointLightUniforms point_lights[MAX_POINT_LIGHTS];
+    float              distance_rate;
+    float              padding[3];
+};
+
+// MaterialBlock，见 res/shaders/material_block.glsl
+struct MaterialUniforms
+{
+    float shininess;
+    float padding[3];
+};
+
+static_assert(sizeof(FrameUniforms) == 144, "FrameUniforms does not match std140");
+static_assert(sizeof(DirLightUniforms) == 64, "DirLightUniforms does not match std140");
+static_assert(sizeof(PointLightUniforms) == 80, "PointLightUniforms does not match std140");
+static_assert(sizeof(SpotLightUniforms) == 96, "SpotLightUniforms does not match std140");
+static_assert(sizeof(LightingUniforms) == 816, "LightingUniforms does not match std140");
+static_assert(sizeof(MaterialUniforms) == 16, "MaterialUniforms does not match std140");
+
+/**
+ * 引擎级 uniform 块
+ *
+ * 每帧的相机数据、全部光源与材质参数各放在一个 std140 块中，每帧（或每次材质切换）上传一次，
+ * 使用这些块的着色器共享同一份数据，不再逐个程序、逐次绘制以字符串名写 uniform。
+ * 程序链接后由 Shader 调用 bind_program，把块绑定到固定绑定点，
+ * 并用 glGetActiveUniformBlockiv / glGetActiveUniformsiv 校验大小与成员偏移是否与 C++ 结构体一致。
+ * 只能在 OpenGL 上下文线程使用
+ */
+class UniformBlocks
+{
+private:
+    std::unique_ptr<UniformBuffer> frame_buffer_;
+    std::unique_ptr<UniformBuffer> lighting_buffer_;
+    std::unique_ptr<UniformBuffer> material_buffer_;
+
+public:
+    ~UniformBlocks();
+
+    static void set_frame(const FrameUniforms& frame);
+    static void set_lighting(const LightingUniforms& lighting);
+    static void set_material(const MaterialUniforms& material);
+
+    // 绑定程序中出现的引擎块并校验布局，布局不一致时输出错误并返回 false
+    static bool bind_program(unsigned int program, const std::string& name);
+
+private:
+    UniformBlocks();
+
+    static UniformBlocks& get_instance();
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "MOS_glm.h"
+
+class Shader;
+
+/**
+ * 链接后反射得到的活动 uniform，数组额外登记不带下标的基名与每个元素
+ */
+struct UniformInfo
+{
+    int          location;
+    unsigned int type;      // GL_FLOAT_MAT4 等，未知名字为 0
+    int          size;      // 数组长度，非数组为 1
+};
+
+/**
+ * C++ 类型与 GLSL 类型的对应，int 同时接受 bool 与采样器
+ */
+template <typename T> struct UniformType;
+template <> struct UniformType<int>       { static const unsigned int value = GL_INT; };
+template <> struct UniformType<float>     { static const unsigned int value = GL_FLOAT; };
+template <> struct UniformType<glm::vec3> { static const unsigned int value = GL_FLOAT_VEC3; };
+template <> struct UniformType<glm::vec4> { static const unsigned int value = GL_FLOAT_VEC4; };
+template <> struct UniformType<glm::mat4> { static const unsigned int value = GL_FLOAT_MAT4; };
+
+/**
+ * 已解析的 uniform 位置，只对解析它的 Shader 有效；设置时不再查表或构造字符串
+ */
+template <typename T>
+class UniformHandle
+{
+private:
+    int location_;
+
+    explicit UniformHandle(const int location) : location_(location) {}
+    friend class Shader;
+
+public:
+    UniformHandle() : location_(-1) {}
+
+    inline bool is_valid() const { return location_ != -1; }
+    inline int get_location() const { return location_; }
+};
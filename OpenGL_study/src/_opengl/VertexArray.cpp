@@ -1,7 +1,9 @@
 #include "VertexArray.h"
+#include "GLState.h"
+#include "InstanceBuffer.h"
 
 VertexArray::VertexArray()
-    : vertex_buffer_(nullptr), index_buffer_(nullptr)
+    : vertex_buffer_(nullptr), index_buffer_(nullptr), instance_serial_(0), instance_offset_(0)
 {
     GLCall(glGenVertexArrays(1, &renderer_id_));
 }
@@ -10,6 +12,7 @@ VertexArray::~VertexArray()
 {
     unbind();
     GLCall(glDeleteVertexArrays(1, &renderer_id_));
+    GLState::forget_vertex_array(renderer_id_);
     vertex_buffer_ = nullptr;
     index_buffer_ = nullptr;
 }
@@ -25,35 +28,61 @@ void VertexArray::add_buffer(VertexBuffer&       vertex_buffer,
     vertex_buffer.bind();
     index_buffer.bind();
 
-    const auto& elements = vertex_buffer_layout.get_elements();
-    unsigned int offset = 0;
+    set_attributes(vertex_buffer_layout, 0);
+
+    unbind();
+}
+
+void VertexArray::set_instance_buffer(const InstanceBuffer& instance_buffer, const unsigned int first_instance)
+{
+    const auto offset = instance_buffer.get_offset() + first_instance * static_cast<unsigned int>(sizeof(InstanceData));
+
+    bind();
+    instance_buffer.bind();
+    set_attributes(InstanceBuffer::get_layout(), INSTANCE_ATTRIBUTE_LOCATION, offset);
+    instance_serial_ = instance_buffer.get_serial();
+    instance_offset_ = offset;
+    instance_buffer.unbind();
+}
+
+bool VertexArray::has_instance_buffer(const InstanceBuffer& instance_buffer, const unsigned int first_instance) const
+{
+    // 流式实例缓冲每帧写在不同偏移，偏移变化时需重新设置属性指针
+    return instance_serial_ == instance_buffer.get_serial() &&
+           instance_offset_ == instance_buffer.get_offset() + first_instance * static_cast<unsigned int>(sizeof(InstanceData));
+}
+
+void VertexArray::set_attributes(const VertexBufferLayout& layout, const unsigned int first_location,
+                                 const unsigned int base_offset) const
+{
+    const auto& elements = layout.get_elements();
+    auto offset = base_offset;
     for (size_t i = 0; i < elements.size(); ++i)
     {
-        GLCall(glEnableVertexAttribArray(i));
-        GLCall(glVertexAttribPointer(i, 
+        const auto location = static_cast<unsigned int>(first_location + i);
+        GLCall(glEnableVertexAttribArray(location));
+        GLCall(glVertexAttribPointer(location, 
                                      elements[i].count, 
                                      elements[i].type,
                                      elements[i].normalized,
-                                     vertex_buffer_layout.get_stride(),
+                                     layout.get_stride(),
                                      reinterpret_cast<const void*>(offset)));
 
         if (elements[i].divisor != 0)
-            GLCall(glVertexAttribDivisor(i, elements[i].divisor));
+            GLCall(glVertexAttribDivisor(location, elements[i].divisor));
 
-        offset += elements[i].count * VertexBufferLayoutElement::get_type_size(elements[i].type);
+        offset += elements[i].get_size();
     }
-
-    unbind();
 }
 
 void VertexArray::bind() const
 {
-    GLCall(glBindVertexArray(renderer_id_));
+    GLState::bind_vertex_array(renderer_id_);
 }
 
 void VertexArray::unbind() const
 {
-    GLCall(glBindVertexArray(0));
+    GLState::bind_vertex_array(0);
 
     if (vertex_buffer_)
         vertex_buffer_->unbind();
@@ -4,9 +4,12 @@
 #include "VertexBufferLayout.h"
 #include "IndexBuffer.h"
 
+#include <cstdint>
+
 class VertexBuffer;
 class VertexBufferLayout;
 class IndexBuffer;
+class InstanceBuffer;
 
 class VertexArray
 {
@@ -15,6 +18,8 @@ private:
 
     VertexBuffer *vertex_buffer_;
     IndexBuffer  *index_buffer_;
+    uint64_t      instance_serial_;     // 已挂接的 InstanceBuffer 编号，0 表示未挂接
+    unsigned int  instance_offset_;     // 逐实例属性指针的起始字节偏移
 
 public:
     VertexArray();
@@ -23,11 +28,19 @@ public:
     void add_buffer(VertexBuffer&       vertex_buffer, 
                     VertexBufferLayout& vertex_buffer_layout,
                     IndexBuffer&        index_buffer);
+    // 在 INSTANCE_ATTRIBUTE_LOCATION 起挂接逐实例属性，替换之前挂接的缓冲
+    // first_instance 使属性从该实例开始读取，用于没有 base instance 的驱动
+    void set_instance_buffer(const InstanceBuffer& instance_buffer, unsigned int first_instance = 0);
+    bool has_instance_buffer(const InstanceBuffer& instance_buffer, unsigned int first_instance = 0) const;
 
     void bind() const;
     void unbind() const;
 
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
     inline VertexBuffer* get_vertex_buffer() const { return vertex_buffer_; }
     inline IndexBuffer* get_index_buffer() const { return index_buffer_; }
+
+private:
+    void set_attributes(const VertexBufferLayout& layout, unsigned int first_location, unsigned int base_offset = 0) const;
 };
 
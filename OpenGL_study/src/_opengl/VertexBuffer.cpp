@@ -1,21 +1,31 @@
 #include "VertexBuffer.h"
+#include "BufferHeap.h"
 
 VertexBuffer::VertexBuffer(const void* data, const unsigned int& size)
-    : renderer_id_(0)
+    : renderer_id_(0), heap_(nullptr), heap_handle_(BUFFER_HEAP_INVALID)
 {
     GLCall(glGenBuffers(1, &renderer_id_));
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, renderer_id_));
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
+VertexBuffer::VertexBuffer(const void* data, const unsigned int& size, BufferHeap& heap, const unsigned int stride)
+    : renderer_id_(0), heap_(&heap), heap_handle_(heap.allocate(data, size, stride))
+{
+    if (heap_handle_ != BUFFER_HEAP_INVALID)
+        renderer_id_ = heap.get_buffer(heap_handle_);
+}
+
 VertexBuffer::VertexBuffer(const VertexBuffer& other)
-    : renderer_id_(other.renderer_id_)
+    : renderer_id_(other.renderer_id_), heap_(other.heap_), heap_handle_(other.heap_handle_)
 {
 }
 
 VertexBuffer::~VertexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &renderer_id_));
+    // 缓冲堆的页由缓冲堆释放
+    if (heap_ == nullptr)
+        GLCall(glDeleteBuffers(1, &renderer_id_));
     unbind();
     renderer_id_= 0;
 }
@@ -29,3 +39,15 @@ void VertexBuffer::unbind() const
 {
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
+
+void VertexBuffer::release()
+{
+    if (heap_ != nullptr && heap_handle_ != BUFFER_HEAP_INVALID)
+        heap_->free(heap_handle_);
+    heap_handle_ = BUFFER_HEAP_INVALID;
+}
+
+unsigned int VertexBuffer::get_offset() const
+{
+    return heap_ != nullptr && heap_handle_ != BUFFER_HEAP_INVALID ? heap_->get_offset(heap_handle_) : 0;
+}
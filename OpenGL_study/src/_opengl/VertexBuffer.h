@@ -2,17 +2,31 @@
 
 #include "Renderer.h"
 
+class BufferHeap;
+
 class VertexBuffer
 {
 private:
     unsigned int renderer_id_;
 
+    BufferHeap  *heap_;         // 从缓冲堆分配时非空，renderer_id_ 为所在页
+    unsigned int heap_handle_;
+
 public:
     VertexBuffer(const void* data, const unsigned int& size);
+    // 从缓冲堆中分配，偏移按 stride 对齐，绘制时以 get_offset() / stride 作为 base vertex
+    VertexBuffer(const void* data, const unsigned int& size, BufferHeap& heap, unsigned int stride);
     VertexBuffer(const VertexBuffer& other);
     ~VertexBuffer();
 
     void bind() const;
     void unbind() const;
-};
 
+    // 归还缓冲堆中的区间，析构时不会自动归还（副本共享同一区间）
+    void release();
+
+    // 在缓冲中的字节偏移，碎片整理后会变化，需在绘制时查询
+    unsigned int get_offset() const;
+    inline bool is_heap_allocated() const { return heap_ != nullptr; }
+    inline unsigned int get_renderer_id() const { return renderer_id_; }
+};
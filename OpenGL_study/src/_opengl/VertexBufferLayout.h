@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cstdint>
+#include <iostream>
 #include <vector>
 #include <GL/glew.h>
 
 #include "Renderer.h"
 
+/**
+ * 压缩顶点属性的类型标记，仅用于 VertexBufferLayout::push
+ */
+struct HalfFloat        { uint16_t bits; };     // GL_HALF_FLOAT
+struct PackedInt2101010 { uint32_t bits; };     // GL_INT_2_10_10_10_REV，xyz 各 10 位，w 2 位
+
 struct VertexBufferLayoutElement
 {
     unsigned int  type;         // 类型
@@ -19,12 +27,25 @@ struct VertexBufferLayoutElement
         case GL_FLOAT:          return 4;
         case GL_UNSIGNED_INT:   return 4;
         case GL_UNSIGNED_BYTE:  return 1;
+        case GL_HALF_FLOAT:     return 2;
+        case GL_SHORT:          return 2;
+        case GL_UNSIGNED_SHORT: return 2;
+        // 四个分量打包在一个 32 位整数中
+        case GL_INT_2_10_10_10_REV: return 4;
         }
 
         // TODO: log error info : type not support
         ASSERT(false);
         return 0;
     }
+
+    // 该属性在顶点中占用的字节数
+    unsigned int get_size() const
+    {
+        if (type == GL_INT_2_10_10_10_REV)
+            return get_type_size(type);
+        return count * get_type_size(type);
+    }
 };
 
 class VertexBufferLayout
@@ -67,3 +88,40 @@ inline void VertexBufferLayout::push<unsigned char>(unsigned count, const unsign
     elements_.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE, divisor });
     stride_ += count * VertexBufferLayoutElement::get_type_size(GL_UNSIGNED_BYTE);
 }
+
+template <>
+inline void VertexBufferLayout::push<short>(unsigned count, const unsigned int divisor)
+{
+    // 归一化到 [-1, 1]
+    elements_.push_back({ GL_SHORT, count, GL_TRUE, divisor });
+    stride_ += count * VertexBufferLayoutElement::get_type_size(GL_SHORT);
+}
+
+template <>
+inline void VertexBufferLayout::push<unsigned short>(unsigned count, const unsigned int divisor)
+{
+    // 归一化到 [0, 1]
+    elements_.push_back({ GL_UNSIGNED_SHORT, count, GL_TRUE, divisor });
+    stride_ += count * VertexBufferLayoutElement::get_type_size(GL_UNSIGNED_SHORT);
+}
+
+template <>
+inline void VertexBufferLayout::push<HalfFloat>(unsigned count, const unsigned int divisor)
+{
+    elements_.push_back({ GL_HALF_FLOAT, count, GL_FALSE, divisor });
+    stride_ += count * VertexBufferLayoutElement::get_type_size(GL_HALF_FLOAT);
+}
+
+template <>
+inline void VertexBufferLayout::push<PackedInt2101010>(unsigned count, const unsigned int divisor)
+{
+    // count 为着色器读取的分量数（3 或 4），存储始终占 4 字节
+    if (count != 3 && count != 4)
+    {
+        std::cout << "[ERROR] VertexBufferLayout: GL_INT_2_10_10_10_REV needs 3 or 4 components, got " << count << std::endl;
+        return;
+    }
+
+    elements_.push_back({ GL_INT_2_10_10_10_REV, count, GL_TRUE, divisor });
+    stride_ += VertexBufferLayoutElement::get_type_size(GL_INT_2_10_10_10_REV);
+}
@@ -1,4 +1,6 @@
 #include "Window.h"
+#include "GLState.h"
+#include "UploadQueue.h"
 
 Window::Window(const unsigned int& width,
                const unsigned int& height,
@@ -14,7 +16,8 @@ Window::Window(const unsigned int& width,
       window_(nullptr), 
       update_func_(nullptr), fixed_update_func_(nullptr), render_func_(nullptr),
       cursor_mode_(CursorMode::disabled),
-      cull_face_(cull_face), v_sync_(v_sync), msaa_(msaa), debug_info_(debug_info)
+      cull_face_(cull_face), v_sync_(v_sync), msaa_(msaa), debug_info_(debug_info),
+      upload_budget_ms_(2.0f)
 {
     init();
 }
@@ -28,6 +31,8 @@ bool Window::show(const bool& auto_clear) const
 {
     const auto result = !glfwWindowShouldClose(window_);
 
+    process_uploads();
+
     if (auto_clear && result)
     {
         GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
@@ -61,6 +66,12 @@ void Window::end_of_frame() const
     GLCall(glfwPollEvents());
 }
 
+void Window::process_uploads() const
+{
+    // 执行后台加载提交的 OpenGL 上传任务，超出预算的留到下一帧
+    UploadQueue::get_instance().pump(upload_budget_ms_);
+}
+
 void Window::set_cursor_mode(const CursorMode mode)
 {
     cursor_mode_ = mode;
@@ -133,19 +144,19 @@ bool Window::init()
 #endif
 
     // 开启深度缓冲测试
-    GLCall(glEnable(GL_DEPTH_TEST));
+    GLState::set_enabled(GL_DEPTH_TEST, true);
     // 开启模板缓冲测试
-    GLCall(glEnable(GL_STENCIL_TEST));
+    GLState::set_enabled(GL_STENCIL_TEST, true);
 
     // 开启 ALPHA 混合
-    GLCall(glEnable(GL_BLEND));
-    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    GLState::set_enabled(GL_BLEND, true);
+    GLState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // 设置背面剔除
     set_cull_face(cull_face_);
 
     if (msaa_ > 0)
-        GLCall(glEnable(GL_MULTISAMPLE));
+        GLState::set_enabled(GL_MULTISAMPLE, true);
     
     // 设置指针模式
     set_cursor_mode(cursor_mode_);
@@ -190,6 +201,8 @@ void Window::main_loop()
             lag -= fixed_delta_time_;
         }
 
+        process_uploads();
+
         // clear screen
         clear();
 
@@ -16,6 +16,7 @@
 #endif
 
 #include "Common.h"
+#include "GLState.h"
 #include "Model.h"
 #include "Mesh.h"
 #include "Shader.h"
@@ -58,6 +59,8 @@ private:
 
     bool debug_info_;               // 是否显示 debug 信息
 
+    float upload_budget_ms_;        // 每帧处理上传队列的时间预算（毫秒）
+
 public:
     Window(const unsigned int& width,
            const unsigned int& height,
@@ -77,6 +80,7 @@ public:
 
     void clear() const;
     void end_of_frame() const;
+    void process_uploads() const;
 
     // --- draw --- //
     void draw(const VertexArray& va, const Shader& shader) const;
@@ -109,14 +113,7 @@ public:
     inline void set_cull_face(const bool cull_face)
     {
         cull_face_ = cull_face;
-        if (cull_face_)
-        {
-            GLCall(glEnable(GL_CULL_FACE));
-        }
-        else
-        {
-            GLCall(glDisable(GL_CULL_FACE));
-        }
+        GLState::set_enabled(GL_CULL_FACE, cull_face_);
     }
 
     inline bool get_v_sync() const { return v_sync_; }
@@ -126,6 +123,9 @@ public:
         glfwSwapInterval(v_sync_ ? 1 : 0);
     }
 
+    inline float get_upload_budget() const { return upload_budget_ms_; }
+    inline void set_upload_budget(const float budget_ms) { upload_budget_ms_ = budget_ms; }
+
     inline bool get_debug_info() const { return debug_info_; }
     inline void set_debug_info(const bool debug_info) { debug_info_ = debug_info; }
 
@@ -4,13 +4,16 @@
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec4 color;
 
-uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Proj;
+#include "res/shaders/instance.glsl"
+
+#include "res/shaders/frame.glsl"
+
+out vec4 o_Color;
 
 void main()
 {
-    gl_Position = u_Proj * u_View * u_Model * position;
+    gl_Position = u_Proj * u_View * MODEL_MATRIX * position;
+    o_Color = INSTANCE_COLOR;
 }
 
 #shader fragment
@@ -18,7 +21,9 @@ void main()
 
 layout(location = 0) out vec4 color;
 
+in vec4 o_Color;
+
 void main()
 {
-    color = vec4(1.0, 1.0, 1.0, 1.0);
+    color = o_Color;
 }
@@ -143,7 +143,19 @@ int main()
         {   0.0f, 450.0f, 450.0f },
         { 450.0f, 450.0f, 450.0f }
     };
-    glm::mat4 obj_model = glm::mat4(1.0f);
+
+    // 物体与光源位置不变，逐实例数据只上传一次
+    std::vector<InstanceData> obj_instances(obj_count);
+    for (auto i = 0; i < obj_count; i++)
+    {
+        auto obj_model = glm::translate(glm::mat4(1.0f), obj_pos[i]);
+
+        const auto angle = 20.0f * i;
+        obj_model = glm::rotate(obj_model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        obj_model = glm::scale(obj_model, glm::vec3(0.3f));
+        obj_instances[i] = { obj_model, glm::vec4(1.0f) };
+    }
+    InstanceBuffer obj_instance_buffer(obj_instances.data(), obj_count);
 
     VertexArray light_va;
     light_va.add_buffer(vertex_buffer, vertex_buffer_layout, index_buffer);
@@ -154,65 +166,69 @@ int main()
         { -520.0f,  550.0f,  650.0f },
         {  620.0f, -450.0f, -500.0f },
     };
-    glm::mat4 light_model = glm::mat4(1.0f);
-
-    Shader obj_shader("src/test/test10/test10_obj.shader");
-    // set mvp
-    obj_shader.set_mat4f("u_Proj", proj);
-    obj_shader.set_mat4f("u_View", camera.get_view_matrix());
 
-    // set view pos
-    obj_shader.set_vec3f("u_ViewPos", camera.get_position());
+    std::vector<InstanceData> light_instances(light_count);
+    for (auto i = 0; i < light_count; i++)
+    {
+        auto light_model = glm::translate(glm::mat4(1.0f), light_pos[i]);
+        light_model = glm::scale(light_model, glm::vec3(0.15f));
+        light_instances[i] = { light_model, glm::vec4(1.0f) };
+    }
+    InstanceBuffer light_instance_buffer(light_instances.data(), light_count);
 
-    // set obj material
-    obj_shader.set_int  ("u_Material.diffuse",   0);
-    obj_shader.set_int  ("u_Material.specular",  1);
-    obj_shader.set_float("u_Material.shininess", 32.0f);
+    const auto obj_shader = ShaderLibrary::get("src/test/test10/test10_obj.shader",
+                                               { "INSTANCED", "NR_POINT_LIGHTS " + std::to_string(light_count) });
+    // set obj material，采样器仍是普通 uniform，反光度在材质块中
+    obj_shader->set_int("u_Material.diffuse",  0);
+    obj_shader->set_int("u_Material.specular", 1);
+    MaterialUniforms material = {};
+    material.shininess = 32.0f;
+    UniformBlocks::set_material(material);
 
     auto ambient  = glm::vec3(0.1f);
     auto diffuse  = glm::vec3(0.6f);
     auto specular = glm::vec3(1.0f);
 
+    LightingUniforms lighting = {};
 
     // set dir light
-    obj_shader.set_vec3f("u_DirLight.direction", -320.0f, -1500.0f, -400.0f);
-    obj_shader.set_vec3f("u_DirLight.ambient",  ambient);
-    obj_shader.set_vec3f("u_DirLight.diffuse",  diffuse);
-    obj_shader.set_vec3f("u_DirLight.specular", specular);
+    lighting.dir_light.direction = glm::vec3(-320.0f, -1500.0f, -400.0f);
+    lighting.dir_light.ambient   = ambient;
+    lighting.dir_light.diffuse   = diffuse;
+    lighting.dir_light.specular  = specular;
 
     // set point light
-    std::ostringstream string_stream;
     for (auto i = 0; i < light_count; i++)
     {
-        string_stream.str("");
-        string_stream.clear();
-        string_stream << "u_PointLights[" << i << "].";
-        // set point lights
-        obj_shader.set_vec3f(string_stream.str() + "position",  light_pos[0]);
-        obj_shader.set_vec3f(string_stream.str() + "ambient",   ambient);
-        obj_shader.set_vec3f(string_stream.str() + "diffuse",   diffuse);
-        obj_shader.set_vec3f(string_stream.str() + "specular",  specular);
+        auto& point_light = lighting.point_lights[i];
+        point_light.position  = light_pos[0];
+        point_light.ambient   = ambient;
+        point_light.diffuse   = diffuse;
+        point_light.specular  = specular;
         // 参考 http://www.ogre3d.org/tikiwiki/tiki-index.php?page=-Point+Light+Attenuation
-        obj_shader.set_float(string_stream.str() + "constant",  1.0f);
-        obj_shader.set_float(string_stream.str() + "linear",    0.07f);
-        obj_shader.set_float(string_stream.str() + "quadratic", 0.017f);
+        point_light.constant  = 1.0f;
+        point_light.linear    = 0.07f;
+        point_light.quadratic = 0.017f;
     }
 
-    // set spot light
-    obj_shader.set_vec3f("u_SpotLight.position",      camera.get_position());
-    obj_shader.set_vec3f("u_SpotLight.direction",     camera.get_direction());
-    obj_shader.set_vec3f("u_SpotLight.ambient",       ambient);
-    obj_shader.set_vec3f("u_SpotLight.diffuse",       diffuse);
-    obj_shader.set_vec3f("u_SpotLight.specular",      specular);
-    obj_shader.set_float("u_SpotLight.cut_off",       glm::cos(glm::radians(12.5f)));
-    obj_shader.set_float("u_SpotLight.outer_cut_off", glm::cos(glm::radians(17.5f)));
+    // set spot light，位置与方向跟随相机，逐帧更新
+    lighting.spot_light.ambient       = ambient;
+    lighting.spot_light.diffuse       = diffuse;
+    lighting.spot_light.specular      = specular;
+    lighting.spot_light.cut_off       = glm::cos(glm::radians(12.5f));
+    lighting.spot_light.outer_cut_off = glm::cos(glm::radians(17.5f));
+
+    lighting.distance_rate = 100.0f;
 
-    obj_shader.set_float("u_DistanceRate", 100.0f);
+    auto texture0 = TextureCache::get("res/textures/container.png");
+    auto texture1 = TextureCache::get("res/textures/container_specular.png");
 
-    Texture texture0("res/textures/container.png");
-    Texture texture1("res/textures/container_specular.png");
+    Shader light_shader("src/test/test10/test10_light.shader", { "INSTANCED" });
 
-    Shader light_shader("src/test/test10/test10_light.shader");
+    const auto& cache_stats = ProgramCache::get_stats();
+    std::cout << std::fixed << std::setprecision(2)
+              << "program cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses, "
+              << cache_stats.rejected << " rejected, saved " << cache_stats.saved_ms << " ms" << std::endl;
 
     Renderer renderer;
     renderer.set_clear_color(glm::vec4(0.1f));
@@ -227,42 +243,23 @@ int main()
 
         process_input(window.get_window());
 
-        texture0.bind();
-        texture1.bind(1);
-
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
 
-        // renderer object
-        for (auto i = 0; i < obj_count; i++)
-        {
-            obj_model = glm::translate(glm::mat4(1.0f), obj_pos[i]);
-
-            const auto angle = 20.0f * i;
-            obj_model = glm::rotate(obj_model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            obj_model = glm::scale(obj_model, glm::vec3(0.3f));
-
-            obj_shader.set_mat4f("u_Proj", proj);
-            obj_shader.set_mat4f("u_View", view);
-            obj_shader.set_mat4f("u_Model", obj_model);
-            obj_shader.set_vec3f("u_ViewPos", camera.get_position());
+        // 逐帧数据每帧各上传一次，两个着色器共享同一个块
+        UniformBlocks::set_frame({ proj, view, camera.get_position(), current_frame });
 
-            obj_shader.set_vec3f("u_SpotLight.position",  camera.get_position());
-            obj_shader.set_vec3f("u_SpotLight.direction", camera.get_direction());
+        lighting.spot_light.position  = camera.get_position();
+        lighting.spot_light.direction = camera.get_direction();
+        UniformBlocks::set_lighting(lighting);
 
-            renderer.draw(obj_va, obj_shader);
-        }
+        // renderer object，全部物体一次绘制
+        texture0->bind(0);
+        texture1->bind(1);
+        renderer.draw_instanced(obj_va, *obj_shader, obj_instance_buffer, obj_count);
 
         // renderer light
-        for (auto i = 0; i < light_count; i++)
-        {
-            light_model = glm::translate(glm::mat4(1.0f), light_pos[i]);
-            light_model = glm::scale(light_model, glm::vec3(0.15f));
-            light_shader.set_mat4f("u_Proj", proj);
-            light_shader.set_mat4f("u_View", view);
-            light_shader.set_mat4f("u_Model", light_model);
-            renderer.draw(light_va, light_shader);
-        }
+        renderer.draw_instanced(light_va, light_shader, light_instance_buffer, light_count);
 
         window.end_of_frame();
     }
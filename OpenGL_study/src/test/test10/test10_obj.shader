@@ -9,92 +9,37 @@ out vec3 o_Normal;
 out vec3 o_FragPos;
 out vec2 o_TextureCoords;
 
-uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Proj;
+#include "res/shaders/instance.glsl"
+#include "res/shaders/frame.glsl"
 
 void main()
 {
-    gl_Position = u_Proj * u_View * u_Model * position;
-    o_Normal = mat3(transpose(inverse(u_Model))) * normal.xyz;
-    o_FragPos = vec3(u_Model * position);
+    gl_Position = u_Proj * u_View * MODEL_MATRIX * position;
+    o_Normal = mat3(transpose(inverse(MODEL_MATRIX))) * normal.xyz;
+    o_FragPos = vec3(MODEL_MATRIX * position);
     o_TextureCoords = texture_coords;
 }
 
 #shader fragment
 #version 330 core
 
-/**
- * 材质结构体
- */
-struct Material {
-    sampler2D   diffuse;    // 环境光
-    sampler2D   specular;   // 漫反射光
-    float       shininess;  // 镜面光
-};
-
-/**
- * 方向光结构体
- */
-struct DirLight {
-    vec3    direction;
-
-    // --- 基本参数 --- //
-    vec3    ambient;    // 环境光
-    vec3    diffuse;    // 漫反射光
-    vec3    specular;   // 镜面光
-};
-
-/**
- * 点光源结构体
- */
-struct PointLight {
-    vec3    position;
-
-    // --- 基本参数 --- //
-    vec3    ambient;    // 环境光
-    vec3    diffuse;    // 漫反射光
-    vec3    specular;   // 镜面光
-
-    // --- 点光源参数 --- 参考 https://learnopengl-cn.github.io/02%20Lighting/05%20Light%20casters/ //
-    float   constant;   // 常量
-    float   linear;     // 一次项
-    float   quadratic;  // 二次项
-};
-
-/**
- * 聚光结构体
- */
-struct SpotLight {
-    vec3    position;
-    vec3    direction;
-
-    // --- 基本参数 --- //
-    vec3    ambient;    // 环境光
-    vec3    diffuse;    // 漫反射光
-    vec3    specular;   // 镜面光
-
-    // --- 聚光灯参数 --- //
-    float   cut_off;
-    float   outer_cut_off;
-};
-
+#include "res/shaders/frame.glsl"
+#include "res/shaders/lighting.glsl"
+#include "res/shaders/material.glsl"
+#include "res/shaders/material_block.glsl"
 
+// 点光源数量可由 ShaderLibrary 以宏注入
+#ifndef NR_POINT_LIGHTS
 #define NR_POINT_LIGHTS 4
+#endif
 
 layout(location = 0) out vec4 color;
 
 
 // --- uniform ---//
-uniform vec3 u_ViewPos;
+// 光源、观察位置与反光度来自 uniform 块，这里只剩采样器
 uniform Material u_Material;
 
-uniform DirLight u_DirLight;
-uniform PointLight u_PointLights[NR_POINT_LIGHTS];
-uniform SpotLight u_SpotLight;
-
-uniform float u_DistanceRate;
-
 
 // --- in parameters ---//
 in vec3 o_Normal;
@@ -144,7 +89,7 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 view_dir)
 
     // specular
     vec3 reflect_dir = reflect(-light_dir, normal);
-    float spec       = pow(max(dot(view_dir, reflect_dir), 0.0), u_Material.shininess);
+    float spec       = pow(max(dot(view_dir, reflect_dir), 0.0), u_Shininess);
     vec3 specular    = light.specular * (spec * vec3(texture(u_Material.specular, o_TextureCoords)));
 
     return (ambient + diffuse + specular);
@@ -171,7 +116,7 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 view_dir)
 
     // specular
     vec3 reflect_dir = reflect(-light_dir, normal);
-    float spec       = pow(max(dot(view_dir, reflect_dir), 0.0), u_Material.shininess);
+    float spec       = pow(max(dot(view_dir, reflect_dir), 0.0), u_Shininess);
     vec3 specular    = light.specular * (spec * vec3(texture(u_Material.specular, o_TextureCoords)));
 
     return (ambient + diffuse + specular) * attenuation;
@@ -194,7 +139,7 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 view_dir)
 
     // specular
     vec3 reflect_dir = reflect(-light_dir, normal);
-    float spec       = pow(max(dot(view_dir, reflect_dir), 0.0), u_Material.shininess);
+    float spec       = pow(max(dot(view_dir, reflect_dir), 0.0), u_Shininess);
     vec3 specular    = light.specular * (spec * vec3(texture(u_Material.specular, o_TextureCoords)));
 
     float theta     = dot(light_dir, normalize(-light.direction));
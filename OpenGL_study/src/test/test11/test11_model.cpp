@@ -129,7 +129,8 @@ int main()
     obj_shader.set_mat4f("u_Proj", proj_mat);
     obj_shader.set_mat4f("u_View", view_mat);
 
-    Model model("res/model/nanosuit.obj");
+    // 后台加载并优化网格，纹理就绪前以占位纹理绘制
+    Model model("res/model/nanosuit.obj", false, MODEL_LOAD_ASYNC | MODEL_LOAD_OPTIMIZE);
 
     Renderer renderer;
     renderer.set_clear_color(glm::vec4(0.5f));
@@ -6,14 +6,15 @@ layout (location = 2) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
-uniform mat4 u_Model;
+#include "res/shaders/instance.glsl"
+
 uniform mat4 u_View;
 uniform mat4 u_Proj;
 
 void main()
 {
     TexCoords = aTexCoords;    
-    gl_Position = u_Proj * u_View * u_Model * vec4(aPos, 1.0);
+    gl_Position = u_Proj * u_View * MODEL_MATRIX * vec4(aPos, 1.0);
 }
 
 #shader fragment
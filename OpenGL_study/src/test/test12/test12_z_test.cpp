@@ -158,8 +158,8 @@ int main()
     obj_shader.set_mat4f("u_Proj", proj);
     obj_shader.set_mat4f("u_View", camera.get_view_matrix());
 
-    Texture texture0("res/textures/container.png");
-    Texture texture1("res/textures/container_specular.png");
+    auto texture0 = TextureCache::get("res/textures/container.png");
+    auto texture1 = TextureCache::get("res/textures/container_specular.png");
 
     Shader light_shader("src/test/test12/test12_light.shader");
 
@@ -173,8 +173,8 @@ int main()
 
     window.set_render_func([&] ()
     {
-        texture0.bind();
-        texture1.bind(1);
+        texture0->bind();
+        texture1->bind(1);
     
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
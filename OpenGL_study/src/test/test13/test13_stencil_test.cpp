@@ -141,7 +141,7 @@ int main()
 
     Shader boarder_shader("src/test/test13/test13_boarder.shader");
 
-    Texture texture0("res/textures/container.png");
+    auto texture0 = TextureCache::get("res/textures/container.png");
 
     Renderer renderer;
     renderer.set_clear_color(glm::vec4(0.1f));
@@ -151,17 +151,39 @@ int main()
         process_input(window.get_window(), delta_time);
     });
 
-    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    // 物体写入模板值 1，边框只在模板值不为 1 处绘制且不做深度测试
+    PipelineStateDesc obj_desc;
+    obj_desc.shader = &obj_shader;
+    obj_desc.stencil.func = GL_ALWAYS;
+    obj_desc.stencil.ref = 1;
+    obj_desc.stencil.depth_pass = GL_REPLACE;
+    obj_desc.raster.cull_enabled = true;
+    const PipelineState obj_state(obj_desc);
+
+    PipelineStateDesc boarder_desc = obj_desc;
+    boarder_desc.shader = &boarder_shader;
+    boarder_desc.depth.test_enabled = false;
+    boarder_desc.stencil.func = GL_NOTEQUAL;
+    boarder_desc.stencil.write_mask = 0x00;
+    const PipelineState boarder_state(boarder_desc);
+
+    // 帧末恢复模板写掩码，否则下一帧无法清除模板缓冲
+    PipelineStateDesc default_desc;
+    default_desc.raster.cull_enabled = true;
+    const PipelineState default_state(default_desc);
+
+    unsigned int frame = 0;
 
     window.set_render_func([&] ()
     {
-        texture0.bind();
+        GLState::reset_stats();
+
+        texture0->bind();
     
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
 
-        glStencilFunc(GL_ALWAYS, 1, 0xff);
-        glStencilMask(0xff);
+        obj_state.bind();
 
         for (auto i = 0; i < obj_count; i++)
         {
@@ -173,9 +195,7 @@ int main()
             renderer.draw(obj_va, obj_shader);
         }
 
-        glStencilFunc(GL_NOTEQUAL, 1, 0xff);
-        glStencilMask(0x00);
-        glDisable(GL_DEPTH_TEST);
+        boarder_state.bind();
 
         for (auto i = 0; i < obj_count; i++)
         {
@@ -188,8 +208,14 @@ int main()
             renderer.draw(obj_va, boarder_shader);
         }
 
-        glStencilMask(0xff);
-        glEnable(GL_DEPTH_TEST);
+        default_state.bind();
+
+        if (++frame % 300 == 0)
+        {
+            const auto& stats = GLState::get_stats();
+            std::cout << "GL state calls: " << stats.requested << " requested, "
+                      << stats.issued << " issued" << std::endl;
+        }
     });
 
     window.set_cull_face(true);
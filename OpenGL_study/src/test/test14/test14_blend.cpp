@@ -134,8 +134,8 @@ int main()
 
     Shader obj_shader("src/test/test14/test14_obj.shader");
 
-    Texture texture0("res/textures/grass.png");
-    Texture texture1("res/textures/blending_transparent_window.png");
+    auto texture0 = TextureCache::get("res/textures/grass.png");
+    auto texture1 = TextureCache::get("res/textures/blending_transparent_window.png");
 
     Renderer renderer;
     renderer.set_clear_color(glm::vec4(0.1f));
@@ -145,8 +145,8 @@ int main()
         process_input(window.get_window(), delta_time);
     });
 
-    texture0.bind();
-    texture1.bind(1);
+    texture0->bind();
+    texture1->bind(1);
 
     window.set_render_func([&]()
     {
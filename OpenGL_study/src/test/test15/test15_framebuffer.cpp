@@ -144,7 +144,7 @@ int main()
     Shader cube_shader("src/test/test15/test15_cube.shader");
     Shader rect_shader("src/test/test15/test15_rect.shader");
 
-    Texture texture0("res/textures/container.png");
+    auto texture0 = TextureCache::get("res/textures/container.png");
     
     FrameBuffer framebuffer;
     framebuffer.add_texture_attachment(FB_ATTACHMENT_TYPE::Color,
@@ -162,7 +162,7 @@ int main()
         process_input(window.get_window(), delta_time);
     });
 
-    texture0.bind();
+    texture0->bind();
 
     window.set_render_func([&]()
     {
@@ -178,10 +178,10 @@ int main()
 
         // 将内容渲染到自己创建的FrameBuffer
         framebuffer.bind();
-        texture0.bind();
+        texture0->bind();
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_DEPTH_TEST);
+        GLState::set_enabled(GL_DEPTH_TEST, true);
         
         cube_shader.set_int("u_Texture", 0);
         cube_shader.set_mat4f("u_Proj", proj);
@@ -194,7 +194,7 @@ int main()
         framebuffer.bind_texture(FB_ATTACHMENT_TYPE::Color);
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        glDisable(GL_DEPTH_TEST);
+        GLState::set_enabled(GL_DEPTH_TEST, false);
         rect_shader.set_int("u_Texture", 0);
         rect_shader.set_mat4f("u_Proj", proj);
         rect_shader.set_mat4f("u_View", view);
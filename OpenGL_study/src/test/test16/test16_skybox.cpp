@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include "Header.h"
@@ -142,7 +143,11 @@ int main()
         "res/textures/skybox/back.jpg",
         "res/textures/skybox/front.jpg",
     };
-    CubeTexture cube_texture(sky_face_paths);
+    const auto load_start = std::chrono::high_resolution_clock::now();
+    auto cube_texture = TextureCache::get_cube(sky_face_paths);
+    std::cout << "skybox loaded in " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - load_start).count()
+              << " ms" << std::endl;
     
     Renderer renderer;
 
@@ -156,7 +161,7 @@ int main()
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
 
-        cube_texture.bind();
+        cube_texture->bind();
 
         cube_model = glm::translate(glm::mat4(1.0f), cube_pos);
         cube_model = glm::rotate(cube_model, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
@@ -167,7 +172,7 @@ int main()
         cube_shader.set_mat4f("u_Model", cube_model);
         renderer.draw(cube_va, cube_shader);
 
-        GLCall(glDepthFunc(GL_LEQUAL));
+        GLState::depth_func(GL_LEQUAL);
         cube_model = glm::scale(glm::mat4(1.0f), glm::vec3(15, 15, 15));
         skybox_shader.set_int("u_Texture", 0);
         skybox_shader.set_mat4f("u_Proj", proj);
@@ -175,7 +180,7 @@ int main()
         skybox_shader.set_mat4f("u_Model", cube_model);
         renderer.draw(cube_va, skybox_shader);
 
-        GLCall(glDepthFunc(GL_LESS));
+        GLState::depth_func(GL_LESS);
     });
 
     window.set_debug_info(true);
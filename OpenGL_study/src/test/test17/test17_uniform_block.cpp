@@ -145,10 +145,11 @@ int main()
         "res/textures/skybox/back.jpg",
         "res/textures/skybox/front.jpg",
     };
-    CubeTexture cube_texture(sky_face_paths);
+    auto cube_texture = TextureCache::get_cube(sky_face_paths);
 
-    UniformBuffer uniform_buffer(2 * sizeof(glm::mat4), 0);
-    uniform_buffer.put_data(sizeof(glm::mat4), glm::value_ptr(proj));
+    // 每帧的矩阵写入环形缓冲的新区间，不与 GPU 正在读取的上一帧数据同步
+    StreamBuffer frame_stream(64 * 1024);
+    std::cout << "stream buffer: " << (frame_stream.is_persistent() ? "persistent mapped" : "orphaning") << std::endl;
 
     Renderer renderer;
 
@@ -161,9 +162,12 @@ int main()
     {
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
-        uniform_buffer.put_data(sizeof(glm::mat4), glm::value_ptr(view), sizeof(glm::mat4));
+        const glm::mat4 matrices[] = { proj, view };
+        const auto matrices_range = frame_stream.write(matrices, sizeof(matrices), StreamBuffer::get_uniform_alignment());
+        if (matrices_range.is_valid())
+            frame_stream.bind_range(GL_UNIFORM_BUFFER, 0, matrices_range);
 
-        cube_texture.bind();
+        cube_texture->bind();
 
         cube_model = glm::translate(glm::mat4(1.0f), cube_pos);
         cube_model = glm::rotate(cube_model, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
@@ -172,13 +176,15 @@ int main()
         cube_shader.set_mat4f("u_Model", cube_model);
         renderer.draw(cube_va, cube_shader);
 
-        GLCall(glDepthFunc(GL_LEQUAL));
+        GLState::depth_func(GL_LEQUAL);
         cube_model = glm::scale(glm::mat4(1.0f), glm::vec3(15, 15, 15));
         skybox_shader.set_int("u_Texture", 0);
         skybox_shader.set_mat4f("u_Model", cube_model);
         renderer.draw(cube_va, skybox_shader);
 
-        GLCall(glDepthFunc(GL_LESS));
+        GLState::depth_func(GL_LESS);
+
+        frame_stream.end_frame();
     });
 
     window.set_debug_info(true);
@@ -134,36 +134,35 @@ int main()
     auto light_model = glm::translate(glm::mat4(1.0f), light_pos);
     light_model = glm::scale(light_model, glm::vec3(0.2f));
 
-    Texture texture0("res/textures/container.png");
-    Texture texture1("res/textures/container_specular.png");
+    auto texture0 = TextureCache::get("res/textures/container.png");
+    auto texture1 = TextureCache::get("res/textures/container_specular.png");
 
-    Shader obj_shader("src/test/test20/test20_obj.shader");
+    const auto obj_shader = ShaderLibrary::get("src/test/test20/test20_obj.shader", { "LIGHT_TYPE LIGHT_DIRECTIONAL" });
     // set mvp
-    obj_shader.set_mat4f("u_Proj", proj);
-    obj_shader.set_mat4f("u_View", camera.get_view_matrix());
-    //    obj_shader.set_mat4f("u_Model", obj_model);
+    obj_shader->set_mat4f("u_Proj", proj);
+    obj_shader->set_mat4f("u_View", camera.get_view_matrix());
+    //    obj_shader->set_mat4f("u_Model", obj_model);
 
     // set light & view
-    obj_shader.set_vec3f("u_ViewPos", camera.get_position());
+    obj_shader->set_vec3f("u_ViewPos", camera.get_position());
 
-    obj_shader.set_int("u_Light.type", 0);
 
-    obj_shader.set_vec3f("u_Light.ambient", glm::vec3(0.3f));
-    obj_shader.set_vec3f("u_Light.diffuse", glm::vec3(0.8f));
-    obj_shader.set_vec3f("u_Light.specular", glm::vec3(1.0f));
+    obj_shader->set_vec3f("u_Light.ambient", glm::vec3(0.3f));
+    obj_shader->set_vec3f("u_Light.diffuse", glm::vec3(0.8f));
+    obj_shader->set_vec3f("u_Light.specular", glm::vec3(1.0f));
 
     // // 参考 http://www.ogre3d.org/tikiwiki/tiki-index.php?page=-Point+Light+Attenuation
-    // obj_shader.set_float("u_Light.constant", 1.0f);
-    // obj_shader.set_float("u_Light.linear", 0.045f);
-    // obj_shader.set_float("u_Light.quadratic", 0.0075f);
+    // obj_shader->set_float("u_Light.constant", 1.0f);
+    // obj_shader->set_float("u_Light.linear", 0.045f);
+    // obj_shader->set_float("u_Light.quadratic", 0.0075f);
 
-    obj_shader.set_vec3f("u_Light.direction", -320.0f, -1500.0f, -400.0f);
-    obj_shader.set_float("u_DistanceRate", 100.0f);
+    obj_shader->set_vec3f("u_Light.direction", -320.0f, -1500.0f, -400.0f);
+    obj_shader->set_float("u_DistanceRate", 100.0f);
 
     // set obj material
-    obj_shader.set_int("u_Material.diffuse", 0);
-    obj_shader.set_int("u_Material.specular", 1);
-    obj_shader.set_float("u_Material.shininess", 32.0f);
+    obj_shader->set_int("u_Material.diffuse", 0);
+    obj_shader->set_int("u_Material.specular", 1);
+    obj_shader->set_float("u_Material.shininess", 32.0f);
 
     Shader light_shader("src/test/test20/test20_light.shader");
 
@@ -172,6 +171,7 @@ int main()
 
     auto current_frame = 0.0f;
 
+    auto frame = 0;
     while (window.show())
     {
         current_frame = glfwGetTime();
@@ -180,8 +180,8 @@ int main()
 
         process_input(window.get_window());
 
-        texture0.bind();
-        texture1.bind(1);
+        texture0->bind();
+        texture1->bind(1);
 
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
@@ -195,16 +195,25 @@ int main()
             obj_model = glm::rotate(obj_model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
             obj_model = glm::scale(obj_model, glm::vec3(0.3f));
 
-            obj_shader.set_mat4f("u_Proj", proj);
-            obj_shader.set_mat4f("u_View", camera.get_view_matrix());
-            obj_shader.set_mat4f("u_Model", obj_model);
-            obj_shader.set_vec3f("u_ViewPos", camera.get_position());
-            renderer.draw(obj_va, obj_shader);
+            obj_shader->set_mat4f("u_Proj", proj);
+            obj_shader->set_mat4f("u_View", camera.get_view_matrix());
+            obj_shader->set_mat4f("u_Model", obj_model);
+            obj_shader->set_vec3f("u_ViewPos", camera.get_position());
+            renderer.draw(obj_va, *obj_shader);
         }
 
 //        light_shader.set_mat4f("u_MVP", proj * view * light_model);
 //        renderer.draw(light_va, light_shader);
 
+        // 逐物体重复设置的投影、观察矩阵与观察位置只在变化时提交
+        if (++frame % 300 == 0)
+        {
+            const auto& stats = Shader::get_uniform_stats();
+            std::cout << "uniform updates: " << stats.issued << " issued, "
+                      << stats.elided << " elided" << std::endl;
+            Shader::reset_uniform_stats();
+        }
+
         window.end_of_frame();
     }
     return 0;
@@ -24,19 +24,18 @@ void main()
 #shader fragment
 #version 330 core
 
-struct Material {
-    sampler2D   diffuse;
-    sampler2D   specular;
-    float       shininess;
-};
+#include "res/shaders/material.glsl"
 
-struct Light {
-    // 类型
-    // 0 平行光
-    // 1 点光源
-    // 2 聚光灯
-    int     type;      
+// 光源类型在编译期选定，每种类型一个变体，片元着色器内没有动态分支
+#define LIGHT_DIRECTIONAL 0
+#define LIGHT_POINT       1
+#define LIGHT_SPOT        2
+
+#ifndef LIGHT_TYPE
+#define LIGHT_TYPE LIGHT_DIRECTIONAL
+#endif
 
+struct Light {
     vec3    direction;
     vec3    position;
 
@@ -73,22 +72,17 @@ void main()
     vec3 light_dir;
     float attenuation = 1.0;
 
-    // w 分量为0，表示方向向量，w 分量为1，表示位置向量
-    if (u_Light.type == 0)
-    {
-        light_dir = normalize(-u_Light.direction);
-    }
-    else
-    {
-        light_dir = normalize(u_Light.position - o_FragPos);
-
-        if (u_Light.type == 1)
-        {
-            float distance = length(vec3(u_Light.direction) - o_FragPos) / u_DistanceRate;
-            attenuation = 1.0 /
-                (u_Light.constant + u_Light.linear * distance + u_Light.quadratic * (distance * distance));
-        }
-    }
+#if LIGHT_TYPE == LIGHT_DIRECTIONAL
+    light_dir = normalize(-u_Light.direction);
+#else
+    light_dir = normalize(u_Light.position - o_FragPos);
+#endif
+
+#if LIGHT_TYPE == LIGHT_POINT
+    float distance = length(vec3(u_Light.direction) - o_FragPos) / u_DistanceRate;
+    attenuation = 1.0 /
+        (u_Light.constant + u_Light.linear * distance + u_Light.quadratic * (distance * distance));
+#endif
 
     // ambient
     vec3 ambient = u_Light.ambient * vec3(texture(u_Material.diffuse, o_TextureCoords));
@@ -103,15 +97,14 @@ void main()
     float spec       = pow(max(dot(norm, halfway_dir), 0.0), u_Material.shininess);
     vec3 specular    = u_Light.specular * (spec * vec3(texture(u_Material.specular, o_TextureCoords)));
 
-    if (u_Light.type == 2)
-    {
-        float theta     = dot(light_dir, normalize(-u_Light.direction));
-        float epsilon   = u_Light.cut_off - u_Light.outer_cut_off;
-        float intensity = clamp((theta - u_Light.outer_cut_off) / epsilon, 0.0f, 1.0f);
+#if LIGHT_TYPE == LIGHT_SPOT
+    float theta     = dot(light_dir, normalize(-u_Light.direction));
+    float epsilon   = u_Light.cut_off - u_Light.outer_cut_off;
+    float intensity = clamp((theta - u_Light.outer_cut_off) / epsilon, 0.0f, 1.0f);
 
-        diffuse  *= intensity;
-        specular *= intensity;
-    }
+    diffuse  *= intensity;
+    specular *= intensity;
+#endif
 
     // result
     vec3 result = (ambient + diffuse + specular) * attenuation;
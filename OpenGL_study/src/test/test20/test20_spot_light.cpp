@@ -134,34 +134,33 @@ int main()
     auto light_model = glm::translate(glm::mat4(1.0f), light_pos);
     light_model = glm::scale(light_model, glm::vec3(0.2f));
 
-    Texture texture0("res/textures/container.png");
-    Texture texture1("res/textures/container_specular.png");
+    auto texture0 = TextureCache::get("res/textures/container.png");
+    auto texture1 = TextureCache::get("res/textures/container_specular.png");
 
-    Shader obj_shader("src/test/test20/test20_obj.shader");
+    const auto obj_shader = ShaderLibrary::get("src/test/test20/test20_obj.shader", { "LIGHT_TYPE LIGHT_SPOT" });
     // set mvp
-    obj_shader.set_mat4f("u_Proj", proj);
-    obj_shader.set_mat4f("u_View", camera.get_view_matrix());
-    //    obj_shader.set_mat4f("u_Model", obj_model);
+    obj_shader->set_mat4f("u_Proj", proj);
+    obj_shader->set_mat4f("u_View", camera.get_view_matrix());
+    //    obj_shader->set_mat4f("u_Model", obj_model);
 
     // set light & view
-    obj_shader.set_vec3f("u_ViewPos", camera.get_position());
+    obj_shader->set_vec3f("u_ViewPos", camera.get_position());
 
-    obj_shader.set_int("u_Light.type", 2);
-    obj_shader.set_vec3f("u_Light.ambient", glm::vec3(0.3f));
-    obj_shader.set_vec3f("u_Light.diffuse", glm::vec3(0.8f));
-    obj_shader.set_vec3f("u_Light.specular", glm::vec3(1.0f));
+    obj_shader->set_vec3f("u_Light.ambient", glm::vec3(0.3f));
+    obj_shader->set_vec3f("u_Light.diffuse", glm::vec3(0.8f));
+    obj_shader->set_vec3f("u_Light.specular", glm::vec3(1.0f));
 
-    obj_shader.set_float("u_Light.cut_off", glm::cos(glm::radians(12.5f)));
-    obj_shader.set_float("u_Light.outer_cut_off", glm::cos(glm::radians(17.5f)));
+    obj_shader->set_float("u_Light.cut_off", glm::cos(glm::radians(12.5f)));
+    obj_shader->set_float("u_Light.outer_cut_off", glm::cos(glm::radians(17.5f)));
 
-    obj_shader.set_vec3f("u_Light.position", camera.get_position());
-    obj_shader.set_vec3f("u_Light.direction", camera.get_direction());
-    obj_shader.set_float("u_DistanceRate", 100.0f);
+    obj_shader->set_vec3f("u_Light.position", camera.get_position());
+    obj_shader->set_vec3f("u_Light.direction", camera.get_direction());
+    obj_shader->set_float("u_DistanceRate", 100.0f);
 
     // set obj material
-    obj_shader.set_int("u_Material.diffuse", 0);
-    obj_shader.set_int("u_Material.specular", 1);
-    obj_shader.set_float("u_Material.shininess", 32.0f);
+    obj_shader->set_int("u_Material.diffuse", 0);
+    obj_shader->set_int("u_Material.specular", 1);
+    obj_shader->set_float("u_Material.shininess", 32.0f);
 
     Shader light_shader("src/test/test20/test20_light.shader");
 
@@ -178,8 +177,8 @@ int main()
 
         process_input(window.get_window());
 
-        texture0.bind();
-        texture1.bind(1);
+        texture0->bind();
+        texture1->bind(1);
 
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
@@ -193,14 +192,14 @@ int main()
             obj_model = glm::rotate(obj_model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
             obj_model = glm::scale(obj_model, glm::vec3(0.3f));
 
-            obj_shader.set_vec3f("u_Light.position", camera.get_position());
-            obj_shader.set_vec3f("u_Light.direction", camera.get_direction());
+            obj_shader->set_vec3f("u_Light.position", camera.get_position());
+            obj_shader->set_vec3f("u_Light.direction", camera.get_direction());
 
-            obj_shader.set_mat4f("u_Proj", proj);
-            obj_shader.set_mat4f("u_View", camera.get_view_matrix());
-            obj_shader.set_mat4f("u_Model", obj_model);
-            obj_shader.set_vec3f("u_ViewPos", camera.get_position());
-            renderer.draw(obj_va, obj_shader);
+            obj_shader->set_mat4f("u_Proj", proj);
+            obj_shader->set_mat4f("u_View", camera.get_view_matrix());
+            obj_shader->set_mat4f("u_Model", obj_model);
+            obj_shader->set_vec3f("u_ViewPos", camera.get_position());
+            renderer.draw(obj_va, *obj_shader);
         }
 
 //        light_shader.set_mat4f("u_MVP", proj * view * light_model);
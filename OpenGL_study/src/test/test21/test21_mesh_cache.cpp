@@ -0,0 +1,56 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include "Header.h"
+
+Window window(640, 640, "test21_mesh_cache");
+
+/**
+ * 加载一次模型，返回耗时（毫秒）
+ */
+double load_model_ms(const std::string& path)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    {
+        Model model(path);
+        GLCall(glFinish());
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/**
+ * 网格缓存：冷启动（Assimp 导入并写缓存） vs 热启动（映射缓存）
+ */
+int main()
+{
+    const std::string model_path = "res/model/nanosuit.obj";
+    const auto round_count = 5;
+
+    // 删除旧缓存，保证第一次为冷启动
+    std::remove((model_path + ".meshcache").c_str());
+
+    const auto cold_ms = load_model_ms(model_path);
+
+    auto warm_total_ms = 0.0;
+    auto warm_best_ms = cold_ms;
+    for (auto i = 0; i < round_count; i++)
+    {
+        const auto warm_ms = load_model_ms(model_path);
+        warm_total_ms += warm_ms;
+        warm_best_ms = warm_ms < warm_best_ms ? warm_ms : warm_best_ms;
+    }
+
+    std::cout << "--- Mesh Cache Benchmark ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Model: " << model_path << std::endl;
+    std::cout << "Cold load (Assimp + write cache): " << cold_ms << " ms" << std::endl;
+    std::cout << "Warm load (mapped cache), avg of " << round_count << ": "
+              << warm_total_ms / round_count << " ms" << std::endl;
+    std::cout << "Warm load best: " << warm_best_ms << " ms" << std::endl;
+    std::cout << "Speedup: " << cold_ms / (warm_total_ms / round_count) << "x" << std::endl;
+    std::cout << "----------------------------" << std::endl;
+
+    return 0;
+}
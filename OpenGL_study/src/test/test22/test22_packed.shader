@@ -0,0 +1,58 @@
+#shader vertex
+#version 330 core
+layout (location = 0) in vec4 aPos;         // snorm16，相对网格包围盒
+layout (location = 1) in vec2 aNormal;      // 八面体编码
+layout (location = 2) in vec2 aTexCoords;   // half float
+layout (location = 3) in vec4 aTangent;     // xyz 切线，w 副切线方向
+
+out vec2 TexCoords;
+out vec3 Normal;
+
+uniform mat4 u_Model;
+uniform mat4 u_View;
+uniform mat4 u_Proj;
+
+uniform vec3 u_PositionOffset;
+uniform vec3 u_PositionScale;
+
+vec3 decode_octahedral(vec2 e)
+{
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main()
+{
+    vec3 position = u_PositionOffset + aPos.xyz * u_PositionScale;
+    Normal = mat3(transpose(inverse(u_Model))) * decode_octahedral(aNormal);
+    TexCoords = aTexCoords;
+    gl_Position = u_Proj * u_View * u_Model * vec4(position, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+struct Material
+{
+    sampler2D texture_diffuse1;
+    sampler2D texture_specular1;
+    sampler2D texture_normal1;
+    sampler2D texture_height1;
+};
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 Normal;
+
+uniform Material u_Material;
+
+void main()
+{
+    // 简单的方向光，便于观察法线解码是否正确
+    float diffuse = max(dot(normalize(Normal), normalize(vec3(0.3, 1.0, 0.6))), 0.0);
+    FragColor = texture(u_Material.texture_diffuse1, TexCoords) * (0.3 + 0.7 * diffuse);
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <iomanip>
+#include "Header.h"
+
+Window window(960, 640, "test22_packed_vertex");
+
+/**
+ * 压缩顶点格式：左边为压缩格式，右边为原始 float 格式，
+ * 输出两者的顶点显存占用与 GPU 绘制耗时
+ */
+int main()
+{
+    const std::string model_path = "res/model/nanosuit.obj";
+
+    Model full_model(model_path);
+    Model packed_model(model_path, false, MODEL_LOAD_PACKED_VERTICES);
+
+    const auto full_size = full_model.get_vertex_buffer_size();
+    const auto packed_size = packed_model.get_vertex_buffer_size();
+
+    std::cout << "--- Packed Vertex Format ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Full   (" << sizeof(VertexData) << " bytes/vertex): " << full_size / 1024.0 << " KB" << std::endl;
+    std::cout << "Packed (" << sizeof(PackedVertexData) << " bytes/vertex): " << packed_size / 1024.0 << " KB" << std::endl;
+    std::cout << "Reduction: " << static_cast<double>(full_size) / packed_size << "x" << std::endl;
+    std::cout << "----------------------------" << std::endl;
+
+    Shader full_shader("src/test/test11/test11_obj.shader");
+    Shader packed_shader("src/test/test22/test22_packed.shader");
+
+    const auto proj_mat = glm::perspective(glm::radians(45.0f), 960.0f / 640.0f, 0.1f, 100.0f);
+    const auto view_mat = glm::lookAt(glm::vec3(0.0f, 8.0f, 24.0f), glm::vec3(0.0f, 8.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.5f));
+
+    // GPU 计时
+    unsigned int queries[2];
+    GLCall(glGenQueries(2, queries));
+    GLuint64 elapsed_total[2] = { 0, 0 };
+    auto frame_count = 0;
+    const auto report_frames = 300;
+
+    while (window.show())
+    {
+        const auto angle = static_cast<float>(glfwGetTime()) * 0.5f;
+
+        Model  *models[2]  = { &packed_model, &full_model };
+        Shader *shaders[2] = { &packed_shader, &full_shader };
+        const float offsets[2] = { -6.0f, 6.0f };
+
+        for (auto i = 0; i < 2; i++)
+        {
+            auto model_mat = glm::translate(glm::mat4(1.0f), glm::vec3(offsets[i], 0.0f, 0.0f));
+            model_mat = glm::rotate(model_mat, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            shaders[i]->set_mat4f("u_Proj", proj_mat);
+            shaders[i]->set_mat4f("u_View", view_mat);
+            shaders[i]->set_mat4f("u_Model", model_mat);
+
+            GLCall(glBeginQuery(GL_TIME_ELAPSED, queries[i]));
+            renderer.draw(*models[i], *shaders[i]);
+            GLCall(glEndQuery(GL_TIME_ELAPSED));
+        }
+
+        for (auto i = 0; i < 2; i++)
+        {
+            GLuint64 elapsed = 0;
+            GLCall(glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &elapsed));
+            elapsed_total[i] += elapsed;
+        }
+
+        if (++frame_count == report_frames)
+        {
+            std::cout << "GPU draw time, avg of " << report_frames << " frames: packed "
+                      << elapsed_total[0] / 1e6 / report_frames << " ms, full "
+                      << elapsed_total[1] / 1e6 / report_frames << " ms" << std::endl;
+            frame_count = 0;
+            elapsed_total[0] = elapsed_total[1] = 0;
+        }
+
+        window.end_of_frame();
+    }
+
+    GLCall(glDeleteQueries(2, queries));
+    return 0;
+}
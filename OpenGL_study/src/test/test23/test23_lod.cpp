@@ -0,0 +1,77 @@
+#include <iostream>
+#include <iomanip>
+#include "Header.h"
+
+Window window(960, 640, "test23_lod");
+
+/**
+ * LOD：一排排纳米装，相机前后往返，按屏幕误差为每个网格选择 LOD，
+ * 每秒输出提交的三角形数与全部使用原网格时的对比
+ */
+int main()
+{
+    const auto grid_size = 8;
+    const auto spacing = 12.0f;
+
+    LodSettings lod_settings;
+    lod_settings.triangle_ratios = { 0.5f, 0.25f, 0.1f, 0.04f };
+    lod_settings.max_error = 0.05f;
+
+    Model model("res/model/nanosuit.obj", false, MODEL_LOAD_OPTIMIZE | MODEL_LOAD_LOD, lod_settings);
+    model.set_lod_pixel_error(1.0f);
+
+    Shader shader("src/test/test11/test11_obj.shader");
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.5f));
+
+    auto frame_count = 0;
+    unsigned long long lod_triangles = 0, full_triangles = 0;
+    auto last_report = glfwGetTime();
+
+    while (window.show())
+    {
+        // 相机沿 z 轴往返
+        const auto time = static_cast<float>(glfwGetTime());
+        const auto camera_z = 20.0f + (glm::sin(time * 0.3f) * 0.5f + 0.5f) * 300.0f;
+        const Camera camera(glm::vec3(0.0f, 10.0f, camera_z));
+
+        const auto proj_mat = glm::perspective(glm::radians(camera.get_zoom()), 960.0f / 640.0f, 0.1f, 3000.0f);
+        shader.set_mat4f("u_Proj", proj_mat);
+        shader.set_mat4f("u_View", camera.get_view_matrix());
+
+        for (auto x = 0; x < grid_size; x++)
+        {
+            for (auto z = 0; z < grid_size; z++)
+            {
+                const auto position = glm::vec3((x - grid_size * 0.5f) * spacing, 0.0f, -z * spacing);
+                const auto model_mat = glm::translate(glm::mat4(1.0f), position);
+                shader.set_mat4f("u_Model", model_mat);
+
+                renderer.draw(model, shader, camera, model_mat);
+                lod_triangles += model.get_drawn_triangle_count();
+
+                // 原网格三角形数，用于对比
+                for (const auto& mesh : model.get_meshes())
+                    full_triangles += mesh.get_lods()[0].index_count / 3;
+            }
+        }
+
+        frame_count++;
+        if (glfwGetTime() - last_report >= 1.0)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                      << "camera z " << camera_z
+                      << ", triangles/frame " << lod_triangles / frame_count
+                      << " (full " << full_triangles / frame_count << ", "
+                      << 100.0 * lod_triangles / full_triangles << "%)" << std::endl;
+            frame_count = 0;
+            lod_triangles = full_triangles = 0;
+            last_report = glfwGetTime();
+        }
+
+        window.end_of_frame();
+    }
+
+    return 0;
+}
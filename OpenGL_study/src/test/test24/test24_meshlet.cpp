@@ -0,0 +1,68 @@
+#include <iostream>
+#include <iomanip>
+#include "Header.h"
+
+Window window(960, 640, "test24_meshlet");
+
+/**
+ * 簇剔除：相机贴近纳米装绕行，视锥外与背向相机的簇不提交，
+ * 每秒输出提交的三角形数、剔除的簇数与原网格的对比
+ */
+int main()
+{
+    Model model("res/model/nanosuit.obj", false, MODEL_LOAD_OPTIMIZE | MODEL_LOAD_MESHLETS);
+
+    unsigned int total_meshlets = 0;
+    for (const auto& mesh : model.get_meshes())
+        total_meshlets += static_cast<unsigned int>(mesh.get_meshlets().size());
+
+    Shader shader("src/test/test11/test11_obj.shader");
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.5f));
+
+    auto frame_count = 0;
+    unsigned long long drawn_triangles = 0, full_triangles = 0, culled_meshlets = 0;
+    auto last_report = glfwGetTime();
+
+    while (window.show())
+    {
+        // 相机绕模型旋转并上下移动，只看得到局部
+        const auto time = static_cast<float>(glfwGetTime());
+        const auto angle = time * 0.5f;
+        const auto position = glm::vec3(glm::sin(angle) * 6.0f, 8.0f + glm::sin(time * 0.7f) * 6.0f, glm::cos(angle) * 6.0f);
+        // 水平朝向模型中轴
+        const auto yaw = glm::degrees(glm::atan(-glm::cos(angle), -glm::sin(angle)));
+        const Camera camera(position, glm::vec3(0.0f, 1.0f, 0.0f), yaw, 0.0f);
+
+        const auto proj_mat = glm::perspective(glm::radians(camera.get_zoom()), 960.0f / 640.0f, 0.1f, 100.0f);
+        const auto model_mat = glm::mat4(1.0f);
+        shader.set_mat4f("u_Proj", proj_mat);
+        shader.set_mat4f("u_View", camera.get_view_matrix());
+        shader.set_mat4f("u_Model", model_mat);
+
+        renderer.draw(model, shader, camera, proj_mat, model_mat);
+        drawn_triangles += model.get_drawn_triangle_count();
+        culled_meshlets += model.get_culled_meshlet_count();
+        for (const auto& mesh : model.get_meshes())
+            full_triangles += mesh.get_lods()[0].index_count / 3;
+
+        frame_count++;
+        if (glfwGetTime() - last_report >= 1.0)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                      << "triangles/frame " << drawn_triangles / frame_count
+                      << " (full " << full_triangles / frame_count << ", "
+                      << 100.0 * drawn_triangles / full_triangles << "%)"
+                      << ", culled meshlets " << culled_meshlets / frame_count
+                      << "/" << total_meshlets << std::endl;
+            frame_count = 0;
+            drawn_triangles = full_triangles = culled_meshlets = 0;
+            last_report = glfwGetTime();
+        }
+
+        window.end_of_frame();
+    }
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec3 position;
+
+uniform mat4 u_MVP;
+
+out float o_Height;
+
+void main()
+{
+    gl_Position = u_MVP * vec4(position, 1.0);
+    o_Height = position.y;
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in float o_Height;
+
+void main()
+{
+    color = vec4(mix(vec3(0.2, 0.4, 0.2), vec3(0.9), o_Height * 0.5 + 0.5), 1.0);
+}
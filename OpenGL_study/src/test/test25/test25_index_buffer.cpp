@@ -0,0 +1,128 @@
+#include <iostream>
+#include <iomanip>
+#include "Header.h"
+#include "MeshOptimizer.h"
+
+Window window(960, 640, "test25_index_buffer");
+
+/**
+ * 索引宽度与图元重启：同一块地形网格，左边为三角形列表，右边为带图元重启的三角形带，
+ * 输出各自的索引类型、索引显存占用（与 32 位对比）与 GPU 绘制耗时
+ */
+int main()
+{
+    // 250 x 250 个顶点，索引可用 16 位存储
+    const unsigned int grid_size = 250;
+    const auto spacing = 0.1f;
+
+    std::vector<float> vertices;
+    for (unsigned int z = 0; z < grid_size; z++)
+    {
+        for (unsigned int x = 0; x < grid_size; x++)
+        {
+            const auto px = (x - grid_size * 0.5f) * spacing;
+            const auto pz = (z - grid_size * 0.5f) * spacing;
+            vertices.push_back(px);
+            vertices.push_back(glm::sin(px * 0.7f) * glm::cos(pz * 0.5f));
+            vertices.push_back(pz);
+        }
+    }
+
+    std::vector<unsigned int> list_indices;
+    for (unsigned int z = 0; z + 1 < grid_size; z++)
+    {
+        for (unsigned int x = 0; x + 1 < grid_size; x++)
+        {
+            const auto a = z * grid_size + x;
+            const auto b = a + grid_size;
+            list_indices.insert(list_indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+    optimize_vertex_cache(list_indices, grid_size * grid_size);
+    const auto strip_indices = stripify(list_indices, PRIMITIVE_RESTART_INDEX);
+
+    VertexBuffer vertex_buffer(vertices.data(), static_cast<unsigned int>(vertices.size() * sizeof(float)));
+    VertexBufferLayout layout;
+    layout.push<float>(3);
+
+    IndexBuffer list_ib(list_indices.data(), static_cast<unsigned int>(list_indices.size()));
+    IndexBuffer strip_ib(strip_indices.data(), static_cast<unsigned int>(strip_indices.size()), GL_STATIC_DRAW, GL_TRIANGLE_STRIP);
+
+    VertexArray list_va;
+    list_va.add_buffer(vertex_buffer, layout, list_ib);
+    VertexArray strip_va;
+    strip_va.add_buffer(vertex_buffer, layout, strip_ib);
+
+    // 模型的索引缓冲同样按顶点数自动选择宽度
+    Model model("res/model/nanosuit.obj");
+    unsigned int model_index_count = 0;
+    for (const auto& mesh : model.get_meshes())
+        model_index_count += mesh.get_lods()[0].index_count;
+
+    const auto type_name = [](const unsigned int type)
+    {
+        return type == GL_UNSIGNED_BYTE ? "8-bit" : type == GL_UNSIGNED_SHORT ? "16-bit" : "32-bit";
+    };
+
+    std::cout << "--- Index Buffer ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Grid list  (" << type_name(list_ib.get_type()) << ", " << list_ib.get_count() << " indices): "
+              << list_ib.get_size() / 1024.0 << " KB, 32-bit " << list_indices.size() * 4 / 1024.0 << " KB" << std::endl;
+    std::cout << "Grid strip (" << type_name(strip_ib.get_type()) << ", " << strip_ib.get_count() << " indices): "
+              << strip_ib.get_size() / 1024.0 << " KB" << std::endl;
+    std::cout << "Nanosuit: " << model.get_index_buffer_size() / 1024.0 << " KB, 32-bit "
+              << model_index_count * 4 / 1024.0 << " KB" << std::endl;
+    std::cout << "--------------------" << std::endl;
+
+    Shader shader("src/test/test25/test25_grid.shader");
+
+    const auto proj_mat = glm::perspective(glm::radians(45.0f), 960.0f / 640.0f, 0.1f, 100.0f);
+    const auto view_mat = glm::lookAt(glm::vec3(0.0f, 20.0f, 30.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.5f));
+
+    // GPU 计时
+    unsigned int queries[2];
+    GLCall(glGenQueries(2, queries));
+    GLuint64 elapsed_total[2] = { 0, 0 };
+    auto frame_count = 0;
+    const auto report_frames = 300;
+
+    while (window.show())
+    {
+        const VertexArray *vertex_arrays[2] = { &list_va, &strip_va };
+        const float offsets[2] = { -13.0f, 13.0f };
+
+        for (auto i = 0; i < 2; i++)
+        {
+            const auto model_mat = glm::translate(glm::mat4(1.0f), glm::vec3(offsets[i], 0.0f, 0.0f));
+            shader.set_mat4f("u_MVP", proj_mat * view_mat * model_mat);
+
+            GLCall(glBeginQuery(GL_TIME_ELAPSED, queries[i]));
+            renderer.draw(*vertex_arrays[i], shader);
+            GLCall(glEndQuery(GL_TIME_ELAPSED));
+        }
+
+        for (auto i = 0; i < 2; i++)
+        {
+            GLuint64 elapsed = 0;
+            GLCall(glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &elapsed));
+            elapsed_total[i] += elapsed;
+        }
+
+        if (++frame_count == report_frames)
+        {
+            std::cout << "GPU draw time, avg of " << report_frames << " frames: list "
+                      << elapsed_total[0] / 1e6 / report_frames << " ms, strip "
+                      << elapsed_total[1] / 1e6 / report_frames << " ms" << std::endl;
+            frame_count = 0;
+            elapsed_total[0] = elapsed_total[1] = 0;
+        }
+
+        window.end_of_frame();
+    }
+
+    GLCall(glDeleteQueries(2, queries));
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include "Header.h"
+
+Window window(960, 640, "test26_buffer_heap");
+
+namespace
+{
+    void print_heap(const char *label, const BufferHeap& heap)
+    {
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  " << label << ": " << heap.get_allocation_count() << " allocations in "
+                  << heap.get_page_count() << " buffers, used " << heap.get_used_size() / 1024.0 / 1024.0
+                  << " / " << heap.get_capacity() / 1024.0 / 1024.0 << " MB, largest free block "
+                  << heap.get_largest_free_block() / 1024.0 / 1024.0 << " MB" << std::endl;
+    }
+
+    void print_heaps(const char *title)
+    {
+        std::cout << title << std::endl;
+        print_heap("vertex", BufferHeap::get_vertex_heap());
+        print_heap("index ", BufferHeap::get_index_heap());
+    }
+}
+
+/**
+ * 缓冲堆：交替以两种顶点格式加载多份纳米装，全部网格共用少数几个大缓冲；
+ * 卸载一半后整理碎片，输出各阶段的缓冲数、占用与最大空闲块，再把剩下的模型画成一排
+ */
+int main()
+{
+    const auto model_count = 8;
+    const std::string model_path = "res/model/nanosuit.obj";
+
+    std::vector<std::unique_ptr<Model>> models;
+    unsigned int mesh_count = 0;
+    for (auto i = 0; i < model_count; i++)
+    {
+        const auto load_flags = i % 2 == 0 ? MODEL_LOAD_DEFAULT : MODEL_LOAD_PACKED_VERTICES;
+        models.emplace_back(new Model(model_path, false, load_flags));
+        mesh_count += static_cast<unsigned int>(models.back()->get_meshes().size());
+    }
+
+    std::cout << "--- Buffer Heap ---" << std::endl;
+    std::cout << mesh_count << " meshes, " << mesh_count * 2 << " buffer objects without the heap" << std::endl;
+    print_heaps("after loading:");
+
+    // 卸载一半，留下空洞
+    for (auto i = 0; i < model_count; i += 2)
+        models[i].reset();
+    print_heaps("after unloading every other model:");
+
+    const auto vertex_moved = BufferHeap::get_vertex_heap().defragment();
+    const auto index_moved = BufferHeap::get_index_heap().defragment();
+    std::cout << "defragment moved " << (vertex_moved + index_moved) / 1024.0 / 1024.0 << " MB" << std::endl;
+    print_heaps("after defragment:");
+    std::cout << "-------------------" << std::endl;
+
+    Shader full_shader("src/test/test11/test11_obj.shader");
+    Shader packed_shader("src/test/test22/test22_packed.shader");
+
+    const auto proj_mat = glm::perspective(glm::radians(45.0f), 960.0f / 640.0f, 0.1f, 100.0f);
+    const auto view_mat = glm::lookAt(glm::vec3(0.0f, 8.0f, 40.0f), glm::vec3(0.0f, 8.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.5f));
+
+    while (window.show())
+    {
+        const auto angle = static_cast<float>(glfwGetTime()) * 0.5f;
+
+        auto x = -model_count * 0.25f * 8.0f + 4.0f;
+        for (auto& model : models)
+        {
+            if (!model)
+                continue;
+
+            // 整理碎片后偏移已改变，绘制结果应与整理前一致
+            auto& shader = model->get_meshes()[0].get_vertex_format() == VERTEX_FORMAT_PACKED ? packed_shader : full_shader;
+            auto model_mat = glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, 0.0f));
+            model_mat = glm::rotate(model_mat, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+            x += 8.0f;
+
+            shader.set_mat4f("u_Proj", proj_mat);
+            shader.set_mat4f("u_View", view_mat);
+            shader.set_mat4f("u_Model", model_mat);
+            renderer.draw(*model, shader);
+        }
+
+        window.end_of_frame();
+    }
+
+    return 0;
+}
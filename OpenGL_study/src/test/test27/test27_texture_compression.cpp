@@ -0,0 +1,133 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include "Header.h"
+#include "TextureCompression.h"
+
+Window window(960, 640, "test27_texture_compression");
+
+namespace
+{
+    double elapsed_ms(const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+/**
+ * 压缩纹理：纳米装的全部贴图分别以原始 RGBA 与 BCn 上传，
+ * 输出显存占用与上传耗时（不含解码），再把同一张贴图左右对比显示
+ * 离线烘焙见 src/tools/texture_cooker.cpp
+ */
+int main()
+{
+    const char *names[] = {
+        "arm_dif", "arm_showroom_ddn", "arm_showroom_spec",
+        "body_dif", "body_showroom_ddn", "body_showroom_spec",
+        "hand_dif", "hand_showroom_ddn", "hand_showroom_spec",
+        "helmet_diff", "helmet_showroom_ddn", "helmet_showroom_spec",
+        "leg_dif", "leg_showroom_ddn", "leg_showroom_spec",
+        "glass_dif", "glass_ddn",
+    };
+
+    std::vector<TextureImage> images;
+    std::vector<CompressedImage> compressed_images;
+    auto compress_time = 0.0;
+    for (const auto *name : names)
+    {
+        const std::string path = std::string("res/model/") + name + ".png";
+        images.emplace_back(path);
+
+        const auto& image = images.back();
+        const auto format = choose_compressed_format(image.get_pixels(), image.get_width(), image.get_height(), image.get_bpp(),
+                                                     path.find("_ddn") != std::string::npos);
+        const auto start = std::chrono::high_resolution_clock::now();
+        compressed_images.push_back(compress_image(image.get_pixels(), image.get_width(), image.get_height(), image.get_bpp(), format));
+        compress_time += elapsed_ms(start);
+    }
+
+    // 上传计时包含 glFinish，保证驱动真正完成拷贝
+    std::vector<std::unique_ptr<Texture>> raw_textures;
+    size_t raw_memory = 0;
+    GLCall(glFinish());
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& image : images)
+    {
+        raw_textures.emplace_back(new Texture(image, true));
+        raw_memory += raw_textures.back()->get_memory_size();
+    }
+    GLCall(glFinish());
+    const auto raw_time = elapsed_ms(start);
+
+    std::vector<std::unique_ptr<Texture>> compressed_textures;
+    size_t compressed_memory = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (const auto& image : compressed_images)
+    {
+        compressed_textures.emplace_back(new Texture(image, true));
+        compressed_memory += compressed_textures.back()->get_memory_size();
+    }
+    GLCall(glFinish());
+    const auto compressed_time = elapsed_ms(start);
+
+    std::cout << "--- Texture Compression ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0, count = images.size(); i < count; i++)
+    {
+        std::cout << std::setw(22) << std::left << names[i] << std::right
+                  << images[i].get_width() << "x" << images[i].get_height() << " "
+                  << get_format_name(compressed_images[i].format) << (Texture::is_format_supported(compressed_images[i].format) ? "" : " (decompressed)")
+                  << std::endl;
+    }
+    std::cout << "Raw:        " << raw_memory / 1024.0 / 1024.0 << " MB, upload " << raw_time << " ms" << std::endl;
+    std::cout << "Compressed: " << compressed_memory / 1024.0 / 1024.0 << " MB, upload " << compressed_time << " ms"
+              << " (" << static_cast<double>(raw_memory) / compressed_memory << "x smaller, "
+              << raw_time / compressed_time << "x faster)" << std::endl;
+    std::cout << "Encode time (all levels): " << compress_time << " ms" << std::endl;
+    std::cout << "---------------------------" << std::endl;
+
+    const float positions[] = {
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+    };
+    const unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexArray va;
+    VertexBuffer vb(positions, sizeof(positions));
+    VertexBufferLayout layout;
+    layout.push<float>(2);
+    layout.push<float>(2);
+    IndexBuffer ib(indices, 6);
+    va.add_buffer(vb, layout, ib);
+
+    Shader shader("res/shaders/texture.shader");
+    shader.bind();
+    shader.set_int("m_Texture", 0);
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.2f));
+
+    const auto proj_mat = glm::ortho(-1.5f, 1.5f, -1.0f, 1.0f);
+    const size_t shown = 3;     // body_dif
+
+    while (window.show())
+    {
+        const Texture *textures[2] = { raw_textures[shown].get(), compressed_textures[shown].get() };
+        const float offsets[2] = { -0.72f, 0.72f };
+
+        for (auto i = 0; i < 2; i++)
+        {
+            const auto model_mat = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(offsets[i], 0.0f, 0.0f)), glm::vec3(0.7f));
+            shader.set_mat4f("u_MVP", proj_mat * model_mat);
+            textures[i]->bind(0);
+            renderer.draw(va, shader);
+        }
+
+        window.end_of_frame();
+    }
+
+    return 0;
+}
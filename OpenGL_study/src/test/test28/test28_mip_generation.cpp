@@ -0,0 +1,149 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include "Header.h"
+#include "MipGenerator.h"
+#include "ThreadPool.h"
+
+Window window(960, 640, "test28_mip_generation");
+
+namespace
+{
+    double elapsed_seconds(const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+/**
+ * CPU mip 生成：对纳米装的漫反射贴图分别用各滤波器生成完整 mip 链，
+ * 输出单线程与线程池下的吞吐（按原图像素计 MPixels/s），并与 glGenerateMipmap 对比；
+ * 画面从左到右为 box / kaiser / sRGB box 生成的纹理缩小显示
+ */
+int main()
+{
+    const std::string path = "res/model/body_dif.png";
+
+    MipSettings no_mips;
+    no_mips.enabled = false;
+    const TextureImage image(path, no_mips);
+    if (!image.is_valid())
+        return -1;
+
+    const auto pixel_count = static_cast<double>(image.get_width()) * image.get_height();
+    const auto iterations = 10;
+
+    struct
+    {
+        const char *name;
+        MipFilter   filter;
+        bool        srgb;
+    } const variants[] = {
+        { "box",         MIP_FILTER_BOX,    false },
+        { "kaiser",      MIP_FILTER_KAISER, false },
+        { "box srgb",    MIP_FILTER_BOX,    true  },
+        { "kaiser srgb", MIP_FILTER_KAISER, true  },
+    };
+
+    std::cout << "--- Mip Generation (" << image.get_width() << "x" << image.get_height() << "x" << image.get_bpp()
+              << ", " << iterations << " runs) ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& variant : variants)
+    {
+        MipSettings settings;
+        settings.filter = variant.filter;
+        settings.srgb = variant.srgb;
+
+        double throughput[2];
+        for (auto threaded = 0; threaded < 2; threaded++)
+        {
+            auto *thread_pool = threaded ? &ThreadPool::get_instance() : nullptr;
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (auto i = 0; i < iterations; i++)
+                generate_mip_chain(image.get_pixels(), image.get_width(), image.get_height(), image.get_bpp(), settings, thread_pool);
+            throughput[threaded] = pixel_count * iterations / elapsed_seconds(start) / 1e6;
+        }
+
+        std::cout << std::setw(12) << std::left << variant.name << std::right
+                  << std::setw(8) << throughput[0] << " MPixels/s (1 thread), "
+                  << std::setw(8) << throughput[1] << " MPixels/s (" << ThreadPool::get_instance().get_thread_count() << " threads)"
+                  << std::endl;
+    }
+
+    // 驱动生成，计时包含上传，用 glFinish 等待完成
+    {
+        const auto format = image.get_bpp() == 4 ? GL_RGBA : GL_RGB;
+        unsigned int texture = 0;
+        GLCall(glGenTextures(1, &texture));
+        GLState::bind_texture(GL_TEXTURE_2D, texture);
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        GLCall(glTexImage2D(GL_TEXTURE_2D, 0, format, image.get_width(), image.get_height(), 0, format, GL_UNSIGNED_BYTE, image.get_pixels()));
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+        GLCall(glFinish());
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < iterations; i++)
+            GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+        GLCall(glFinish());
+        std::cout << std::setw(12) << std::left << "driver" << std::right
+                  << std::setw(8) << pixel_count * iterations / elapsed_seconds(start) / 1e6
+                  << " MPixels/s (glGenerateMipmap, blocks the context thread)" << std::endl;
+
+        GLState::bind_texture(GL_TEXTURE_2D, 0);
+        GLCall(glDeleteTextures(1, &texture));
+        GLState::forget_texture(texture);
+    }
+    std::cout << "------------------------------------------" << std::endl;
+
+    std::vector<std::unique_ptr<Texture>> textures;
+    for (auto i = 0; i < 3; i++)
+    {
+        MipSettings settings;
+        settings.filter = variants[i].filter;
+        settings.srgb = variants[i].srgb;
+        textures.emplace_back(new Texture(TextureImage(path, settings), true));
+    }
+
+    const float positions[] = {
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+    };
+    const unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexArray va;
+    VertexBuffer vb(positions, sizeof(positions));
+    VertexBufferLayout layout;
+    layout.push<float>(2);
+    layout.push<float>(2);
+    IndexBuffer ib(indices, 6);
+    va.add_buffer(vb, layout, ib);
+
+    Shader shader("res/shaders/texture.shader");
+    shader.bind();
+    shader.set_int("m_Texture", 0);
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.2f));
+
+    // 每个四边形约 100 像素宽，采样落在较低的 mip 级别
+    const auto proj_mat = glm::ortho(-1.5f, 1.5f, -1.0f, 1.0f);
+    const float offsets[3] = { -0.6f, 0.0f, 0.6f };
+
+    while (window.show())
+    {
+        for (auto i = 0; i < 3; i++)
+        {
+            const auto model_mat = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(offsets[i], 0.0f, 0.0f)), glm::vec3(0.25f));
+            shader.set_mat4f("u_MVP", proj_mat * model_mat);
+            textures[i]->bind(0);
+            renderer.draw(va, shader);
+        }
+
+        window.end_of_frame();
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include "Header.h"
+
+Window window(640, 480, "test29_parallel_shader_compile");
+
+namespace
+{
+    double elapsed_ms(const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // 场景用到的全部变体，光照着色器按光源类型与数量展开
+    std::vector<ShaderVariant> make_scene_variants(const std::string& salt)
+    {
+        const char *paths[] = {
+            "src/test/test10/test10_light.shader",
+            "src/test/test11/test11_obj.shader",
+            "src/test/test13/test13_obj.shader",
+            "src/test/test13/test13_boarder.shader",
+            "src/test/test16/test16_cube.shader",
+            "src/test/test16/test16_skybox.shader",
+            "src/test/test18/test18_cube_normal.shader",
+            "src/test/test20/test20_light.shader",
+            "src/test/test22/test22_packed.shader",
+            "res/shaders/texture.shader",
+        };
+
+        // 盐值改变源码文本，避开驱动自带的着色器磁盘缓存
+        const auto salt_define = "COMPILE_SALT " + salt;
+        std::vector<ShaderVariant> variants;
+        for (const auto path : paths)
+            variants.push_back({ path, { salt_define } });
+        for (const auto light_type : { "LIGHT_DIRECTIONAL", "LIGHT_POINT", "LIGHT_SPOT" })
+            variants.push_back({ "src/test/test20/test20_obj.shader", { salt_define, std::string("LIGHT_TYPE ") + light_type } });
+        for (const auto light_count : { 1, 2, 4, 8 })
+            variants.push_back({ "src/test/test10/test10_obj.shader", { salt_define, "NR_POINT_LIGHTS " + std::to_string(light_count) } });
+        return variants;
+    }
+}
+
+/**
+ * 着色器并行编译：同一批变体逐个同步编译 vs 一次提交后轮询完成状态，
+ * 程序二进制缓存关闭，两次使用不同盐值保证都是冷编译
+ */
+int main()
+{
+    ProgramCache::set_enabled(false);
+
+    const auto run_id = std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+
+    // 1. 逐个编译，每个程序创建后立即检查状态
+    const auto serial_variants = make_scene_variants(run_id + "1");
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<std::unique_ptr<Shader>> shaders;
+        for (const auto& variant : serial_variants)
+            shaders.emplace_back(new Shader(variant.filepath, variant.defines));
+        GLCall(glFinish());
+    }
+    const auto serial_ms = elapsed_ms(start);
+
+    // 2. 批量提交，轮询直到全部完成
+    const auto batch_variants = make_scene_variants(run_id + "2");
+    start = std::chrono::high_resolution_clock::now();
+    auto shaders = ShaderLibrary::get_batch(batch_variants);
+    const auto submit_ms = elapsed_ms(start);
+
+    auto poll_count = 0;
+    while (ShaderLibrary::poll() > 0)
+        poll_count++;
+    GLCall(glFinish());
+    const auto batch_ms = elapsed_ms(start);
+
+    auto ready_count = 0;
+    for (const auto& shader : shaders)
+        ready_count += shader->is_ready() ? 1 : 0;
+
+    std::cout << "--- Parallel Shader Compile ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Programs: " << batch_variants.size() << " (" << ready_count << " ready)" << std::endl;
+    std::cout << "Parallel compile extension: " << (Shader::is_parallel_compile_supported() ? "yes" : "no") << std::endl;
+    std::cout << "Serial: " << serial_ms << " ms" << std::endl;
+    std::cout << "Batch: " << batch_ms << " ms (submit " << submit_ms << " ms, " << poll_count << " polls)" << std::endl;
+    std::cout << "Speedup: " << serial_ms / batch_ms << "x" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    return 0;
+}
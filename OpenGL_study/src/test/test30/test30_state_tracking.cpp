@@ -0,0 +1,113 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include "Header.h"
+
+Window window(640, 480, "test30_state_tracking");
+
+namespace
+{
+    const unsigned int DRAW_COUNT = 1000;
+
+    double elapsed_ms(const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+/**
+ * 状态跟踪：同一帧 1000 次绘制分别关闭和开启 GLState，对比发给驱动的状态调用数，
+ * 绘制按 8 个一组切换纹理、16 个一组切换管线状态，与常见场景的冗余程度接近
+ */
+int main()
+{
+    VertexBuffer vertex_buffer(cube_vertexs_nt, cube_v_nt_b_size);
+    VertexBufferLayout vertex_buffer_layout;
+    vertex_buffer_layout.push<float>(3);
+    vertex_buffer_layout.push<float>(3);
+    vertex_buffer_layout.push<float>(2);
+    IndexBuffer index_buffer(cube_index, cube_ib_count);
+
+    VertexArray cube_va;
+    cube_va.add_buffer(vertex_buffer, vertex_buffer_layout, index_buffer);
+
+    Shader obj_shader("src/test/test13/test13_obj.shader");
+    Shader boarder_shader("src/test/test13/test13_boarder.shader");
+    std::shared_ptr<Texture> textures[] = {
+        TextureCache::get("res/textures/container.png"),
+        TextureCache::get("res/textures/container_specular.png"),
+    };
+
+    PipelineStateDesc opaque_desc;
+    opaque_desc.shader = &obj_shader;
+    opaque_desc.blend.enabled = false;
+    opaque_desc.raster.cull_enabled = true;
+    const PipelineState opaque_state(opaque_desc);
+
+    PipelineStateDesc overlay_desc;
+    overlay_desc.shader = &boarder_shader;
+    overlay_desc.depth.test_enabled = false;
+    overlay_desc.depth.write_enabled = false;
+    const PipelineState overlay_state(overlay_desc);
+
+    const auto proj = glm::perspective(glm::radians(45.0f), 640.0f / 480.0f, 0.1f, 100.0f);
+    const auto view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -40.0f));
+    for (auto shader : { &obj_shader, &boarder_shader })
+    {
+        shader->set_mat4f("u_Proj", proj);
+        shader->set_mat4f("u_View", view);
+    }
+    obj_shader.set_int("u_Texture", 0);
+
+    Renderer renderer;
+    const auto run_frame = [&]
+    {
+        GLState::reset_stats();
+        renderer.clear();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned int i = 0; i < DRAW_COUNT; i++)
+        {
+            const auto overlay = (i / 16) % 2 == 1;
+            const auto& state = overlay ? overlay_state : opaque_state;
+            auto& shader = overlay ? boarder_shader : obj_shader;
+
+            state.bind();
+            textures[(i / 8) % 2]->bind();
+
+            const auto model = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i % 40) - 20.0f,
+                                                                         static_cast<float>(i / 40) - 12.0f, 0.0f));
+            shader.set_mat4f("u_Model", glm::scale(model, glm::vec3(0.4f)));
+            renderer.draw(cube_va, shader);
+        }
+        GLCall(glFinish());
+
+        return elapsed_ms(start);
+    };
+
+    // 先跑一帧预热驱动
+    run_frame();
+
+    GLState::set_tracking(false);
+    const auto untracked_ms = run_frame();
+    const auto untracked = GLState::get_stats();
+
+    GLState::set_tracking(true);
+    GLState::invalidate();
+    const auto tracked_ms = run_frame();
+    const auto tracked = GLState::get_stats();
+
+    std::cout << "--- GL State Tracking ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Draws: " << DRAW_COUNT << std::endl;
+    std::cout << "Untracked: " << untracked.issued << " state calls, " << untracked_ms << " ms" << std::endl;
+    std::cout << "Tracked: " << tracked.issued << " of " << tracked.requested << " state calls issued, "
+              << tracked_ms << " ms" << std::endl;
+    std::cout << "Elided: " << tracked.requested - tracked.issued << " ("
+              << 100.0 * (tracked.requested - tracked.issued) / tracked.requested << "%)" << std::endl;
+    std::cout << "-------------------------" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include "Header.h"
+
+Window window(960, 640, "test31_multi_draw");
+
+namespace
+{
+    const int GRID_SIZE = 8;
+    const unsigned int FRAMES_PER_MODE = 300;
+
+    /**
+     * 同一场景的四种提交方式
+     */
+    enum SubmitMode
+    {
+        SUBMIT_PER_MESH,        // 逐模型逐网格绘制
+        SUBMIT_RENDER_QUEUE,    // RenderQueue 排序后提交，合并相同状态
+        SUBMIT_INSTANCED,       // Model::draw_instanced，每个网格一次实例化绘制
+        SUBMIT_BATCHED,         // DrawBatch 多重绘制
+        SUBMIT_MODE_COUNT,
+    };
+
+    const char *SUBMIT_MODE_NAMES[] = { "per mesh:    ", "render queue:", "instanced:   ", "batched:     " };
+
+    double elapsed_ms(const std::chrono::high_resolution_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+/**
+ * 多重绘制合批：8x8 个纳米装，每 300 帧在逐网格绘制、RenderQueue、实例化与 DrawBatch 之间轮换，
+ * 输出各方式的绘制调用数与提交耗时（CPU）
+ */
+int main()
+{
+    Model model("res/model/nanosuit.obj", false, MODEL_LOAD_OPTIMIZE);
+
+    Shader shader("src/test/test11/test11_obj.shader");
+    // 实例化与合批共用实例流版本
+    Shader batch_shader("src/test/test11/test11_obj.shader", { "INSTANCED" });
+
+    const auto proj_mat = glm::perspective(glm::radians(45.0f), 960.0f / 640.0f, 0.1f, 300.0f);
+    const auto view_mat = glm::lookAt(glm::vec3(0.0f, 40.0f, 90.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    for (auto current : { &shader, &batch_shader })
+    {
+        current->set_mat4f("u_Proj", proj_mat);
+        current->set_mat4f("u_View", view_mat);
+    }
+
+    std::cout << "--- Multi Draw ---" << std::endl;
+    std::cout << "Models: " << GRID_SIZE * GRID_SIZE << " x " << model.get_meshes().size() << " meshes" << std::endl;
+    std::cout << "Path: " << (DrawBatch::is_indirect_supported() ? "glMultiDrawElementsIndirect" : "glMultiDrawElementsBaseVertex") << std::endl;
+
+    Renderer renderer;
+    renderer.set_clear_color(glm::vec4(0.5f));
+    // 逐绘制数据与间接命令每帧写入环形缓冲
+    StreamBuffer frame_stream(256 * 1024);
+    DrawBatch batch(&frame_stream);
+    RenderQueue render_queue;
+    render_queue.set_view(view_mat, 0.1f, 300.0f);
+    InstanceBuffer instance_buffer(GRID_SIZE * GRID_SIZE);
+    std::vector<InstanceData> instances;
+
+    unsigned int frame = 0;
+    double submit_ms = 0.0;
+    unsigned int api_calls = 0;
+    unsigned int dropped_count = 0;
+
+    while (window.show())
+    {
+        const auto mode = static_cast<SubmitMode>(frame / FRAMES_PER_MODE % SUBMIT_MODE_COUNT);
+        const auto angle = static_cast<float>(glfwGetTime()) * 0.5f;
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (auto z = 0; z < GRID_SIZE; z++)
+        {
+            for (auto x = 0; x < GRID_SIZE; x++)
+            {
+                auto model_mat = glm::translate(glm::mat4(1.0f), glm::vec3((x - GRID_SIZE / 2) * 10.0f, 0.0f, (z - GRID_SIZE / 2) * 10.0f));
+                model_mat = glm::rotate(model_mat, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+
+                switch (mode)
+                {
+                case SUBMIT_PER_MESH:
+                    shader.set_mat4f("u_Model", model_mat);
+                    renderer.draw(model, shader);
+                    break;
+                case SUBMIT_RENDER_QUEUE:
+                    model.submit(render_queue, shader, model_mat);
+                    break;
+                case SUBMIT_INSTANCED:
+                    instances.push_back({ model_mat, glm::vec4(1.0f) });
+                    break;
+                default:
+                    model.submit(batch, model_mat);
+                    break;
+                }
+            }
+        }
+
+        const auto mesh_count = static_cast<unsigned int>(model.get_meshes().size());
+        switch (mode)
+        {
+        case SUBMIT_PER_MESH:
+            api_calls = GRID_SIZE * GRID_SIZE * mesh_count;
+            break;
+        case SUBMIT_RENDER_QUEUE:
+            render_queue.flush(renderer);
+            api_calls = render_queue.get_stats().draw_count;
+            break;
+        case SUBMIT_INSTANCED:
+            instance_buffer.set_data(instances);
+            model.draw_instanced(renderer, batch_shader, instance_buffer, instance_buffer.get_count());
+            instances.clear();
+            api_calls = mesh_count;
+            break;
+        default:
+            batch.flush(renderer, batch_shader);
+            api_calls = batch.get_stats().api_calls;
+            dropped_count += batch.get_stats().dropped_count;
+            break;
+        }
+        submit_ms += elapsed_ms(start);
+
+        if (++frame % FRAMES_PER_MODE == 0)
+        {
+            std::cout << std::fixed << std::setprecision(3)
+                      << SUBMIT_MODE_NAMES[mode] << " " << api_calls << " draw calls, "
+                      << submit_ms / FRAMES_PER_MODE << " ms submit per frame" << std::endl;
+            // 流缓冲本帧空间不足时整批丢弃
+            if (dropped_count > 0)
+                std::cout << "  dropped " << dropped_count << " mesh draws, stream buffer too small" << std::endl;
+            submit_ms = 0.0;
+            dropped_count = 0;
+        }
+
+        frame_stream.end_frame();
+        window.end_of_frame();
+    }
+
+    return 0;
+}
@@ -139,8 +139,8 @@ int main()
     auto light_model = glm::translate(glm::mat4(1.0f), light_pos);
     light_model = glm::scale(light_model, glm::vec3(0.2f));
 
-    Texture texture0("res/textures/container.png");
-    Texture texture1("res/textures/container_specular.png");
+    auto texture0 = TextureCache::get("res/textures/container.png");
+    auto texture1 = TextureCache::get("res/textures/container_specular.png");
 
     Shader obj_shader("src/test/test8/test8_obj.shader");
     // set mvp
@@ -176,8 +176,8 @@ int main()
 
         process_input(window.get_window());
 
-        texture0.bind();
-        texture1.bind(1);
+        texture0->bind();
+        texture1->bind(1);
 
         proj = glm::perspective(glm::radians(camera.get_zoom()), 1.0f, 0.1f, 3000.0f);
         view = camera.get_view_matrix();
@@ -0,0 +1,184 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+#endif
+
+namespace
+{
+    void print_usage()
+    {
+        std::cout << "usage: asset_packer [--lz4] [-o res.pack] [directory...]" << std::endl
+                  << "       asset_packer --list [res.pack]" << std::endl
+                  << "  packs every file under the directories (default: res) with paths relative to the working directory," << std::endl
+                  << "  run it from the same directory the demos are started from" << std::endl;
+    }
+
+    bool has_suffix(const std::string& value, const std::string& suffix)
+    {
+        return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // 网格缓存由运行时生成并校验，不打包
+    bool should_pack(const std::string& path)
+    {
+        return !has_suffix(path, ".meshcache") && !has_suffix(path, ".pack");
+    }
+
+    void list_files(const std::string& directory, std::vector<std::string>& files)
+    {
+#ifdef _WIN32
+        WIN32_FIND_DATAA data;
+        const auto handle = FindFirstFileA((directory + "/*").c_str(), &data);
+        if (handle == INVALID_HANDLE_VALUE)
+            return;
+
+        do
+        {
+            const std::string name = data.cFileName;
+            if (name == "." || name == "..")
+                continue;
+
+            const auto path = directory + "/" + name;
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                list_files(path, files);
+            else if (should_pack(path))
+                files.push_back(path);
+        } while (FindNextFileA(handle, &data));
+        FindClose(handle);
+#else
+        const auto dir = opendir(directory.c_str());
+        if (dir == nullptr)
+            return;
+
+        while (const auto entry = readdir(dir))
+        {
+            const std::string name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+
+            const auto path = directory + "/" + name;
+            struct stat info {};
+            if (stat(path.c_str(), &info) != 0)
+                continue;
+
+            if (S_ISDIR(info.st_mode))
+                list_files(path, files);
+            else if (S_ISREG(info.st_mode) && should_pack(path))
+                files.push_back(path);
+        }
+        closedir(dir);
+#endif
+    }
+
+    int list_pack(const std::string& pack_path)
+    {
+        AssetPack pack;
+        if (!pack.open(pack_path))
+        {
+            std::cout << "[ERROR] failed to open " << pack_path << std::endl;
+            return 1;
+        }
+
+        for (size_t i = 0, count = pack.get_entry_count(); i < count; i++)
+        {
+            const auto path = pack.get_entry_path(i);
+            std::cout << std::setw(12) << pack.find(path).size << "  " << path << std::endl;
+        }
+        std::cout << pack.get_entry_count() << " entries" << std::endl;
+        return 0;
+    }
+}
+
+/**
+ * 资源打包工具：把 res/ 下的全部文件写入一个页对齐的资源包，可选 LZ4 压缩
+ * 运行时默认挂载工作目录下的 res.pack
+ */
+int main(int argc, char *argv[])
+{
+    std::string output = ASSET_PACK_DEFAULT_PATH;
+    auto compress = false;
+    std::vector<std::string> directories;
+
+    for (auto i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--lz4")
+        {
+            compress = true;
+        }
+        else if (argument == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (argument == "--list")
+        {
+            return list_pack(i + 1 < argc ? argv[i + 1] : ASSET_PACK_DEFAULT_PATH);
+        }
+        else if (argument == "--help" || argument == "-h")
+        {
+            print_usage();
+            return 0;
+        }
+        else
+        {
+            directories.push_back(argument);
+        }
+    }
+
+    if (directories.empty())
+        directories.push_back("res");
+
+    std::vector<std::string> files;
+    for (const auto& directory : directories)
+        list_files(AssetPack::normalize_path(directory), files);
+
+    if (files.empty())
+    {
+        std::cout << "[ERROR] no files found" << std::endl;
+        print_usage();
+        return 1;
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    if (!AssetPack::build(output, files, compress))
+        return 1;
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // 重新打开以统计大小并校验
+    AssetPack pack;
+    if (!pack.open(output))
+    {
+        std::cout << "[ERROR] failed to verify " << output << std::endl;
+        return 1;
+    }
+
+    size_t total_size = 0;
+    for (size_t i = 0, count = pack.get_entry_count(); i < count; i++)
+    {
+        const auto view = pack.find(pack.get_entry_path(i));
+        if (!view.is_valid())
+        {
+            std::cout << "[ERROR] failed to read back " << pack.get_entry_path(i) << std::endl;
+            return 1;
+        }
+        total_size += view.size;
+    }
+
+    std::ifstream pack_file(output, std::ios::binary | std::ios::ate);
+    std::cout << std::fixed << std::setprecision(2)
+              << output << ": " << pack.get_entry_count() << " files, "
+              << total_size / 1024.0 / 1024.0 << " MB -> " << static_cast<double>(pack_file.tellg()) / 1024.0 / 1024.0 << " MB"
+              << (compress ? " (lz4)" : "") << ", " << elapsed << " ms" << std::endl;
+    return 0;
+}
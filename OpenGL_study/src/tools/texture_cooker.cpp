@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+#include "TextureContainer.h"
+
+namespace
+{
+    void print_usage()
+    {
+        std::cout << "usage: texture_cooker [--format auto|bc1|bc3|bc4|bc5] [--ktx] [--no-mips]" << std::endl
+                  << "                      [--mip-filter box|kaiser] [--srgb] <image>..." << std::endl
+                  << "  cooks each PNG/JPG into <stem>.dds (or <stem>.ktx) next to the source image," << std::endl
+                  << "  Model picks the cooked file up automatically" << std::endl;
+    }
+
+    bool parse_format(const std::string& name, CompressedFormat& format, bool& is_auto)
+    {
+        is_auto = name == "auto";
+        if (is_auto)                                 format = COMPRESSED_FORMAT_NONE;
+        else if (name == "bc1")                      format = COMPRESSED_FORMAT_BC1;
+        else if (name == "bc3")                      format = COMPRESSED_FORMAT_BC3;
+        else if (name == "bc4")                      format = COMPRESSED_FORMAT_BC4;
+        else if (name == "bc5")                      format = COMPRESSED_FORMAT_BC5;
+        else                                         return false;
+        return true;
+    }
+
+    // 法线贴图按文件名约定识别（nanosuit 使用 _ddn 后缀）
+    bool is_normal_map(const std::string& path)
+    {
+        return path.find("_ddn") != std::string::npos || path.find("_normal") != std::string::npos;
+    }
+
+    // 只比较格式保留的通道
+    double compute_psnr(const TextureImage& image, const std::vector<unsigned char>& rgba, const CompressedFormat format)
+    {
+        const auto channels = image.get_bpp();
+        const auto compared = format == COMPRESSED_FORMAT_BC4 ? 1 : format == COMPRESSED_FORMAT_BC5 ? 2 : std::min(channels, format == COMPRESSED_FORMAT_BC1 ? 3 : 4);
+        const auto count = static_cast<size_t>(image.get_width()) * image.get_height();
+
+        double squared_error = 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            for (auto k = 0; k < compared; k++)
+            {
+                // 灰度图的各通道都来自第 0 个分量
+                const auto source = image.get_pixels()[i * channels + (channels <= 2 ? (k == 3 ? 1 : 0) : k)];
+                const auto difference = static_cast<double>(source) - rgba[i * 4 + k];
+                squared_error += difference * difference;
+            }
+        }
+
+        const auto mse = squared_error / (static_cast<double>(count) * compared);
+        return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : INFINITY;
+    }
+}
+
+/**
+ * 离线纹理烘焙：把 PNG/JPG 压缩为 BCn 并连同完整 mip 链写入 DDS/KTX，
+ * mip 链在 CPU 上生成，可选 Kaiser 滤波与 sRGB 线性空间降采样
+ * 图片经 TextureImage 解码时已翻转，运行时加载烘焙结果无需再翻转
+ */
+int main(int argc, char *argv[])
+{
+    auto format = COMPRESSED_FORMAT_NONE;
+    auto is_auto = true;
+    auto use_ktx = false;
+    MipSettings mip_settings;
+    std::vector<std::string> inputs;
+
+    for (auto i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--format" && i + 1 < argc)
+        {
+            if (!parse_format(argv[++i], format, is_auto))
+            {
+                std::cout << "[ERROR] unknown format " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--ktx")
+        {
+            use_ktx = true;
+        }
+        else if (argument == "--no-mips")
+        {
+            mip_settings.enabled = false;
+        }
+        else if (argument == "--mip-filter" && i + 1 < argc)
+        {
+            const std::string filter = argv[++i];
+            if (filter != "box" && filter != "kaiser")
+            {
+                std::cout << "[ERROR] unknown mip filter " << filter << std::endl;
+                return 1;
+            }
+            mip_settings.filter = filter == "kaiser" ? MIP_FILTER_KAISER : MIP_FILTER_BOX;
+        }
+        else if (argument == "--srgb")
+        {
+            mip_settings.srgb = true;
+        }
+        else if (argument == "--help" || argument == "-h")
+        {
+            print_usage();
+            return 0;
+        }
+        else
+        {
+            inputs.push_back(argument);
+        }
+    }
+
+    if (inputs.empty())
+    {
+        print_usage();
+        return 1;
+    }
+
+    if (format == COMPRESSED_FORMAT_BC7 || format == COMPRESSED_FORMAT_ETC2_RGB)
+    {
+        std::cout << "[ERROR] " << get_format_name(format) << " encoding is not supported yet, "
+                  << "files in this format produced by other tools can still be loaded" << std::endl;
+        return 1;
+    }
+
+    // mip 链由 compress_image 按 mip_settings 生成，解码时不必生成
+    MipSettings decode_settings;
+    decode_settings.enabled = false;
+
+    auto failures = 0;
+    for (const auto& input : inputs)
+    {
+        const TextureImage image(input, decode_settings);
+        if (!image.is_valid() || image.is_compressed())
+        {
+            std::cout << "[ERROR] failed to load " << input << std::endl;
+            failures++;
+            continue;
+        }
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        const auto target_format = is_auto
+            ? choose_compressed_format(image.get_pixels(), image.get_width(), image.get_height(), image.get_bpp(), is_normal_map(input))
+            : format;
+        const auto compressed = compress_image(image.get_pixels(), image.get_width(), image.get_height(), image.get_bpp(),
+                                               target_format, mip_settings);
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        const auto dot = input.find_last_of('.');
+        const auto output = (dot == std::string::npos ? input : input.substr(0, dot)) + (use_ktx ? ".ktx" : ".dds");
+        if (!compressed.is_valid() || !(use_ktx ? save_ktx(output, compressed) : save_dds(output, compressed)))
+        {
+            std::cout << "[ERROR] failed to cook " << input << std::endl;
+            failures++;
+            continue;
+        }
+
+        std::vector<unsigned char> rgba;
+        decompress_level(compressed, 0, rgba);
+
+        const auto raw_size = static_cast<double>(image.get_width()) * image.get_height() * image.get_bpp() * (mip_settings.enabled ? 4.0 / 3.0 : 1.0);
+        std::cout << std::fixed << std::setprecision(2)
+                  << input << " -> " << output << " (" << get_mip_filter_name(mip_settings.filter)
+                  << (mip_settings.srgb ? ", srgb" : "") << " mips)" << std::endl
+                  << "  " << image.get_width() << "x" << image.get_height() << " " << get_format_name(target_format)
+                  << ", " << compressed.levels.size() << " levels, "
+                  << raw_size / 1024.0 << " KB -> " << compressed.data.size() / 1024.0 << " KB ("
+                  << raw_size / static_cast<double>(compressed.data.size()) << "x), "
+                  << elapsed << " ms, PSNR " << compute_psnr(image, rgba, target_format) << " dB" << std::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}